@@ -201,6 +201,22 @@ static int eth_send(const struct device *dev, struct net_pkt *pkt)
 	return ret < 0 ? ret : 0;
 }
 
+#if defined(CONFIG_NET_BATCH)
+static int eth_send_batch(const struct device *dev, struct net_pkt **pkts,
+			  size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		int ret = eth_send(dev, pkts[i]);
+
+		if (ret < 0) {
+			return i > 0 ? (int)i : ret;
+		}
+	}
+
+	return count;
+}
+#endif
+
 static int eth_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -319,14 +335,16 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+static int read_pkt(struct eth_context *ctx, int fd, struct net_pkt **pkt_out,
+		    struct net_if **iface_out)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
-	struct net_if *iface;
 	struct net_pkt *pkt = NULL;
 	int status;
 	int count;
 
+	*pkt_out = NULL;
+
 	count = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
 	if (count <= 0) {
 		return 0;
@@ -359,9 +377,70 @@ static int read_data(struct eth_context *ctx, int fd)
 	}
 #endif
 
-	iface = get_iface(ctx, vlan_tag);
+	*iface_out = get_iface(ctx, vlan_tag);
+
+	update_gptp(*iface_out, pkt, false);
+
+	*pkt_out = pkt;
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_BATCH)
+static void recv_batch(struct net_if *iface, struct net_pkt **pkts, size_t count)
+{
+	if (net_recv_data_batch(iface, pkts, count) < 0) {
+		for (size_t i = 0; i < count; i++) {
+			net_pkt_unref(pkts[i]);
+		}
+	}
+
+	/* Let the RX queues run once per batch */
+	k_yield();
+}
+
+/* Reads everything that is pending on the device and passes it up in
+ * batches of packets for the same interface.
+ */
+static void read_data_batch(struct eth_context *ctx, int fd)
+{
+	struct net_pkt *pkts[CONFIG_NET_BATCH_SIZE];
+	struct net_if *batch_iface = NULL;
+	size_t count = 0;
+
+	while (!eth_wait_data(fd)) {
+		struct net_if *iface = NULL;
+		struct net_pkt *pkt;
+
+		if (read_pkt(ctx, fd, &pkt, &iface) < 0 || !pkt) {
+			continue;
+		}
+
+		if (count > 0 &&
+		    (iface != batch_iface || count == ARRAY_SIZE(pkts))) {
+			recv_batch(batch_iface, pkts, count);
+			count = 0;
+		}
 
-	update_gptp(iface, pkt, false);
+		batch_iface = iface;
+		pkts[count++] = pkt;
+	}
+
+	if (count > 0) {
+		recv_batch(batch_iface, pkts, count);
+	}
+}
+#else
+static int read_data(struct eth_context *ctx, int fd)
+{
+	struct net_if *iface = NULL;
+	struct net_pkt *pkt;
+	int ret;
+
+	ret = read_pkt(ctx, fd, &pkt, &iface);
+	if (ret < 0 || !pkt) {
+		return ret;
+	}
 
 	if (net_recv_data(iface, pkt) < 0) {
 		net_pkt_unref(pkt);
@@ -369,6 +448,7 @@ static int read_data(struct eth_context *ctx, int fd)
 
 	return 0;
 }
+#endif
 
 static void eth_rx(struct eth_context *ctx)
 {
@@ -376,10 +456,14 @@ static void eth_rx(struct eth_context *ctx)
 
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
+#if defined(CONFIG_NET_BATCH)
+			read_data_batch(ctx, ctx->dev_fd);
+#else
 			while (!eth_wait_data(ctx->dev_fd)) {
 				read_data(ctx, ctx->dev_fd);
 				k_yield();
 			}
+#endif
 		}
 
 		if (IS_ENABLED(CONFIG_NET_GPTP)) {
@@ -614,6 +698,9 @@ static const struct ethernet_api eth_if_api = {
 	.start = eth_start_device,
 	.stop = eth_stop_device,
 	.send = eth_send,
+#if defined(CONFIG_NET_BATCH)
+	.send_batch = eth_send_batch,
+#endif
 
 #if defined(CONFIG_NET_VLAN)
 	.vlan_setup = vlan_setup,
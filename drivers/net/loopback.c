@@ -82,12 +82,12 @@ int loopback_get_num_dropped_packets(void)
 
 #endif
 
-static int loopback_send(const struct device *dev, struct net_pkt *pkt)
+/* Turns pkt around and returns a clone of it for the RX path in *cloned,
+ * which is left NULL when a drop is simulated.
+ */
+static int loopback_reflect(struct net_pkt *pkt, struct net_pkt **cloned)
 {
-	struct net_pkt *cloned;
-	int res;
-
-	ARG_UNUSED(dev);
+	*cloned = NULL;
 
 #ifdef CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP
 	/* Drop packets based on the loopback_packet_drop_ratio
@@ -132,28 +132,101 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 	 * must be dropped. This is very much needed for TCP packets where
 	 * the packet is reference counted in various stages of sending.
 	 */
-	cloned = net_pkt_rx_clone(pkt, K_MSEC(100));
-	if (!cloned) {
-		res = -ENOMEM;
-		goto out;
+	*cloned = net_pkt_rx_clone(pkt, K_MSEC(100));
+	if (!*cloned) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static int loopback_send(const struct device *dev, struct net_pkt *pkt)
+{
+	struct net_pkt *cloned;
+	int res;
+
+	ARG_UNUSED(dev);
+
+	res = loopback_reflect(pkt, &cloned);
+	if (res == 0 && !cloned) {
+		return 0;
 	}
 
-	res = net_recv_data(net_pkt_iface(cloned), cloned);
-	if (res < 0) {
-		LOG_ERR("Data receive failed.");
+	if (res == 0) {
+		res = net_recv_data(net_pkt_iface(cloned), cloned);
+		if (res < 0) {
+			LOG_ERR("Data receive failed.");
+		}
 	}
 
-out:
 	/* Let the receiving thread run now */
 	k_yield();
 
 	return res;
 }
 
+#if defined(CONFIG_NET_BATCH)
+/* Hands the whole batch to the RX path at once, so the receiving
+ * thread gets to run only once per batch instead of once per packet.
+ */
+static int loopback_send_batch(const struct device *dev,
+			       struct net_pkt **pkts, size_t count)
+{
+	struct net_pkt *clones[CONFIG_NET_BATCH_SIZE];
+	size_t sent = 0;
+	int res = 0;
+
+	ARG_UNUSED(dev);
+
+	while (sent < count && res == 0) {
+		size_t n = 0, i;
+
+		for (i = sent; i < count && n < ARRAY_SIZE(clones); i++) {
+			struct net_pkt *cloned;
+
+			res = loopback_reflect(pkts[i], &cloned);
+			if (res < 0) {
+				break;
+			}
+
+			if (cloned) {
+				clones[n++] = cloned;
+			}
+		}
+
+		if (n > 0) {
+			int ret = net_recv_data_batch(net_pkt_iface(clones[0]),
+						      clones, n);
+
+			if (ret < 0) {
+				LOG_ERR("Data receive failed.");
+
+				while (n > 0) {
+					net_pkt_unref(clones[--n]);
+				}
+
+				res = ret;
+				break;
+			}
+		}
+
+		sent = i;
+	}
+
+	/* Let the receiving thread run now */
+	k_yield();
+
+	return sent > 0 ? (int)sent : res;
+}
+#endif
+
 static struct dummy_api loopback_api = {
 	.iface_api.init = loopback_init,
 
 	.send = loopback_send,
+#if defined(CONFIG_NET_BATCH)
+	.send_batch = loopback_send_batch,
+#endif
 };
 
 NET_DEVICE_INIT(loopback, "lo",
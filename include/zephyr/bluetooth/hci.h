@@ -2872,6 +2872,42 @@ int bt_hci_cmd_send(uint16_t opcode, struct net_buf *buf);
 int bt_hci_cmd_send_sync(uint16_t opcode, struct net_buf *buf,
 			 struct net_buf **rsp);
 
+/** @typedef bt_hci_cmd_cb_t
+  * @brief Callback for the completion of a HCI command.
+  *
+  * @param opcode    Command OpCode.
+  * @param status    HCI status of the Command Complete or Command Status
+  *                  event, or BT_HCI_ERR_UNSPECIFIED if the command could
+  *                  not be sent.
+  * @param rsp       Buffer containing the response parameters. Only valid
+  *                  for the duration of the callback.
+  * @param user_data User data given to bt_hci_cmd_send_cb().
+  */
+typedef void (*bt_hci_cmd_cb_t)(uint16_t opcode, uint8_t status,
+				struct net_buf *rsp, void *user_data);
+
+/** Send a HCI command and get called back when it completes.
+  *
+  * This function is used for sending a HCI command asynchronously while
+  * still getting its result. It can either be called for a buffer created
+  * using bt_hci_cmd_create(), or if the command has no parameters a NULL
+  * can be passed instead. Unlike bt_hci_cmd_send_sync() the caller does not
+  * wait, so several commands can be queued in a row and be sent as soon as
+  * the Controller accepts them (see CONFIG_BT_HCI_CMD_CREDITS_MAX).
+  *
+  * The callback is called from the context that processes the Command
+  * Complete or Command Status event, and must not block.
+  *
+  * @param opcode    Command OpCode.
+  * @param buf       Command buffer or NULL (if no parameters).
+  * @param cb        Callback for the command completion.
+  * @param user_data User data to pass to the callback.
+  *
+  * @return 0 on success or negative error value on failure.
+  */
+int bt_hci_cmd_send_cb(uint16_t opcode, struct net_buf *buf,
+		       bt_hci_cmd_cb_t cb, void *user_data);
+
 /** @brief Get connection handle for a connection.
  *
  * @param conn Connection object.
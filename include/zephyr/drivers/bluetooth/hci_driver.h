@@ -35,6 +35,10 @@ enum {
 	 * default data length parameters. Therefore the host should initiate
 	 * the DLE procedure after connection establishment. */
 	BT_QUIRK_NO_AUTO_DLE = BIT(1),
+	/* The driver has copied the data of an ACL buffer by the time send()
+	 * returns, so the host may reuse the buffer memory straight away.
+	 */
+	BT_QUIRK_ACL_SEND_COPY = BIT(2),
 };
 
 #define IS_BT_QUIRK_NO_AUTO_DLE(bt_dev) ((bt_dev)->drv->quirks & BT_QUIRK_NO_AUTO_DLE)
@@ -4901,8 +4901,14 @@ struct k_mem_slab {
 	uint32_t num_blocks;
 	size_t block_size;
 	char *buffer;
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	/* Tagged free list head: block index, waiters flag and ABA tag */
+	atomic_t free_head;
+	atomic_t num_used;
+#else
 	char *free_list;
 	uint32_t num_used;
+#endif
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
 #endif
@@ -4910,6 +4916,12 @@ struct k_mem_slab {
 	SYS_PORT_TRACING_TRACKING_FIELD(k_mem_slab)
 };
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+#define Z_MEM_SLAB_FREE_LIST_INIT .free_head = ATOMIC_INIT(0)
+#else
+#define Z_MEM_SLAB_FREE_LIST_INIT .free_list = NULL
+#endif
+
 #define Z_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
 			       slab_num_blocks) \
 	{ \
@@ -4918,7 +4930,7 @@ struct k_mem_slab {
 	.num_blocks = slab_num_blocks, \
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
-	.free_list = NULL, \
+	Z_MEM_SLAB_FREE_LIST_INIT, \
 	.num_used = 0, \
 	}
 
@@ -5058,7 +5070,11 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	return (uint32_t)atomic_get(&slab->num_used);
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -5093,7 +5109,7 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /**
@@ -5211,10 +5227,18 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+/* Size of struct z_heap, without its buckets.  See lib/os/heap.h */
+#define Z_HEAP_HDR_SIZE (16 + \
+	(IS_ENABLED(CONFIG_SYS_HEAP_RUNTIME_STATS) ? 3 * sizeof(size_t) : 0) + \
+	(IS_ENABLED(CONFIG_SYS_HEAP_LARGE_CHUNK_TREE) ? sizeof(struct rbtree) : 0))
+
 /* Hand-calculated minimum heap sizes needed to return a successful
- * 1-byte allocation.  See details in lib/os/heap.[ch]
+ * 1-byte allocation: chunk0 with the header and up to 4 buckets, then
+ * the smallest chunk and the end marker, 16 and 8 bytes in big heaps,
+ * 8 and 4 bytes in small ones.  See details in lib/os/heap.[ch]
  */
-#define Z_HEAP_MIN_SIZE (sizeof(void *) > 4 ? 56 : 44)
+#define Z_HEAP_MIN_SIZE (ROUND_UP(Z_HEAP_HDR_SIZE + 4 * 4, 8) + \
+	((sizeof(void *) > 4 || IS_ENABLED(CONFIG_SYS_HEAP_BIG_ONLY)) ? 24 : 12))
 
 /**
  * @brief Define a static k_heap in the specified linker section
@@ -57,4 +57,29 @@ struct _priq_mq {
 
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
 
+/* Hybrid of the multi-queue above and deadline scheduling.  Threads
+ * without a deadline live in per-priority FIFO lists exactly like
+ * _priq_mq.  Threads that have been given a deadline are instead
+ * kept in a per-priority pairing heap (min-heap on deadline, ties
+ * broken in insertion order), which is only populated for priorities
+ * that actually hold such threads.  The bitmask covers both.
+ */
+struct _priq_heap_node {
+	struct _priq_heap_node *child;
+	struct _priq_heap_node *next;
+	/* previous sibling, or parent for the leftmost child */
+	struct _priq_heap_node *prev;
+};
+
+struct _priq_hybrid {
+	sys_dlist_t queues[32];
+	struct _priq_heap_node *heaps[32];
+	unsigned int bitmask; /* bit 1<<i set if queues[i] or heaps[i] non-empty */
+	uint32_t next_order_key;
+};
+
+void z_priq_hybrid_add(struct _priq_hybrid *pq, struct k_thread *thread);
+void z_priq_hybrid_remove(struct _priq_hybrid *pq, struct k_thread *thread);
+struct k_thread *z_priq_hybrid_best(struct _priq_hybrid *pq);
+
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
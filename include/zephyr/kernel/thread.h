@@ -60,6 +60,9 @@ struct _thread_base {
 	union {
 		sys_dnode_t qnode_dlist;
 		struct rbnode qnode_rb;
+#ifdef CONFIG_SCHED_HYBRID
+		struct _priq_heap_node qnode_heap;
+#endif
 	};
 
 	/* wait queue on which the thread is pended (needed only for
@@ -104,6 +107,13 @@ struct _thread_base {
 	int prio_deadline;
 #endif
 
+#ifdef CONFIG_SCHED_HYBRID
+	/* Set once the thread was given a deadline, selects the per
+	 * priority heap instead of the FIFO list in the ready queue
+	 */
+	uint8_t has_deadline;
+#endif
+
 	uint32_t order_key;
 
 #ifdef CONFIG_SMP
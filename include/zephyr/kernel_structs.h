@@ -92,6 +92,8 @@ struct _ready_q {
 	struct _priq_rb runq;
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
+#elif defined(CONFIG_SCHED_HYBRID)
+	struct _priq_hybrid runq;
 #endif
 };
 
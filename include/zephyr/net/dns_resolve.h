@@ -240,6 +240,17 @@ struct dns_resolve_context {
 		 * cannot be used to find correct pending query.
 		 */
 		uint16_t query_hash;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/** Addresses received so far, to be cached at the end */
+		struct dns_addrinfo cache_addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+		/** Smallest TTL of the received records, in seconds */
+		uint32_t cache_ttl;
+
+		/** Number of addresses in cache_addrs */
+		uint8_t cache_count;
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
 	/** Is this context in use */
@@ -446,6 +457,76 @@ static inline int dns_cancel_addr_info(uint16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * @typedef dns_resolve_cache_cb_t
+ * @brief Callback used when going through the DNS cache.
+ *
+ * @param query Name that was resolved.
+ * @param type Type of the query.
+ * @param addrs Cached addresses.
+ * @param count Number of cached addresses, 0 if it is cached that there
+ * are none.
+ * @param ttl Number of seconds before the entry expires.
+ * @param user_data User data given to dns_resolve_cache_foreach().
+ */
+typedef void (*dns_resolve_cache_cb_t)(const char *query,
+				       enum dns_query_type type,
+				       const struct dns_addrinfo *addrs,
+				       int count, uint32_t ttl,
+				       void *user_data);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE) || defined(__DOXYGEN__)
+/**
+ * @brief Remove all the entries from the DNS cache.
+ *
+ * @details Names that are resolved afterwards are queried from the DNS
+ * servers again.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int dns_resolve_cache_flush(void);
+
+/**
+ * @brief Remove the cached results for a name from the DNS cache.
+ *
+ * @param query Name to remove, both its A and AAAA results are removed.
+ *
+ * @return Number of removed entries, -ENOENT if the name was not cached.
+ */
+int dns_resolve_cache_remove(const char *query);
+
+/**
+ * @brief Go through all the entries of the DNS cache.
+ *
+ * @param cb Callback to call for each entry.
+ * @param user_data User data to pass to the callback.
+ *
+ * @return Number of entries, <0 if error.
+ */
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data);
+#else
+static inline int dns_resolve_cache_flush(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int dns_resolve_cache_remove(const char *query)
+{
+	ARG_UNUSED(query);
+
+	return -ENOTSUP;
+}
+
+static inline int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb,
+					    void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /**
  * @}
  */
@@ -452,6 +452,15 @@ struct ethernet_api {
 
 	/** Send a network packet */
 	int (*send)(const struct device *dev, struct net_pkt *pkt);
+
+#if defined(CONFIG_NET_BATCH)
+	/** Optional. Send count network packets in order. Returns how many
+	 * were sent, from the start of the array, or a negative error if
+	 * none could be sent.
+	 */
+	int (*send_batch)(const struct device *dev, struct net_pkt **pkts,
+			  size_t count);
+#endif
 };
 
 /* Make sure that the network interface API is properly setup inside
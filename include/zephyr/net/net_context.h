@@ -282,8 +282,18 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** Interest list entries of the epoll instances this socket is in */
+	sys_slist_t epoll_items;
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
 #endif /* CONFIG_NET_SOCKETS */
 
+#if defined(CONFIG_NET_BATCH)
+	/** Packets held to be queued together, see net_if_tx_batch_begin() */
+	struct net_if_tx_batch *tx_batch;
+#endif /* CONFIG_NET_BATCH */
+
 #if defined(CONFIG_NET_OFFLOAD)
 	/** context for use by offload drivers */
 	void *offload_context;
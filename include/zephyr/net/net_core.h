@@ -117,6 +117,27 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by a network device driver to push several received
+ * network packets up in the network stack at once.
+ *
+ * @details The packets are passed to the RX traffic class queues with
+ * as few queue operations as possible, keeping their order. Unlike with
+ * net_recv_data(), on success the stack takes all the packets: empty
+ * and filtered out packets are freed. Only available with
+ * CONFIG_NET_BATCH.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of received network packets, NULL entries are
+ *             skipped. The array is modified.
+ * @param count Number of entries in the array.
+ *
+ * @return 0 if ok, <0 if error, in which case the caller still owns
+ *         the packets.
+ */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
@@ -708,6 +708,69 @@ static inline const struct device *net_if_get_device(struct net_if *iface)
  */
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Queue several packets to the net interface TX queues at once
+ *
+ * @details Same as calling net_if_queue_tx() for each packet, except
+ * that consecutive packets going to the same traffic class are queued
+ * with a single queue operation, or given to the L2 together when there
+ * are no TX queues. Only available with CONFIG_NET_BATCH.
+ *
+ * @param iface Pointer to a network interface structure
+ * @param pkts Array of net packets to queue, it is modified
+ * @param count Number of packets in the array
+ */
+void net_if_queue_tx_batch(struct net_if *iface, struct net_pkt **pkts,
+			   size_t count);
+
+#if defined(CONFIG_NET_BATCH)
+/**
+ * @brief Packets of a net context held back to be queued together
+ *
+ * @details While a batch is open on a context, the packets the calling
+ * thread sends on it are not queued by net_if_send_data() one by one but
+ * collected here and given to net_if_queue_tx_batch() when the batch is
+ * full, when a packet goes to another interface or when the batch ends.
+ */
+struct net_if_tx_batch {
+	/** Thread whose packets are held */
+	struct k_thread *thread;
+
+	/** Context the packets are sent on */
+	struct net_context *context;
+
+	/** Interface of the held packets */
+	struct net_if *iface;
+
+	/** Number of held packets */
+	size_t count;
+
+	/** Held packets, in the order they were sent */
+	struct net_pkt *pkts[CONFIG_NET_BATCH_SIZE];
+};
+
+/**
+ * @brief Start holding the packets the current thread sends on a context
+ *
+ * @details Lets a caller that sends several datagrams in a row queue them
+ * together with net_if_queue_tx_batch(), as the sockets do for the datagrams
+ * of one sendmmsg() call. The caller must keep other threads from sending
+ * on the context until net_if_tx_batch_end() is called.
+ *
+ * @param batch Batch to fill, it must stay valid until the batch ends
+ * @param context Net context the packets are sent on
+ */
+void net_if_tx_batch_begin(struct net_if_tx_batch *batch,
+			   struct net_context *context);
+
+/**
+ * @brief Queue the held packets and stop holding packets
+ *
+ * @param batch Batch started with net_if_tx_batch_begin()
+ */
+void net_if_tx_batch_end(struct net_if_tx_batch *batch);
+#endif /* CONFIG_NET_BATCH */
+
 /**
  * @brief Return the IP offload status
  *
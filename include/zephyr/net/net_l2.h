@@ -76,6 +76,17 @@ struct net_l2 {
 	 * Return L2 flags for the network interface.
 	 */
 	enum net_l2_flags (*get_flags)(struct net_if *iface);
+
+#if defined(CONFIG_NET_BATCH)
+	/**
+	 * Optional. Like send(), but for count packets at once, so that
+	 * the driver can be given all of them in one call. The result of
+	 * sending each packet, as send() would return it, is stored in
+	 * the status array.
+	 */
+	void (*send_batch)(struct net_if *iface, struct net_pkt **pkts,
+			   int *status, size_t count);
+#endif
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -144,6 +155,23 @@ NET_L2_DECLARE_PUBLIC(CUSTOM_IEEE802154_L2);
 		.get_flags = (_get_flags_fn),				\
 	}
 
+#if defined(CONFIG_NET_BATCH)
+#define NET_L2_INIT_BATCH(_name, _recv_fn, _send_fn, _send_batch_fn,	\
+			  _enable_fn, _get_flags_fn)			\
+	const STRUCT_SECTION_ITERABLE(net_l2,				\
+				      NET_L2_GET_NAME(_name)) = {	\
+		.recv = (_recv_fn),					\
+		.send = (_send_fn),					\
+		.enable = (_enable_fn),					\
+		.get_flags = (_get_flags_fn),				\
+		.send_batch = (_send_batch_fn),				\
+	}
+#else
+#define NET_L2_INIT_BATCH(_name, _recv_fn, _send_fn, _send_batch_fn,	\
+			  _enable_fn, _get_flags_fn)			\
+	NET_L2_INIT(_name, _recv_fn, _send_fn, _enable_fn, _get_flags_fn)
+#endif
+
 #define NET_L2_GET_DATA(name, sfx) _net_l2_data_##name##sfx
 
 #define NET_L2_DATA_INIT(name, sfx, ctx_type)				\
@@ -151,6 +179,11 @@ NET_L2_DECLARE_PUBLIC(CUSTOM_IEEE802154_L2);
 
 typedef int (*net_l2_send_t)(const struct device *dev, struct net_pkt *pkt);
 
+#if defined(CONFIG_NET_BATCH)
+typedef int (*net_l2_send_batch_t)(const struct device *dev,
+				   struct net_pkt **pkts, size_t count);
+#endif
+
 static inline int net_l2_send(net_l2_send_t send_fn,
 			      const struct device *dev,
 			      struct net_if *iface,
@@ -161,6 +194,23 @@ static inline int net_l2_send(net_l2_send_t send_fn,
 	return send_fn(dev, pkt);
 }
 
+#if defined(CONFIG_NET_BATCH)
+/* Returns the number of packets sent, from the start of the array, or
+ * a negative error if none could be sent.
+ */
+static inline int net_l2_send_batch(net_l2_send_batch_t send_batch_fn,
+				    const struct device *dev,
+				    struct net_if *iface,
+				    struct net_pkt **pkts, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		net_capture_pkt(iface, pkts[i]);
+	}
+
+	return send_batch_fn(dev, pkts, count);
+}
+#endif
+
 /** @endcond */
 
 /**
@@ -33,6 +33,8 @@
 extern "C" {
 #endif
 
+struct timespec;
+
 struct zsock_pollfd {
 	int fd;
 	short events;
@@ -63,6 +65,11 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_recvmmsg: block for the first message only */
+#define ZSOCK_MSG_WAITFORONE 0x10000
+
+/** zsock_sendmmsg/zsock_recvmmsg: most messages handled in one call */
+#define ZSOCK_MMSG_MAX 1024
 
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
@@ -403,6 +410,70 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send multiple messages on a socket
+ *
+ * @details
+ * Sends up to @p vlen messages described by @p msgvec, as if
+ * zsock_sendmsg() was called for each of them, but in a single call. The
+ * number of bytes sent for each message is stored in its msg_len field.
+ * @rst
+ * This follows the Linux ``sendmmsg()`` call.
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param sock Socket to send on
+ * @param msgvec Messages to send
+ * @param vlen Number of messages in @p msgvec, at most
+ *        @ref ZSOCK_MMSG_MAX are sent
+ * @param flags Flags, as for zsock_sendmsg()
+ *
+ * @return Number of messages sent. If sending the first message fails,
+ *         -1 with errno set. An error after the first message ends the
+ *         call early and is not reported.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple messages from a socket
+ *
+ * @details
+ * Receives up to @p vlen datagrams into the buffers described by
+ * @p msgvec, as if a message was received for each of them, but in a
+ * single call. The length of each datagram is stored in its msg_len field,
+ * its source address in msg_name and ZSOCK_MSG_TRUNC in msg_flags if it
+ * did not fit in the buffers. Ancillary data is not supported, and
+ * msg_controllen is set to 0.
+ *
+ * The call blocks until @p vlen datagrams are received, unless
+ * ZSOCK_MSG_DONTWAIT is given or the socket is non-blocking. With
+ * ZSOCK_MSG_WAITFORONE, it only blocks for the first datagram and then
+ * returns the ones that are already queued.
+ * @rst
+ * This follows the Linux ``recvmmsg()`` call, and like it checks
+ * @p timeout only after each datagram is received.
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param sock Socket to receive from
+ * @param msgvec Buffers for the messages
+ * @param vlen Number of messages in @p msgvec, at most
+ *        @ref ZSOCK_MMSG_MAX are received
+ * @param flags Flags, as for zsock_recvfrom(), and ZSOCK_MSG_WAITFORONE
+ * @param timeout Time after which no more datagrams are waited for, or
+ *        NULL. A timeout too long to be counted in system ticks never
+ *        expires.
+ *
+ * @return Number of messages received, or -1 with errno set if no
+ *         message was received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags,
+			     struct timespec *timeout);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -778,6 +849,21 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+/** POSIX wrapper for @ref zsock_recvmmsg */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags,
+			   struct timespec *timeout)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags, timeout);
+}
+
 /** POSIX wrapper for @ref zsock_recvfrom */
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
@@ -888,6 +974,8 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 /** POSIX wrapper for @ref ZSOCK_MSG_WAITALL */
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+/** POSIX wrapper for @ref ZSOCK_MSG_WAITFORONE */
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 /** POSIX wrapper for @ref ZSOCK_SHUT_RD */
 #define SHUT_RD ZSOCK_SHUT_RD
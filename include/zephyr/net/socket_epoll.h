@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <errno.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/net/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** zsock_epoll_event: data is available to read, or a connection to accept */
+#define ZSOCK_EPOLLIN ZSOCK_POLLIN
+/** zsock_epoll_event: data can be written */
+#define ZSOCK_EPOLLOUT ZSOCK_POLLOUT
+/** zsock_epoll_event: an error occurred, always reported */
+#define ZSOCK_EPOLLERR ZSOCK_POLLERR
+/** zsock_epoll_event: the peer closed the connection, always reported */
+#define ZSOCK_EPOLLHUP ZSOCK_POLLHUP
+/** zsock_epoll_ctl: report the socket when it becomes ready, not while it is */
+#define ZSOCK_EPOLLET BIT(31)
+
+/** zsock_epoll_ctl: add a socket to the interest list */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: remove a socket from the interest list */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: change the events of a socket in the interest list */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** User data returned with the events of a socket */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+/** Events of a socket */
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* event flags */
+	uint32_t events;
+	/** User data given to zsock_epoll_ctl() */
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * An epoll instance has an interest list of sockets, which persists across
+ * calls to zsock_epoll_wait(). The sockets report their events to the
+ * instances they are in as the events happen, so waiting does not need to
+ * go through the whole list like zsock_poll() does.
+ *
+ * Only native sockets are supported. Sockets are removed from the interest
+ * list when they are closed.
+ * @rst
+ * This follows the Linux ``epoll_create1()`` call.
+ * This function is also exposed as ``epoll_create1()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param flags Must be 0
+ *
+ * @return File descriptor of the instance, or -1 with errno set
+ */
+__syscall int zsock_epoll_create(int flags);
+
+/**
+ * @brief Change the interest list of an epoll instance
+ *
+ * @details
+ * @rst
+ * This follows the Linux ``epoll_ctl()`` call.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd File descriptor of the epoll instance
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_DEL or ZSOCK_EPOLL_CTL_MOD
+ * @param fd Socket to add, remove or change
+ * @param event Events to wait for, with ZSOCK_EPOLLET for edge triggered
+ *        events, and the user data to return with them. Not used with
+ *        ZSOCK_EPOLL_CTL_DEL.
+ *
+ * @return 0 on success, -1 with errno set otherwise
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on the sockets of an epoll instance
+ *
+ * @details
+ * Level triggered sockets are reported for as long as they are ready,
+ * edge triggered ones only once each time they become ready (for
+ * ZSOCK_EPOLLIN, each time new data or a new connection arrives).
+ * @rst
+ * This follows the Linux ``epoll_wait()`` call.
+ * This function is also exposed as ``epoll_wait()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd File descriptor of the epoll instance
+ * @param events Array for the events of the ready sockets
+ * @param maxevents Size of @p events
+ * @param timeout Timeout in milliseconds, -1 to wait forever
+ *
+ * @return Number of sockets returned in @p events, 0 on timeout, or -1 with
+ *         errno set
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+#define epoll_data_t zsock_epoll_data_t
+#define epoll_event zsock_epoll_event
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create(flags);
+}
+
+static inline int epoll_create(int size)
+{
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return zsock_epoll_create(0);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <syscalls/socket_epoll.h>
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
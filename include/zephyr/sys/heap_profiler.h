@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HEAP_PROFILER_H
+#define ZEPHYR_INCLUDE_SYS_HEAP_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_HEAP_PROFILER) || defined(__DOXYGEN__)
+
+/**
+ * @defgroup heap_profiler_apis Heap Profiler APIs
+ * @ingroup heaps
+ * @{
+ */
+
+/**
+ * @brief Call site of the function using this macro.
+ *
+ * Allocation functions use this to identify their caller, that is the
+ * code the allocated memory gets attributed to.
+ */
+#define HEAP_PROFILER_CALL_SITE() __builtin_return_address(0)
+
+/** Allocation statistics of one call site. */
+struct heap_profiler_site {
+	/** Return address of the allocation call */
+	void *site;
+
+	/** Bytes currently allocated from this call site */
+	size_t live_bytes;
+
+	/** Maximum of live_bytes since boot or the last reset */
+	size_t peak_bytes;
+
+	/** Number of allocations made from this call site */
+	uint32_t allocs;
+
+	/** Number of those allocations freed so far */
+	uint32_t frees;
+};
+
+/**
+ * @typedef heap_profiler_site_cb_t
+ * @brief Callback used to enumerate profiled call sites
+ *
+ * @param site Snapshot of the call site statistics
+ * @param user_data User data provided to heap_profiler_foreach_site()
+ */
+typedef void (*heap_profiler_site_cb_t)(const struct heap_profiler_site *site,
+					void *user_data);
+
+/**
+ * @brief Record an allocation
+ *
+ * @param mem Pointer to the allocated memory
+ * @param bytes Size of the allocated memory
+ * @param site Call site the allocation is attributed to
+ */
+void heap_profiler_alloc(void *mem, size_t bytes, void *site);
+
+/**
+ * @brief Record that a profiled allocation was freed
+ *
+ * Pointers which were never recorded are ignored.
+ *
+ * @param mem Pointer to the freed memory
+ */
+void heap_profiler_free(void *mem);
+
+/**
+ * @brief Record a reallocation
+ *
+ * Same as heap_profiler_free() on @a old followed by
+ * heap_profiler_alloc() on @a mem, with a single update of the
+ * profiler tables. Either pointer may be NULL.
+ *
+ * @param old Pointer to the memory before the reallocation
+ * @param mem Pointer to the memory after the reallocation
+ * @param bytes Size of the memory after the reallocation
+ * @param site Call site the allocation is attributed to
+ */
+void heap_profiler_realloc(void *old, void *mem, size_t bytes, void *site);
+
+/**
+ * @brief Enumerate the profiled call sites
+ *
+ * Sites with no allocation attributed to them are skipped. The callback
+ * is given a copy of the statistics and is called without any lock held.
+ *
+ * @param cb Callback called for each call site
+ * @param user_data Data passed to the callback
+ */
+void heap_profiler_foreach_site(heap_profiler_site_cb_t cb, void *user_data);
+
+/**
+ * @brief Reset the peak of every call site to its current live bytes
+ */
+void heap_profiler_reset_peak(void);
+
+/**
+ * @brief Get the number of allocations that could not be profiled
+ *
+ * Allocations are dropped when the call site or allocation tables are
+ * full, see @kconfig{CONFIG_HEAP_PROFILER_MAX_SITES} and
+ * @kconfig{CONFIG_HEAP_PROFILER_MAX_ALLOCS}.
+ *
+ * @return Number of dropped allocations
+ */
+uint32_t heap_profiler_dropped_get(void);
+
+/** @} */
+
+#else
+
+#define HEAP_PROFILER_CALL_SITE() NULL
+
+#endif /* CONFIG_HEAP_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HEAP_PROFILER_H */
@@ -101,6 +101,24 @@ int sys_heap_runtime_stats_reset_max(struct sys_heap *heap);
  */
 void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes);
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+/** @brief Initialize sys_heap with a tree of large free chunks
+ *
+ * Like sys_heap_init(), but free chunks of at least
+ * CONFIG_SYS_HEAP_LARGE_CHUNK_SIZE bytes are kept in a tree sorted by
+ * size. Large allocations then get the best fitting chunk, and large
+ * aligned allocations can reuse a hole without room for the worst case
+ * alignment padding. Meant for heaps serving frame buffers and other
+ * big, page aligned blocks.
+ *
+ * @param heap Heap to initialize
+ * @param mem Untyped pointer to unused memory
+ * @param bytes Size of region pointed to by @a mem
+ */
+void sys_heap_init_large_chunk_tree(struct sys_heap *heap, void *mem,
+				    size_t bytes);
+#endif
+
 /** @brief Allocate memory from a sys_heap
  *
  * Returns a pointer to a block of unused memory in the heap.  This
@@ -135,6 +153,21 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes);
  */
 void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes);
 
+/** @brief Allocate aligned memory from a sys_heap for a given call site
+ *
+ * Same as sys_heap_aligned_alloc(), but the heap profiler attributes
+ * the memory to @a site. Allocators built on sys_heap pass their own
+ * caller, so the block is recorded once, with the right call site.
+ *
+ * @param heap Heap from which to allocate
+ * @param align Alignment in bytes, must be a power of two
+ * @param bytes Number of bytes requested
+ * @param site Call site the allocation is attributed to
+ * @return Pointer to memory the caller can now use
+ */
+void *z_sys_heap_aligned_alloc_site(struct sys_heap *heap, size_t align,
+				    size_t bytes, void *site);
+
 /** @brief Free memory into a sys_heap
  *
  * De-allocates a pointer to memory previously returned from
@@ -104,6 +104,23 @@ static inline void *z_thread_malloc(size_t size)
 	return z_thread_aligned_alloc(0, size);
 }
 
+/**
+ * @brief Allocate aligned memory from a k_heap for a given call site
+ *
+ * Same as k_heap_aligned_alloc(), but the heap profiler attributes the
+ * memory to @a site. Allocators built on k_heap pass their own caller,
+ * so the block is recorded once, with the right call site.
+ *
+ * @param h Heap from which to allocate
+ * @param align Alignment in bytes, must be a power of two
+ * @param bytes Number of bytes requested
+ * @param timeout How long to wait, or K_NO_WAIT
+ * @param site Call site the allocation is attributed to
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *z_k_heap_aligned_alloc_site(struct k_heap *h, size_t align, size_t bytes,
+				  k_timeout_t timeout, void *site);
+
 /* set and clear essential thread flag */
 
 extern void z_thread_essential_set(void);
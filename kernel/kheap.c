@@ -9,6 +9,8 @@
 #include <zephyr/wait_q.h>
 #include <zephyr/init.h>
 #include <zephyr/linker/linker-defs.h>
+#include <kernel_internal.h>
+#include <zephyr/sys/heap_profiler.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
@@ -61,8 +63,8 @@ SYS_INIT_NAMED(statics_init_pre, statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_
 SYS_INIT_NAMED(statics_init_post, statics_init, POST_KERNEL, 0);
 #endif /* CONFIG_DEMAND_PAGING && !CONFIG_LINKER_GENERIC_SECTIONS_PRESENT_AT_BOOT */
 
-void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
-			k_timeout_t timeout)
+void *z_k_heap_aligned_alloc_site(struct k_heap *h, size_t align, size_t bytes,
+				  k_timeout_t timeout, void *site)
 {
 	int64_t now, end = sys_clock_timeout_end_calc(timeout);
 	void *ret = NULL;
@@ -78,7 +80,7 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 	bool blocked_alloc = false;
 
 	while (ret == NULL) {
-		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		ret = z_sys_heap_aligned_alloc_site(&h->heap, align, bytes, site);
 
 		now = sys_clock_tick_get();
 		if (!IS_ENABLED(CONFIG_MULTITHREADING) ||
@@ -104,14 +106,23 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
 
 	k_spin_unlock(&h->lock, key);
+
 	return ret;
 }
 
+void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
+			k_timeout_t timeout)
+{
+	return z_k_heap_aligned_alloc_site(h, align, bytes, timeout,
+					   HEAP_PROFILER_CALL_SITE());
+}
+
 void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 {
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, alloc, h, timeout);
 
-	void *ret = k_heap_aligned_alloc(h, sizeof(void *), bytes, timeout);
+	void *ret = z_k_heap_aligned_alloc_site(h, sizeof(void *), bytes, timeout,
+						HEAP_PROFILER_CALL_SITE());
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, alloc, h, timeout, ret);
 
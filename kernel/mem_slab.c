@@ -15,6 +15,103 @@
 #include <zephyr/init.h>
 #include <zephyr/sys/check.h>
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+/*
+ * The lock-free free list head packs three fields into a single atomic word
+ * so it can be updated with one compare-and-swap:
+ *
+ *   - the index of the first free block (SLAB_IDX_NONE when empty),
+ *   - a flag telling that threads are (or are about to be) pended on the
+ *     slab, which forces k_mem_slab_free() to take the lock, and
+ *   - a tag incremented on every update, protecting the list against ABA.
+ *
+ * Each free block stores the index of the next free block in its first word.
+ *
+ * The option depends on 64BIT, which leaves 31 bits for the tag. A stale
+ * head is only accepted after a multiple of 2^31 updates.
+ */
+#define SLAB_IDX_BITS	(sizeof(atomic_val_t) * 4U)
+#define SLAB_IDX_NONE	((atomic_val_t)BIT_MASK(SLAB_IDX_BITS))
+#define SLAB_WAITERS	((atomic_val_t)BIT(SLAB_IDX_BITS))
+#define SLAB_TAG_INC	((unsigned long)BIT(SLAB_IDX_BITS + 1U))
+
+static inline atomic_val_t slab_head_next(atomic_val_t old, atomic_val_t idx)
+{
+	unsigned long tag = ((unsigned long)old & ~((unsigned long)SLAB_TAG_INC - 1UL)) +
+			    SLAB_TAG_INC;
+
+	return (atomic_val_t)(tag | (unsigned long)idx);
+}
+
+static inline char *slab_block(struct k_mem_slab *slab, atomic_val_t idx)
+{
+	return slab->buffer + (size_t)idx * slab->block_size;
+}
+
+/* Pop a block from the free list, returns false if the list is empty */
+static bool slab_pop(struct k_mem_slab *slab, void **mem)
+{
+	atomic_val_t old, idx, next;
+
+	do {
+		old = atomic_get(&slab->free_head);
+		idx = old & SLAB_IDX_NONE;
+		if (idx == SLAB_IDX_NONE) {
+			return false;
+		}
+
+		/* The block may be handed out concurrently, in which case
+		 * the value read here is garbage but the tag makes the
+		 * compare-and-swap below fail.
+		 */
+		next = *(volatile atomic_val_t *)slab_block(slab, idx);
+	} while (!atomic_cas(&slab->free_head, old,
+			     slab_head_next(old, next & SLAB_IDX_NONE)));
+
+	*mem = slab_block(slab, idx);
+
+	return true;
+}
+
+/*
+ * Push a block to the free list. Unless @p force is set the push is refused
+ * when the waiters flag is set, as the block must then be handed over to a
+ * pending thread with the lock held.
+ */
+static bool slab_push(struct k_mem_slab *slab, void *mem, bool force)
+{
+	atomic_val_t idx = ((char *)mem - slab->buffer) / slab->block_size;
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&slab->free_head);
+		if (!force && ((old & SLAB_WAITERS) != 0)) {
+			return false;
+		}
+
+		*(volatile atomic_val_t *)mem = old & SLAB_IDX_NONE;
+	} while (!atomic_cas(&slab->free_head, old, slab_head_next(old, idx)));
+
+	return true;
+}
+
+static inline void slab_used_inc(struct k_mem_slab *slab)
+{
+	atomic_val_t used = atomic_inc(&slab->num_used) + 1;
+
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	/* Racy against concurrent updates, but never underestimates by more
+	 * than the number of CPUs allocating at the same time.
+	 */
+	if ((uint32_t)used > slab->max_used) {
+		slab->max_used = (uint32_t)used;
+	}
+#else
+	ARG_UNUSED(used);
+#endif
+}
+#endif /* CONFIG_MEM_SLAB_LOCKLESS */
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -35,6 +132,23 @@ static int create_free_list(struct k_mem_slab *slab)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	/* block indexes must fit in the free list head */
+	CHECKIF((atomic_val_t)slab->num_blocks >= SLAB_IDX_NONE) {
+		return -EINVAL;
+	}
+
+	p = slab->buffer;
+
+	for (j = 0U; j < slab->num_blocks; j++) {
+		*(atomic_val_t *)p = (j + 1U < slab->num_blocks) ?
+				     (atomic_val_t)(j + 1U) : SLAB_IDX_NONE;
+		p += slab->block_size;
+	}
+
+	atomic_set(&slab->free_head,
+		   slab->num_blocks != 0U ? 0 : SLAB_IDX_NONE);
+#else
 	slab->free_list = NULL;
 	p = slab->buffer;
 
@@ -43,6 +157,7 @@ static int create_free_list(struct k_mem_slab *slab)
 		slab->free_list = p;
 		p += slab->block_size;
 	}
+#endif
 	return 0;
 }
 
@@ -81,7 +196,11 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->num_blocks = num_blocks;
 	slab->block_size = block_size;
 	slab->buffer = buffer;
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	atomic_clear(&slab->num_used);
+#else
 	slab->num_used = 0U;
+#endif
 	slab->lock = (struct k_spinlock) {};
 
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
@@ -101,6 +220,112 @@ out:
 	return rc;
 }
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	atomic_val_t old;
+	int result;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, alloc, slab, timeout);
+
+	/* fast path: take a free block without locking */
+	if (slab_pop(slab, mem)) {
+		slab_used_inc(slab);
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, 0);
+
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) ||
+	    !IS_ENABLED(CONFIG_MULTITHREADING)) {
+		/* don't wait for a free block to become available */
+		*mem = NULL;
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, -ENOMEM);
+
+		return -ENOMEM;
+	}
+
+	key = k_spin_lock(&slab->lock);
+
+	/* Publish the waiters flag while the list is empty, so that any block
+	 * freed from now on goes through the locked path and wakes us up. A
+	 * block freed in the meantime is simply taken.
+	 */
+	do {
+		if (slab_pop(slab, mem)) {
+			slab_used_inc(slab);
+
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, 0);
+
+			k_spin_unlock(&slab->lock, key);
+
+			return 0;
+		}
+
+		old = atomic_get(&slab->free_head);
+	} while (((old & SLAB_IDX_NONE) != SLAB_IDX_NONE) ||
+		 !atomic_cas(&slab->free_head, old, old | SLAB_WAITERS));
+
+	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mem_slab, alloc, slab, timeout);
+
+	/* wait for a free block or timeout */
+	result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
+	if (result == 0) {
+		*mem = _current->base.swap_data;
+	}
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
+
+	return result;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	k_spinlock_key_t key;
+	struct k_thread *pending_thread;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, free, slab);
+
+	/* fast path: nobody is waiting, return the block without locking */
+	if (slab_push(slab, *mem, false)) {
+		atomic_dec(&slab->num_used);
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+
+		return;
+	}
+
+	key = k_spin_lock(&slab->lock);
+
+	pending_thread = z_unpend_first_thread(&slab->wait_q);
+	if (z_waitq_head(&slab->wait_q) == NULL) {
+		/* The free list is empty while the flag is set and the flag
+		 * can only be set with the lock held, so it is safe to clear.
+		 */
+		atomic_and(&slab->free_head, ~SLAB_WAITERS);
+	}
+
+	if (pending_thread != NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+
+		z_thread_return_value_set_with_data(pending_thread, 0, *mem);
+		z_ready_thread(pending_thread);
+		z_reschedule(&slab->lock, key);
+		return;
+	}
+
+	/* all waiters timed out in the meantime */
+	(void)slab_push(slab, *mem, true);
+	atomic_dec(&slab->num_used);
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+
+	k_spin_unlock(&slab->lock, key);
+}
+#else
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
 	k_spinlock_key_t key = k_spin_lock(&slab->lock);
@@ -170,6 +395,7 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 
 	k_spin_unlock(&slab->lock, key);
 }
+#endif /* CONFIG_MEM_SLAB_LOCKLESS */
 
 int k_mem_slab_runtime_stats_get(struct k_mem_slab *slab, struct sys_memory_stats *stats)
 {
@@ -179,8 +405,10 @@ int k_mem_slab_runtime_stats_get(struct k_mem_slab *slab, struct sys_memory_stat
 
 	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 
-	stats->allocated_bytes = slab->num_used * slab->block_size;
-	stats->free_bytes = (slab->num_blocks - slab->num_used) * slab->block_size;
+	uint32_t num_used = k_mem_slab_num_used_get(slab);
+
+	stats->allocated_bytes = num_used * slab->block_size;
+	stats->free_bytes = (slab->num_blocks - num_used) * slab->block_size;
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	stats->max_allocated_bytes = slab->max_used * slab->block_size;
 #else
@@ -201,7 +429,7 @@ int k_mem_slab_runtime_stats_reset_max(struct k_mem_slab *slab)
 
 	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 
-	slab->max_used = slab->num_used;
+	slab->max_used = k_mem_slab_num_used_get(slab);
 
 	k_spin_unlock(&slab->lock, key);
 
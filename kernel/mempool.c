@@ -8,8 +8,15 @@
 #include <string.h>
 #include <zephyr/sys/math_extras.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/sys/heap_profiler.h>
+#include <kernel_internal.h>
 
-static void *z_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t size)
+/* The block is recorded by the heap profiler for @a site, the caller of
+ * the public allocation function, as the outermost layer is the one
+ * the memory belongs to.
+ */
+static void *z_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t size,
+				  void *site)
 {
 	void *mem;
 	struct k_heap **heap_ref;
@@ -26,7 +33,7 @@ static void *z_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t size
 	}
 	__align = align | sizeof(heap_ref);
 
-	mem = k_heap_aligned_alloc(heap, __align, size, K_NO_WAIT);
+	mem = z_k_heap_aligned_alloc_site(heap, __align, size, K_NO_WAIT, site);
 	if (mem == NULL) {
 		return NULL;
 	}
@@ -61,7 +68,7 @@ void k_free(void *ptr)
 K_HEAP_DEFINE(_system_heap, CONFIG_HEAP_MEM_POOL_SIZE);
 #define _SYSTEM_HEAP (&_system_heap)
 
-void *k_aligned_alloc(size_t align, size_t size)
+static void *system_heap_aligned_alloc(size_t align, size_t size, void *site)
 {
 	__ASSERT(align / sizeof(void *) >= 1
 		&& (align % sizeof(void *)) == 0,
@@ -72,24 +79,34 @@ void *k_aligned_alloc(size_t align, size_t size)
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap_sys, k_aligned_alloc, _SYSTEM_HEAP);
 
-	void *ret = z_heap_aligned_alloc(_SYSTEM_HEAP, align, size);
+	void *ret = z_heap_aligned_alloc(_SYSTEM_HEAP, align, size, site);
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap_sys, k_aligned_alloc, _SYSTEM_HEAP, ret);
 
 	return ret;
 }
 
-void *k_malloc(size_t size)
+void *k_aligned_alloc(size_t align, size_t size)
+{
+	return system_heap_aligned_alloc(align, size, HEAP_PROFILER_CALL_SITE());
+}
+
+static void *system_heap_malloc(size_t size, void *site)
 {
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap_sys, k_malloc, _SYSTEM_HEAP);
 
-	void *ret = k_aligned_alloc(sizeof(void *), size);
+	void *ret = system_heap_aligned_alloc(sizeof(void *), size, site);
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap_sys, k_malloc, _SYSTEM_HEAP, ret);
 
 	return ret;
 }
 
+void *k_malloc(size_t size)
+{
+	return system_heap_malloc(size, HEAP_PROFILER_CALL_SITE());
+}
+
 void *k_calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -103,7 +120,7 @@ void *k_calloc(size_t nmemb, size_t size)
 		return NULL;
 	}
 
-	ret = k_malloc(bounds);
+	ret = system_heap_malloc(bounds, HEAP_PROFILER_CALL_SITE());
 	if (ret != NULL) {
 		(void)memset(ret, 0, bounds);
 	}
@@ -133,7 +150,8 @@ void *z_thread_aligned_alloc(size_t align, size_t size)
 	}
 
 	if (heap != NULL) {
-		ret = z_heap_aligned_alloc(heap, align, size);
+		ret = z_heap_aligned_alloc(heap, align, size,
+					   HEAP_PROFILER_CALL_SITE());
 	} else {
 		ret = NULL;
 	}
@@ -41,6 +41,10 @@ static ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq,
 					struct k_thread *thread);
 static ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq,
 					   struct k_thread *thread);
+#elif defined(CONFIG_SCHED_HYBRID)
+#define _priq_run_add		z_priq_hybrid_add
+#define _priq_run_remove	z_priq_hybrid_remove
+#define _priq_run_best		z_priq_hybrid_best
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -109,6 +113,15 @@ int32_t z_sched_prio_cmp(struct k_thread *thread_1,
 	 * leverage that to compare the values without having to check
 	 * the current time.
 	 */
+#ifdef CONFIG_SCHED_HYBRID
+	/* The hybrid run queue keeps deadline threads ahead of the
+	 * FIFO ones within a priority, so order them the same way here.
+	 */
+	if (thread_1->base.has_deadline != thread_2->base.has_deadline) {
+		return thread_1->base.has_deadline ? 1 : -1;
+	}
+#endif
+
 	uint32_t d1 = thread_1->base.prio_deadline;
 	uint32_t d2 = thread_2->base.prio_deadline;
 
@@ -1261,6 +1274,182 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 	return thread;
 }
 
+#ifdef CONFIG_SCHED_HYBRID
+# if (K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO) > 31
+# error Too many priorities for hybrid scheduler (max 32)
+# endif
+
+static inline struct k_thread *heap_thread(struct _priq_heap_node *n)
+{
+	return CONTAINER_OF(n, struct k_thread, base.qnode_heap);
+}
+
+static bool heap_lessthan(struct _priq_heap_node *a, struct _priq_heap_node *b)
+{
+	struct k_thread *thread_a = heap_thread(a);
+	struct k_thread *thread_b = heap_thread(b);
+	uint32_t d1 = thread_a->base.prio_deadline;
+	uint32_t d2 = thread_b->base.prio_deadline;
+
+	/* Same modular comparison as z_sched_prio_cmp(), and the
+	 * order keys are compared the same way so that wraparound of
+	 * the counter needs no renumbering.
+	 */
+	if (d1 != d2) {
+		return (int32_t)(d1 - d2) < 0;
+	}
+	return (int32_t)(thread_a->base.order_key - thread_b->base.order_key) < 0;
+}
+
+/* Links two detached heaps, the loser becomes the leftmost child */
+static struct _priq_heap_node *heap_meld(struct _priq_heap_node *a,
+					 struct _priq_heap_node *b)
+{
+	if (heap_lessthan(b, a)) {
+		struct _priq_heap_node *t = a;
+
+		a = b;
+		b = t;
+	}
+
+	b->prev = a;
+	b->next = a->child;
+	if (b->next != NULL) {
+		b->next->prev = b;
+	}
+	a->child = b;
+	a->next = NULL;
+	a->prev = NULL;
+
+	return a;
+}
+
+/* Standard two pass pairing of a sibling list: meld pairs left to
+ * right, then fold the results right to left.  The first pass builds
+ * its output list in reverse so the second one can walk it forward.
+ */
+static struct _priq_heap_node *heap_merge_pairs(struct _priq_heap_node *n)
+{
+	struct _priq_heap_node *pairs = NULL, *root, *next;
+
+	while (n != NULL) {
+		struct _priq_heap_node *a = n, *b = n->next;
+
+		if (b == NULL) {
+			next = NULL;
+		} else {
+			next = b->next;
+			a = heap_meld(a, b);
+		}
+		a->next = pairs;
+		pairs = a;
+		n = next;
+	}
+
+	root = pairs;
+	if (root != NULL) {
+		pairs = root->next;
+		root->next = NULL;
+		root->prev = NULL;
+	}
+	while (pairs != NULL) {
+		next = pairs->next;
+		root = heap_meld(root, pairs);
+		pairs = next;
+	}
+
+	return root;
+}
+
+static void heap_remove(struct _priq_heap_node **root,
+			struct _priq_heap_node *n)
+{
+	struct _priq_heap_node *sub = NULL;
+
+	if (n->child != NULL) {
+		sub = heap_merge_pairs(n->child);
+		n->child = NULL;
+	}
+
+	if (n == *root) {
+		*root = sub;
+		return;
+	}
+
+	if (n->prev->child == n) {
+		n->prev->child = n->next;
+	} else {
+		n->prev->next = n->next;
+	}
+	if (n->next != NULL) {
+		n->next->prev = n->prev;
+	}
+
+	if (sub != NULL) {
+		*root = heap_meld(*root, sub);
+	}
+}
+
+void z_priq_hybrid_add(struct _priq_hybrid *pq, struct k_thread *thread)
+{
+	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+	if (thread->base.has_deadline) {
+		struct _priq_heap_node *n = &thread->base.qnode_heap;
+
+		thread->base.order_key = pq->next_order_key++;
+		n->child = NULL;
+		n->next = NULL;
+		n->prev = NULL;
+		if (pq->heaps[priority_bit] == NULL) {
+			pq->heaps[priority_bit] = n;
+		} else {
+			pq->heaps[priority_bit] = heap_meld(pq->heaps[priority_bit], n);
+		}
+	} else {
+		sys_dlist_append(&pq->queues[priority_bit],
+				 &thread->base.qnode_dlist);
+	}
+	pq->bitmask |= BIT(priority_bit);
+}
+
+void z_priq_hybrid_remove(struct _priq_hybrid *pq, struct k_thread *thread)
+{
+	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+	if (thread->base.has_deadline) {
+		heap_remove(&pq->heaps[priority_bit], &thread->base.qnode_heap);
+	} else {
+		sys_dlist_remove(&thread->base.qnode_dlist);
+	}
+	if (pq->heaps[priority_bit] == NULL &&
+	    sys_dlist_is_empty(&pq->queues[priority_bit])) {
+		pq->bitmask &= ~BIT(priority_bit);
+	}
+}
+
+struct k_thread *z_priq_hybrid_best(struct _priq_hybrid *pq)
+{
+	if (!pq->bitmask) {
+		return NULL;
+	}
+
+	int priority_bit = __builtin_ctz(pq->bitmask);
+	sys_dnode_t *n;
+
+	if (pq->heaps[priority_bit] != NULL) {
+		return heap_thread(pq->heaps[priority_bit]);
+	}
+
+	n = sys_dlist_peek_head(&pq->queues[priority_bit]);
+	return n != NULL ? CONTAINER_OF(n, struct k_thread, base.qnode_dlist) : NULL;
+}
+#endif
+
 int z_unpend_all(_wait_q_t *wait_q)
 {
 	int need_sched = 0;
@@ -1287,6 +1476,11 @@ void init_ready_q(struct _ready_q *rq)
 	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
 		sys_dlist_init(&rq->runq.queues[i]);
 	}
+#elif defined(CONFIG_SCHED_HYBRID)
+	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+		rq->runq.heaps[i] = NULL;
+	}
 #else
 	sys_dlist_init(&rq->runq);
 #endif
@@ -1359,9 +1553,19 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	struct k_thread *thread = tid;
 
 	LOCKED(&sched_spinlock) {
-		thread->base.prio_deadline = k_cycle_get_32() + deadline;
-		if (z_is_thread_queued(thread)) {
+		bool queued = z_is_thread_queued(thread);
+
+		/* The deadline is the sort key in the ordered run
+		 * queues, so don't change it while the thread is in one.
+		 */
+		if (queued) {
 			dequeue_thread(thread);
+		}
+		thread->base.prio_deadline = k_cycle_get_32() + deadline;
+#ifdef CONFIG_SCHED_HYBRID
+		thread->base.has_deadline = 1U;
+#endif
+		if (queued) {
 			queue_thread(thread);
 		}
 	}
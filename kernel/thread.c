@@ -623,6 +623,9 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #endif
 #ifdef CONFIG_SCHED_DEADLINE
 	new_thread->base.prio_deadline = 0;
+#endif
+#ifdef CONFIG_SCHED_HYBRID
+	new_thread->base.has_deadline = 0U;
 #endif
 	new_thread->resource_pool = _current->resource_pool;
 
@@ -157,6 +157,50 @@ mismatch:
 	return false;
 }
 
+/*
+ * Find the next bit that is set (or cleared) at or after a given offset.
+ *
+ * Whole bundles are skipped at once, so this costs one iteration per
+ * bundle instead of one per bit.
+ *
+ * @param bitarray Bitarray struct
+ * @param offset   Bit location to start searching from
+ * @param limit    Bit location at which to stop searching,
+ *                 must not exceed the number of bits in the array.
+ * @param set      True to look for a set bit,
+ *                 False to look for a cleared bit.
+ *
+ * @return Offset of the matching bit, or @p limit if there
+ *         is none before it.
+ */
+static size_t find_next_bit(sys_bitarray_t *bitarray, size_t offset,
+			    size_t limit, bool set)
+{
+	size_t idx = offset / bundle_bitness(bitarray);
+	size_t last = (limit + bundle_bitness(bitarray) - 1) /
+		      bundle_bitness(bitarray);
+	uint32_t bundle;
+
+	if (offset >= limit) {
+		return limit;
+	}
+
+	bundle = set ? bitarray->bundles[idx] : ~bitarray->bundles[idx];
+	bundle &= ~(BIT(offset % bundle_bitness(bitarray)) - 1);
+
+	while (bundle == 0U) {
+		if (++idx >= last) {
+			return limit;
+		}
+
+		bundle = set ? bitarray->bundles[idx] : ~bitarray->bundles[idx];
+	}
+
+	offset = idx * bundle_bitness(bitarray) + find_lsb_set(bundle) - 1;
+
+	return MIN(offset, limit);
+}
+
 /*
  * Set or clear a region of bits.
  *
@@ -385,11 +429,8 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		       size_t *offset)
 {
 	k_spinlock_key_t key;
-	uint32_t bit_idx;
+	size_t bit_idx, run_end, off_end;
 	int ret;
-	struct bundle_data bd;
-	size_t off_start, off_end;
-	size_t mismatch;
 
 	__ASSERT_NO_MSG(bitarray != NULL);
 	__ASSERT_NO_MSG(bitarray->num_bits > 0);
@@ -406,46 +447,25 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		goto out;
 	}
 
-	bit_idx = 0;
-
-	/* Find the first non-allocated bit by looking at bundles
-	 * instead of individual bits.
-	 *
-	 * On RISC-V 64-bit, it complains about undefined reference to `ffs`.
-	 * So don't use this on RISCV64.
+	/* Walk the runs of free bits a bundle at a time: skip to the next
+	 * clear bit, then look for the set bit ending the free run. Both
+	 * searches only move forward, so the whole array is scanned at most
+	 * once regardless of how fragmented it is.
 	 */
-	for (ret = 0; ret < bitarray->num_bundles; ret++) {
-		if (~bitarray->bundles[ret] == 0U) {
-			/* bundle is all 1s => all allocated, skip */
-			bit_idx += bundle_bitness(bitarray);
-			continue;
-		}
-
-		if (bitarray->bundles[ret] != 0U) {
-			/* Find the first free bit in bundle if not all free */
-			off_start = find_lsb_set(~bitarray->bundles[ret]) - 1;
-			bit_idx += off_start;
-		}
-
-		break;
-	}
-
 	off_end = bitarray->num_bits - num_bits;
+	bit_idx = find_next_bit(bitarray, 0, bitarray->num_bits, false);
 	ret = -ENOSPC;
 	while (bit_idx <= off_end) {
-		if (match_region(bitarray, bit_idx, num_bits, false,
-				 &bd, &mismatch)) {
-			set_region(bitarray, bit_idx, num_bits, true, &bd);
+		run_end = find_next_bit(bitarray, bit_idx, bit_idx + num_bits, true);
+		if ((run_end - bit_idx) == num_bits) {
+			set_region(bitarray, bit_idx, num_bits, true, NULL);
 
 			*offset = bit_idx;
 			ret = 0;
 			break;
 		}
 
-		/* Fast-forward to the bit just after
-		 * the mismatched bit.
-		 */
-		bit_idx = mismatch + 1;
+		bit_idx = find_next_bit(bitarray, run_end, bitarray->num_bits, false);
 	}
 
 out:
@@ -150,6 +150,22 @@ bool sys_heap_validate(struct sys_heap *heap)
 		}
 	}
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	/* Same for the large chunks, which also must be sorted right */
+	struct rbnode *n;
+
+	RB_FOR_EACH(&h->large_chunks, n) {
+		c = large_chunk_id(h, n);
+		if (!valid_chunk(h, c) || !large_chunk(h, chunk_size(h, c))) {
+			return false;
+		}
+		if (large_chunk_node(h, c)->size != chunk_size(h, c)) {
+			return false;
+		}
+		set_chunk_used(h, c, true);
+	}
+#endif
+
 	/*
 	 * Walk through the chunks linearly again, verifying that all chunks
 	 * but solo headers are now USED (i.e. all free blocks were found
@@ -192,6 +208,16 @@ bool sys_heap_validate(struct sys_heap *heap)
 		}
 	}
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	RB_FOR_EACH(&h->large_chunks, n) {
+		c = large_chunk_id(h, n);
+		if (chunk_used(h, c)) {
+			return false;
+		}
+		set_chunk_used(h, c, true);
+	}
+#endif
+
 	/* Now we are valid, but have managed to invert all the in-use
 	 * fields.  One more linear pass to fix them up
 	 */
@@ -379,6 +405,22 @@ void heap_print_info(struct z_heap *h, bool dump_chunks)
 		}
 	}
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	struct rbnode *n;
+	chunksz_t largest = 0;
+	int count = 0;
+
+	RB_FOR_EACH(&h->large_chunks, n) {
+		count++;
+		largest = MAX(largest, chunk_size(h, large_chunk_id(h, n)));
+	}
+	if (count) {
+		printk("%9s %12d %12d %12d %12zd\n",
+		       "tree", LARGE_CHUNK_UNITS, count,
+		       largest, chunksz_to_bytes(h, largest));
+	}
+#endif
+
 	if (dump_chunks) {
 		printk("\nChunk dump:\n");
 		for (chunkid_t c = 0; ; c = right_chunk(h, c)) {
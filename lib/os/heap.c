@@ -6,6 +6,7 @@
 #include <zephyr/sys/sys_heap.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/heap_listener.h>
+#include <zephyr/sys/heap_profiler.h>
 #include <zephyr/kernel.h>
 #include <string.h>
 #include "heap.h"
@@ -57,8 +58,95 @@ static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 #endif
 }
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+static bool large_chunk_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	struct z_heap_large_chunk *la = CONTAINER_OF(a, struct z_heap_large_chunk, node);
+	struct z_heap_large_chunk *lb = CONTAINER_OF(b, struct z_heap_large_chunk, node);
+
+	if (la->size != lb->size) {
+		return la->size < lb->size;
+	}
+
+	return (uintptr_t)a < (uintptr_t)b;
+}
+
+static void large_chunk_add(struct z_heap *h, chunkid_t c)
+{
+	struct z_heap_large_chunk *lc = large_chunk_node(h, c);
+
+	/* The free list links are unused, keep them pointing to the
+	 * chunk itself so they remain valid for heap validation.
+	 */
+	set_prev_free_chunk(h, c, c);
+	set_next_free_chunk(h, c, c);
+
+	lc->size = chunk_size(h, c);
+	rb_insert(&h->large_chunks, &lc->node);
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->free_bytes += chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+}
+
+static void large_chunk_remove(struct z_heap *h, chunkid_t c)
+{
+	CHECK(!chunk_used(h, c));
+	CHECK(large_chunk_node(h, c)->size == chunk_size(h, c));
+
+	rb_remove(&h->large_chunks, &large_chunk_node(h, c)->node);
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->free_bytes -= chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+}
+
+/* Best fit: the smallest (then lowest) large free chunk of at least sz
+ * units, or 0 if there is none.
+ */
+static chunkid_t large_chunk_find(struct z_heap *h, chunksz_t sz)
+{
+	struct rbnode *n = h->large_chunks.root, *best = NULL;
+
+	while (n != NULL) {
+		if (CONTAINER_OF(n, struct z_heap_large_chunk, node)->size >= sz) {
+			best = n;
+			n = z_rb_child(n, 0U);
+		} else {
+			n = z_rb_child(n, 1U);
+		}
+	}
+
+	return (best != NULL) ? large_chunk_id(h, best) : 0;
+}
+
+/* The large free chunk following c in tree order, or 0 if c is last */
+static chunkid_t large_chunk_next(struct z_heap *h, chunkid_t c)
+{
+	struct rbnode *key = &large_chunk_node(h, c)->node;
+	struct rbnode *n = h->large_chunks.root, *best = NULL;
+
+	while (n != NULL) {
+		if (large_chunk_lessthan(key, n)) {
+			best = n;
+			n = z_rb_child(n, 0U);
+		} else {
+			n = z_rb_child(n, 1U);
+		}
+	}
+
+	return (best != NULL) ? large_chunk_id(h, best) : 0;
+}
+#endif /* CONFIG_SYS_HEAP_LARGE_CHUNK_TREE */
+
 static void free_list_remove(struct z_heap *h, chunkid_t c)
 {
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	if (large_chunk(h, chunk_size(h, c))) {
+		large_chunk_remove(h, c);
+		return;
+	}
+#endif
 	if (!solo_free_header(h, c)) {
 		int bidx = bucket_idx(h, chunk_size(h, c));
 		free_list_remove_bidx(h, c, bidx);
@@ -97,6 +185,12 @@ static void free_list_add_bidx(struct z_heap *h, chunkid_t c, int bidx)
 
 static void free_list_add(struct z_heap *h, chunkid_t c)
 {
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	if (large_chunk(h, chunk_size(h, c))) {
+		large_chunk_add(h, c);
+		return;
+	}
+#endif
 	if (!solo_free_header(h, c)) {
 		int bidx = bucket_idx(h, chunk_size(h, c));
 		free_list_add_bidx(h, c, bidx);
@@ -160,7 +254,7 @@ static chunkid_t mem_to_chunkid(struct z_heap *h, void *p)
 	return (mem - chunk_header_bytes(h) - base) / CHUNK_UNIT;
 }
 
-void sys_heap_free(struct sys_heap *heap, void *mem)
+static void heap_free(struct sys_heap *heap, void *mem)
 {
 	if (mem == NULL) {
 		return; /* ISO C free() semantics */
@@ -197,6 +291,15 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 	free_chunk(h, c);
 }
 
+void sys_heap_free(struct sys_heap *heap, void *mem)
+{
+#ifdef CONFIG_HEAP_PROFILER
+	heap_profiler_free(mem);
+#endif
+
+	heap_free(heap, mem);
+}
+
 size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
 {
 	struct z_heap *h = heap->heap;
@@ -210,6 +313,17 @@ size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
 
 static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 {
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	if (large_chunk(h, sz)) {
+		chunkid_t c = large_chunk_find(h, sz);
+
+		if (c != 0U) {
+			large_chunk_remove(h, c);
+		}
+		return c;
+	}
+#endif
+
 	int bi = bucket_idx(h, sz);
 	struct z_heap_bucket *b = &h->buckets[bi];
 
@@ -257,10 +371,51 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 		return c;
 	}
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	/* No bucket can satisfy the request, any large chunk will do */
+	struct rbnode *n = rb_get_min(&h->large_chunks);
+
+	if (n != NULL) {
+		chunkid_t c = large_chunk_id(h, n);
+
+		large_chunk_remove(h, c);
+		return c;
+	}
+#endif
+
 	return 0;
 }
 
-void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+/*
+ * Look for a large free chunk that can hold the aligned allocation
+ * without the worst case alignment padding, starting from the best fit
+ * for the unpadded size. Bounded like the bucket search in alloc_chunk()
+ * so the caller falls back to a padded allocation quickly.
+ */
+static chunkid_t alloc_aligned_large_chunk(struct z_heap *h, size_t align,
+					   size_t rew, size_t bytes)
+{
+	chunkid_t c = large_chunk_find(h, bytes_to_chunksz(h, bytes));
+
+	for (int i = CONFIG_SYS_HEAP_ALLOC_LOOPS; c != 0U && i > 0; i--) {
+		uint8_t *mem = chunk_mem(h, c);
+
+		mem = (uint8_t *) ROUND_UP(mem + rew, align) - rew;
+		if ((chunk_unit_t *) ROUND_UP(mem + bytes, CHUNK_UNIT) <=
+		    &chunk_buf(h)[right_chunk(h, c)]) {
+			large_chunk_remove(h, c);
+			return c;
+		}
+
+		c = large_chunk_next(h, c);
+	}
+
+	return 0;
+}
+#endif
+
+static void *heap_alloc(struct sys_heap *heap, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 	void *mem;
@@ -298,7 +453,8 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	return mem;
 }
 
-void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+static void *heap_aligned_alloc(struct sys_heap *heap, size_t align,
+				size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 	size_t gap, rew;
@@ -316,7 +472,7 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 		gap = MIN(rew, chunk_header_bytes(h));
 	} else {
 		if (align <= chunk_header_bytes(h)) {
-			return sys_heap_alloc(heap, bytes);
+			return heap_alloc(heap, bytes);
 		}
 		rew = 0;
 		gap = chunk_header_bytes(h);
@@ -333,7 +489,16 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	 * the extra allocations afterwards.
 	 */
 	chunksz_t padded_sz = bytes_to_chunksz(h, bytes + align - gap);
-	chunkid_t c0 = alloc_chunk(h, padded_sz);
+	chunkid_t c0 = 0;
+
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	if (large_chunk(h, padded_sz)) {
+		c0 = alloc_aligned_large_chunk(h, align, rew, bytes);
+	}
+#endif
+	if (c0 == 0) {
+		c0 = alloc_chunk(h, padded_sz);
+	}
 
 	if (c0 == 0) {
 		return NULL;
@@ -347,7 +512,7 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	/* Get corresponding chunks */
 	chunkid_t c = mem_to_chunkid(h, mem);
 	chunkid_t c_end = end - chunk_buf(h);
-	CHECK(c >= c0 && c  < c_end && c_end <= c0 + padded_sz);
+	CHECK(c >= c0 && c  < c_end && c_end <= right_chunk(h, c0));
 
 	/* Split and free unused prefix */
 	if (c > c0) {
@@ -376,17 +541,17 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	return mem;
 }
 
-void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
-			       size_t align, size_t bytes)
+static void *heap_aligned_realloc(struct sys_heap *heap, void *ptr,
+				  size_t align, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 
 	/* special realloc semantics */
 	if (ptr == NULL) {
-		return sys_heap_aligned_alloc(heap, align, bytes);
+		return heap_aligned_alloc(heap, align, bytes);
 	}
 	if (bytes == 0) {
-		sys_heap_free(heap, ptr);
+		heap_free(heap, ptr);
 		return NULL;
 	}
 
@@ -471,18 +636,92 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 	 * The calls to allocation and free functions generate
 	 * notification already, so there is no need to those here.
 	 */
-	void *ptr2 = sys_heap_aligned_alloc(heap, align, bytes);
+	void *ptr2 = heap_aligned_alloc(heap, align, bytes);
 
 	if (ptr2 != NULL) {
 		size_t prev_size = chunksz_to_bytes(h, chunk_size(h, c)) - align_gap;
 
 		memcpy(ptr2, ptr, MIN(prev_size, bytes));
-		sys_heap_free(heap, ptr);
+		heap_free(heap, ptr);
 	}
 	return ptr2;
 }
 
-void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
+#ifdef CONFIG_HEAP_PROFILER
+/* The profiler charges a block with its whole chunk */
+static size_t profiled_bytes(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+
+	return chunksz_to_bytes(h, chunk_size(h, mem_to_chunkid(h, mem)));
+}
+#endif
+
+/* The public allocation functions record the block with the profiler
+ * once, on the way out, so the profiler lock is taken a single time
+ * whichever internal path the allocation went through.
+ */
+void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+{
+	void *mem = heap_alloc(heap, bytes);
+
+#ifdef CONFIG_HEAP_PROFILER
+	if (mem != NULL) {
+		heap_profiler_alloc(mem, profiled_bytes(heap, mem),
+				    HEAP_PROFILER_CALL_SITE());
+	}
+#endif
+
+	return mem;
+}
+
+void *z_sys_heap_aligned_alloc_site(struct sys_heap *heap, size_t align,
+				    size_t bytes, void *site)
+{
+	void *mem = heap_aligned_alloc(heap, align, bytes);
+
+#ifdef CONFIG_HEAP_PROFILER
+	if (mem != NULL) {
+		heap_profiler_alloc(mem, profiled_bytes(heap, mem), site);
+	}
+#else
+	ARG_UNUSED(site);
+#endif
+
+	return mem;
+}
+
+void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+{
+	return z_sys_heap_aligned_alloc_site(heap, align, bytes,
+					     HEAP_PROFILER_CALL_SITE());
+}
+
+void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
+			       size_t align, size_t bytes)
+{
+	void *mem = heap_aligned_realloc(heap, ptr, align, bytes);
+
+#ifdef CONFIG_HEAP_PROFILER
+	/* Nothing changed if a reallocation failed */
+	if (mem != NULL || bytes == 0U) {
+		heap_profiler_realloc(ptr, mem,
+				      mem != NULL ? profiled_bytes(heap, mem) : 0,
+				      HEAP_PROFILER_CALL_SITE());
+	}
+#endif
+
+	return mem;
+}
+
+/* Z_HEAP_MIN_SIZE in kernel.h is worked out from this header size, and
+ * for few enough chunks that a minimal heap has at most 4 buckets.
+ */
+BUILD_ASSERT(sizeof(struct z_heap) == Z_HEAP_HDR_SIZE);
+BUILD_ASSERT(Z_HEAP_MIN_SIZE / CHUNK_UNIT < 16);
+
+static void heap_init(struct sys_heap *heap, void *mem, size_t bytes,
+		      bool large_chunk_tree)
 {
 	IF_ENABLED(CONFIG_MSAN, (__sanitizer_dtor_callback(mem, bytes)));
 
@@ -527,6 +766,14 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 		h->buckets[i].next = 0;
 	}
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	h->large_chunks = (struct rbtree) {
+		.lessthan_fn = large_chunk_tree ? large_chunk_lessthan : NULL,
+	};
+#else
+	ARG_UNUSED(large_chunk_tree);
+#endif
+
 	/* chunk containing our struct z_heap */
 	set_chunk_size(h, 0, chunk0_size);
 	set_left_chunk_size(h, 0, 0);
@@ -543,3 +790,16 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	free_list_add(h, chunk0_size);
 }
+
+void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
+{
+	heap_init(heap, mem, bytes, false);
+}
+
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+void sys_heap_init_large_chunk_tree(struct sys_heap *heap, void *mem,
+				    size_t bytes)
+{
+	heap_init(heap, mem, bytes, true);
+}
+#endif
@@ -65,6 +65,23 @@ struct z_heap_bucket {
 	chunkid_t next;
 };
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+/* In heaps set up with sys_heap_init_large_chunk_tree(), free chunks
+ * of at least this many units are not kept in the bucket free lists
+ * but in a red/black tree sorted by size, then address.
+ * The tree node lives in the chunk body, right past the (big) chunk
+ * header fields, and carries a copy of the chunk size so that the
+ * tree comparison doesn't need to know the header format.
+ */
+#define LARGE_CHUNK_UNITS (CONFIG_SYS_HEAP_LARGE_CHUNK_SIZE / CHUNK_UNIT)
+#define LARGE_CHUNK_NODE_OFFSET 2U
+
+struct z_heap_large_chunk {
+	struct rbnode node;
+	chunksz_t size;
+};
+#endif
+
 struct z_heap {
 	chunkid_t chunk0_hdr[2];
 	chunkid_t end_chunk;
@@ -73,6 +90,9 @@ struct z_heap {
 	size_t free_bytes;
 	size_t allocated_bytes;
 	size_t max_allocated_bytes;
+#endif
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	struct rbtree large_chunks;
 #endif
 	struct z_heap_bucket buckets[0];
 };
@@ -262,6 +282,27 @@ static inline bool size_too_big(struct z_heap *h, size_t bytes)
 	return (bytes / CHUNK_UNIT) >= h->end_chunk;
 }
 
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+/* Only heaps set up with sys_heap_init_large_chunk_tree() have a tree
+ * comparison function, the others keep all free chunks in the buckets.
+ */
+static inline bool large_chunk(struct z_heap *h, chunksz_t sz)
+{
+	return h->large_chunks.lessthan_fn != NULL && sz >= LARGE_CHUNK_UNITS;
+}
+
+static inline struct z_heap_large_chunk *large_chunk_node(struct z_heap *h,
+							   chunkid_t c)
+{
+	return (struct z_heap_large_chunk *)&chunk_buf(h)[c + LARGE_CHUNK_NODE_OFFSET];
+}
+
+static inline chunkid_t large_chunk_id(struct z_heap *h, struct rbnode *n)
+{
+	return (chunk_unit_t *)n - chunk_buf(h) - LARGE_CHUNK_NODE_OFFSET;
+}
+#endif
+
 /* For debugging */
 void heap_print_info(struct z_heap *h, bool dump_chunks);
 
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/heap_profiler.h>
+#include <zephyr/sys/util.h>
+
+#define NUM_SITES  CONFIG_HEAP_PROFILER_MAX_SITES
+#define NUM_ALLOCS CONFIG_HEAP_PROFILER_MAX_ALLOCS
+
+#define SITE_NONE UINT16_MAX
+
+BUILD_ASSERT(NUM_SITES < SITE_NONE, "too many heap profiler call sites");
+
+/* Live allocation, needed to find the size and the site on free */
+struct heap_profiler_alloc {
+	void *mem;
+	size_t bytes;
+	uint16_t site;
+};
+
+/* Both tables are open addressing hash tables with linear probing,
+ * keyed by pointer. A NULL key marks an empty slot.
+ */
+static struct heap_profiler_site sites[NUM_SITES];
+static struct heap_profiler_alloc allocs[NUM_ALLOCS];
+static uint32_t num_allocs;
+static uint32_t dropped;
+static struct k_spinlock lock;
+
+static inline uint32_t slot_of(const void *ptr, uint32_t size)
+{
+	/* Fibonacci hashing, low bits are mostly alignment */
+	return (uint32_t)(((uintptr_t)ptr >> 2) * 2654435761UL) % size;
+}
+
+static uint16_t site_get(void *site)
+{
+	uint32_t i = slot_of(site, NUM_SITES);
+
+	for (uint32_t n = 0; n < NUM_SITES; n++) {
+		if (sites[i].site == site) {
+			return i;
+		}
+		if (sites[i].site == NULL) {
+			sites[i].site = site;
+			return i;
+		}
+		i = (i + 1) % NUM_SITES;
+	}
+
+	return SITE_NONE;
+}
+
+static struct heap_profiler_alloc *alloc_find(void *mem)
+{
+	uint32_t i = slot_of(mem, NUM_ALLOCS);
+
+	for (uint32_t n = 0; n < NUM_ALLOCS; n++) {
+		if (allocs[i].mem == mem) {
+			return &allocs[i];
+		}
+		if (allocs[i].mem == NULL) {
+			break;
+		}
+		i = (i + 1) % NUM_ALLOCS;
+	}
+
+	return NULL;
+}
+
+/* One slot is always left empty, which ends every probe sequence */
+static struct heap_profiler_alloc *alloc_insert(void *mem)
+{
+	uint32_t i = slot_of(mem, NUM_ALLOCS);
+
+	for (uint32_t n = 0; n < NUM_ALLOCS; n++) {
+		if (allocs[i].mem == mem) {
+			return &allocs[i];
+		}
+		if (allocs[i].mem == NULL) {
+			if (num_allocs == NUM_ALLOCS - 1U) {
+				break;
+			}
+			num_allocs++;
+			allocs[i].mem = mem;
+			return &allocs[i];
+		}
+		i = (i + 1) % NUM_ALLOCS;
+	}
+
+	return NULL;
+}
+
+/* Is slot k within the cyclic range (i, j]? */
+static inline bool slot_between(uint32_t k, uint32_t i, uint32_t j)
+{
+	return (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+}
+
+/* Remove an entry, shifting back the following entries of its probe
+ * sequence so that no tombstones are needed.
+ */
+static void alloc_remove(struct heap_profiler_alloc *a)
+{
+	uint32_t i = a - allocs;
+	uint32_t j = i;
+
+	while (true) {
+		j = (j + 1) % NUM_ALLOCS;
+		if (allocs[j].mem == NULL) {
+			break;
+		}
+		if (!slot_between(slot_of(allocs[j].mem, NUM_ALLOCS), i, j)) {
+			allocs[i] = allocs[j];
+			i = j;
+		}
+	}
+
+	allocs[i].mem = NULL;
+	num_allocs--;
+}
+
+static void site_add(uint16_t s, size_t bytes)
+{
+	sites[s].live_bytes += bytes;
+	sites[s].peak_bytes = MAX(sites[s].peak_bytes, sites[s].live_bytes);
+	sites[s].allocs++;
+}
+
+/* Both called with the lock held */
+static void record(void *mem, size_t bytes, void *site)
+{
+	struct heap_profiler_alloc *a;
+	uint16_t s;
+
+	s = site_get(site);
+	a = (s != SITE_NONE) ? alloc_insert(mem) : NULL;
+	if (a == NULL) {
+		dropped++;
+	} else {
+		a->bytes = bytes;
+		a->site = s;
+		site_add(s, bytes);
+	}
+}
+
+static void forget(void *mem)
+{
+	struct heap_profiler_alloc *a = alloc_find(mem);
+
+	if (a != NULL) {
+		sites[a->site].live_bytes -= a->bytes;
+		sites[a->site].frees++;
+		alloc_remove(a);
+	}
+}
+
+void heap_profiler_alloc(void *mem, size_t bytes, void *site)
+{
+	k_spinlock_key_t key;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	record(mem, bytes, site);
+	k_spin_unlock(&lock, key);
+}
+
+void heap_profiler_free(void *mem)
+{
+	k_spinlock_key_t key;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	forget(mem);
+	k_spin_unlock(&lock, key);
+}
+
+void heap_profiler_realloc(void *old, void *mem, size_t bytes, void *site)
+{
+	k_spinlock_key_t key;
+
+	if (old == NULL && mem == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (old != NULL) {
+		forget(old);
+	}
+	if (mem != NULL) {
+		record(mem, bytes, site);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void heap_profiler_foreach_site(heap_profiler_site_cb_t cb, void *user_data)
+{
+	struct heap_profiler_site site;
+	k_spinlock_key_t key;
+
+	for (uint32_t i = 0; i < NUM_SITES; i++) {
+		key = k_spin_lock(&lock);
+		site = sites[i];
+		k_spin_unlock(&lock, key);
+
+		if (site.site != NULL && site.allocs != 0U) {
+			cb(&site, user_data);
+		}
+	}
+}
+
+void heap_profiler_reset_peak(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (uint32_t i = 0; i < NUM_SITES; i++) {
+		sites[i].peak_bytes = sites[i].live_bytes;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+uint32_t heap_profiler_dropped_get(void)
+{
+	return dropped;
+}
+
+#ifdef CONFIG_HEAP_PROFILER_SHELL
+#include <zephyr/shell/shell.h>
+
+static void shell_print_site(const struct heap_profiler_site *site,
+			     void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	shell_print(sh, "%-18p %10zu %10zu %10u %10u", site->site,
+		    site->live_bytes, site->peak_bytes, site->allocs,
+		    site->frees);
+}
+
+static int cmd_heap_profiler_show(const struct shell *sh, size_t argc,
+				  char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(sh, "%-18s %10s %10s %10s %10s", "call site", "live",
+		    "peak", "allocs", "frees");
+	heap_profiler_foreach_site(shell_print_site, (void *)sh);
+	shell_print(sh, "dropped: %u", heap_profiler_dropped_get());
+
+	return 0;
+}
+
+static int cmd_heap_profiler_reset(const struct shell *sh, size_t argc,
+				   char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	heap_profiler_reset_peak();
+	shell_print(sh, "peaks reset");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_heap_profiler,
+	SHELL_CMD(show, NULL, "Show allocations per call site",
+		  cmd_heap_profiler_show),
+	SHELL_CMD(reset, NULL, "Reset peak usage of all call sites",
+		  cmd_heap_profiler_reset),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(heap_profiler, &sub_heap_profiler,
+		   "Heap allocation profiler", NULL);
+#endif /* CONFIG_HEAP_PROFILER_SHELL */
@@ -10,6 +10,7 @@
 #include <sys/types.h>
 #include <zephyr/toolchain.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
 
 #include <zephyr/kernel.h>
 
@@ -1742,6 +1743,8 @@ static isoal_status_t isoal_tx_unframed_produce(struct isoal_source *source,
 /**
  * @brief  Inserts a segmentation header at the current write point in the PDU
  *         under production.
+ * @details The header is built in place in the PDU, where it is updated as
+ *          SDU data is written after it.
  * @param  source              source handle
  * @param  sc                  start / continuation bit value to be written
  * @param  cmplt               complete bit value to be written
@@ -1753,20 +1756,16 @@ static isoal_status_t isoal_insert_seg_header_timeoffset(struct isoal_source *so
 							 const bool cmplt,
 							 const uint32_t time_offset)
 {
-	struct isoal_source_session *session;
 	struct isoal_pdu_production *pp;
 	struct isoal_pdu_produced *pdu;
-	struct pdu_iso_sdu_sh seg_hdr;
-	isoal_status_t err;
+	struct pdu_iso_sdu_sh *seg_hdr;
+	uint8_t *seg_hdr_loc;
 	uint8_t write_size;
 
-	session    = &source->session;
 	pp         = &source->pdu_production;
 	pdu        = &pp->pdu;
 	write_size = PDU_ISO_SEG_HDR_SIZE + (sc ? 0 : PDU_ISO_SEG_TIMEOFFSET_SIZE);
 
-	memset(&seg_hdr, 0, sizeof(seg_hdr));
-
 	/* Check if there is enough space left in the PDU. This should not fail
 	 * as the calling should also check before requesting insertion of a
 	 * new header.
@@ -1776,31 +1775,26 @@ static isoal_status_t isoal_insert_seg_header_timeoffset(struct isoal_source *so
 		return ISOAL_STATUS_ERR_UNSPECIFIED;
 	}
 
-	seg_hdr.sc = sc;
-	seg_hdr.cmplt = cmplt;
-	seg_hdr.len = sc ? 0 : PDU_ISO_SEG_TIMEOFFSET_SIZE;
-
-	if (!sc) {
-		seg_hdr.timeoffset = time_offset;
-	}
-
-	/* Store header */
-	pp->seg_hdr_sc = seg_hdr.sc;
-	pp->seg_hdr_length = seg_hdr.len;
-
 	/* Save location of last segmentation header so that it can be updated
 	 * as data is written.
 	 */
 	pp->last_seg_hdr_loc = pp->pdu_written;
-	/* Write to PDU */
-	err = session->pdu_write(&pdu->contents,
-				  pp->pdu_written,
-				  (uint8_t *) &seg_hdr,
-				  write_size);
+	seg_hdr_loc = &pdu->contents.pdu->payload[pp->last_seg_hdr_loc];
+
+	seg_hdr = (struct pdu_iso_sdu_sh *)seg_hdr_loc;
+	seg_hdr->sc = sc;
+	seg_hdr->cmplt = cmplt;
+	seg_hdr->rfu = 0U;
+	seg_hdr->len = sc ? 0 : PDU_ISO_SEG_TIMEOFFSET_SIZE;
+
+	if (!sc) {
+		sys_put_le24(time_offset, &seg_hdr_loc[PDU_ISO_SEG_HDR_SIZE]);
+	}
+
 	pp->pdu_written   += write_size;
 	pp->pdu_available -= write_size;
 
-	return err;
+	return ISOAL_STATUS_OK;
 }
 
 /**
@@ -1814,29 +1808,24 @@ static isoal_status_t isoal_update_seg_header_cmplt_length(struct isoal_source *
 							   const bool cmplt,
 							   const uint8_t add_length)
 {
-	struct isoal_source_session *session;
 	struct isoal_pdu_production *pp;
 	struct isoal_pdu_produced *pdu;
-	struct pdu_iso_sdu_sh seg_hdr;
+	struct pdu_iso_sdu_sh *seg_hdr;
 
-	session    = &source->session;
 	pp         = &source->pdu_production;
 	pdu        = &pp->pdu;
-	memset(&seg_hdr, 0, sizeof(seg_hdr));
-
-	seg_hdr.sc = pp->seg_hdr_sc;
 
-	/* Update the complete flag and length */
-	seg_hdr.cmplt = cmplt;
-	pp->seg_hdr_length += add_length;
-	seg_hdr.len = pp->seg_hdr_length;
+	/* No header was inserted if the PDU could not be allocated */
+	if (!pdu->contents.pdu) {
+		return ISOAL_STATUS_ERR_UNSPECIFIED;
+	}
 
+	/* Update the complete flag and length in place */
+	seg_hdr = (struct pdu_iso_sdu_sh *)&pdu->contents.pdu->payload[pp->last_seg_hdr_loc];
+	seg_hdr->cmplt = cmplt;
+	seg_hdr->len += add_length;
 
-	/* Re-write the segmentation header at the same location */
-	return session->pdu_write(&pdu->contents,
-				  pp->last_seg_hdr_loc,
-				  (uint8_t *) &seg_hdr,
-				  PDU_ISO_SEG_HDR_SIZE);
+	return ISOAL_STATUS_OK;
 }
 
 /**
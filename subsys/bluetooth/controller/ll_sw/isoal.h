@@ -397,8 +397,6 @@ struct isoal_pdu_production {
 	/* PDUs produced for current SDU */
 	uint8_t                   pdu_cnt;
 	uint64_t                  payload_number:39;
-	uint64_t                  seg_hdr_sc:1;
-	uint64_t                  seg_hdr_length:8;
 	uint64_t                  sdu_fragments:8;
 	isoal_pdu_len_t           pdu_written;
 	isoal_pdu_len_t           pdu_available;
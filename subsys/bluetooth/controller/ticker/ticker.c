@@ -252,6 +252,15 @@ struct ticker_instance {
 	uint8_t  ticker_id_head;	/* Index of first ticker node (next to
 					 * expire)
 					 */
+#if !defined(CONFIG_BT_TICKER_LOW_LAT)
+	uint8_t  ticker_id_tail;	/* Index of last ticker node, or
+					 * TICKER_NULL if not known
+					 */
+	uint32_t ticks_to_tail;		/* Ticks until expiry of last ticker
+					 * node, i.e. sum of ticks_to_expire of
+					 * all nodes in the list
+					 */
+#endif /* !CONFIG_BT_TICKER_LOW_LAT */
 	uint8_t  job_guard;		/* Flag preventing ticker_worker from
 					 * running if ticker_job is active
 					 */
@@ -271,6 +280,11 @@ struct ticker_instance {
 					 */
 #endif /* !CONFIG_BT_TICKER_SLOT_AGNOSTIC */
 
+#if defined(CONFIG_BT_TICKER_EXT)
+	uint8_t  reschedule_pending;	/* Flag set by ticker_worker when a
+					 * node is marked for re-scheduling
+					 */
+#endif /* CONFIG_BT_TICKER_EXT */
 
 	ticker_caller_id_get_cb_t caller_id_get_cb; /* Function for retrieving
 						     * the caller id from user
@@ -498,6 +512,7 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	struct ticker_node *ticker_current;
 	struct ticker_node *ticker_new;
 	uint32_t ticks_to_expire_current;
+	uint32_t ticks_to_expire_total;
 	struct ticker_node *node;
 	uint32_t ticks_to_expire;
 	uint8_t previous;
@@ -506,6 +521,7 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	node = &instance->nodes[0];
 	ticker_new = &node[id];
 	ticks_to_expire = ticker_new->ticks_to_expire;
+	ticks_to_expire_total = ticks_to_expire;
 	current = instance->ticker_id_head;
 
 	/* Find insertion point for new ticker node and adjust ticks_to_expire
@@ -513,6 +529,16 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	 */
 	previous = TICKER_NULL;
 
+	/* Periodic nodes re-inserted after their expiry mostly go last in the
+	 * list, append these without walking the list.
+	 */
+	if ((instance->ticker_id_tail != TICKER_NULL) &&
+	    (ticks_to_expire > instance->ticks_to_tail)) {
+		ticks_to_expire -= instance->ticks_to_tail;
+		previous = instance->ticker_id_tail;
+		current = TICKER_NULL;
+	}
+
 	while ((current != TICKER_NULL) && (ticks_to_expire >=
 		(ticks_to_expire_current =
 		(ticker_current = &node[current])->ticks_to_expire))) {
@@ -545,6 +571,9 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 
 	if (current != TICKER_NULL) {
 		node[current].ticks_to_expire -= ticks_to_expire;
+	} else {
+		instance->ticker_id_tail = id;
+		instance->ticks_to_tail = ticks_to_expire_total;
 	}
 
 	return id;
@@ -701,6 +730,18 @@ static uint32_t ticker_dequeue(struct ticker_instance *instance, uint8_t id)
 		instance->ticker_id_head = ticker_current->next;
 	}
 
+#if !defined(CONFIG_BT_TICKER_LOW_LAT)
+	if (current == instance->ticker_id_tail) {
+		/* Ticker is the last in the list */
+		if (previous == current) {
+			instance->ticker_id_tail = TICKER_NULL;
+		} else {
+			instance->ticker_id_tail = previous;
+			instance->ticks_to_tail = total;
+		}
+	}
+#endif /* !CONFIG_BT_TICKER_LOW_LAT */
+
 	/* Remaining timeout between next timeout */
 	timeout = ticker_current->ticks_to_expire;
 
@@ -1013,6 +1054,7 @@ void ticker_worker(void *param)
 				/* Mark node for re-scheduling in ticker_job */
 				ext_data->reschedule_state =
 					TICKER_RESCHEDULE_STATE_PENDING;
+				instance->reschedule_pending = 1U;
 			} else if (ext_data) {
 				/* Mark node as not re-scheduling */
 				ext_data->reschedule_state =
@@ -1619,6 +1661,9 @@ static inline void ticker_job_worker_bh(struct ticker_instance *instance,
 		ticks_to_expire = ticker->ticks_to_expire;
 		if (ticks_elapsed < ticks_to_expire) {
 			ticker->ticks_to_expire -= ticks_elapsed;
+#if !defined(CONFIG_BT_TICKER_LOW_LAT)
+			instance->ticks_to_tail -= ticks_elapsed;
+#endif /* !CONFIG_BT_TICKER_LOW_LAT */
 			break;
 		}
 
@@ -1663,6 +1708,13 @@ static inline void ticker_job_worker_bh(struct ticker_instance *instance,
 		/* remove the expired ticker from head */
 		instance->ticker_id_head = ticker->next;
 
+#if !defined(CONFIG_BT_TICKER_LOW_LAT)
+		if (instance->ticker_id_tail == id_expired) {
+			instance->ticker_id_tail = TICKER_NULL;
+		}
+		instance->ticks_to_tail -= ticks_to_expire;
+#endif /* !CONFIG_BT_TICKER_LOW_LAT */
+
 		/* Ticker will be restarted if periodic or to be re-scheduled */
 		if ((ticker->ticks_periodic != 0U) ||
 		    TICKER_RESCHEDULE_PENDING(ticker)) {
@@ -1907,6 +1959,11 @@ static uint8_t ticker_job_reschedule_in_window(struct ticker_instance *instance,
 	uint8_t  rescheduling = 1U;
 	uint8_t  rescheduled = 0U;
 
+	/* Nothing to look for if no node was marked for re-scheduling */
+	if (!instance->reschedule_pending) {
+		return 0U;
+	}
+
 	nodes = &instance->nodes[0];
 
 	/* Do until all pending re-schedules handled */
@@ -1932,6 +1989,7 @@ static uint8_t ticker_job_reschedule_in_window(struct ticker_instance *instance,
 		}
 		if (ticker_id_head == TICKER_NULL) {
 			/* Done */
+			instance->reschedule_pending = 0U;
 			break;
 		}
 
@@ -2066,6 +2124,11 @@ static uint8_t ticker_job_reschedule_in_window(struct ticker_instance *instance,
 			nodes[ticker_id_prev].next = ticker_id_head;
 		}
 
+		/* The node may have moved behind the last node, find the last
+		 * node again when a node is next appended.
+		 */
+		instance->ticker_id_tail = TICKER_NULL;
+
 		/* Remove latency added in ticker_worker */
 		ticker->lazy_current--;
 
@@ -2746,6 +2809,9 @@ uint8_t ticker_init(uint8_t instance_index, uint8_t count_node, void *node,
 	instance->trigger_set_cb = trigger_set_cb;
 
 	instance->ticker_id_head = TICKER_NULL;
+#if !defined(CONFIG_BT_TICKER_LOW_LAT)
+	instance->ticker_id_tail = TICKER_NULL;
+#endif /* !CONFIG_BT_TICKER_LOW_LAT */
 	instance->ticks_current = cntr_cnt_get();
 	instance->ticks_elapsed_first = 0U;
 	instance->ticks_elapsed_last = 0U;
@@ -2755,6 +2821,10 @@ uint8_t ticker_init(uint8_t instance_index, uint8_t count_node, void *node,
 	instance->ticks_slot_previous = 0U;
 #endif /* !CONFIG_BT_TICKER_SLOT_AGNOSTIC */
 
+#if defined(CONFIG_BT_TICKER_EXT)
+	instance->reschedule_pending = 0U;
+#endif /* CONFIG_BT_TICKER_EXT */
+
 	return TICKER_STATUS_SUCCESS;
 }
 
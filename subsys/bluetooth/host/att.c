@@ -93,6 +93,13 @@ struct bt_att_chan {
 	struct k_fifo		tx_queue;
 	struct k_work_delayable	timeout_work;
 	sys_snode_t		node;
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+	/* Attributes of the PDU waiting to be sent and of the request
+	 * waiting for its response
+	 */
+	uint32_t		sent_key;
+	uint32_t		req_key;
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
 };
 
 /* ATT connection specific data */
@@ -197,6 +204,69 @@ void att_sent(struct bt_conn *conn, void *user_data)
 	}
 }
 
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+/* Key of the attribute a PDU is about, or 0. Handles of the local database
+ * are told apart from those of the peer database with BIT(16).
+ */
+static uint32_t att_pdu_attr_key(const struct net_buf *buf)
+{
+	const struct bt_att_hdr *hdr = (void *)buf->data;
+	uint32_t key;
+
+	if (buf->len < sizeof(*hdr) + sizeof(uint16_t)) {
+		return 0;
+	}
+
+	key = sys_get_le16(buf->data + sizeof(*hdr));
+
+	switch (hdr->code) {
+	case BT_ATT_OP_NOTIFY:
+	case BT_ATT_OP_INDICATE:
+		return key | BIT(16);
+	case BT_ATT_OP_READ_REQ:
+	case BT_ATT_OP_READ_BLOB_REQ:
+	case BT_ATT_OP_WRITE_REQ:
+	case BT_ATT_OP_WRITE_CMD:
+	case BT_ATT_OP_PREPARE_WRITE_REQ:
+		return key;
+	default:
+		return 0;
+	}
+}
+
+/* A PDU about an attribute shall not be sent while another one about it is
+ * waiting for credits on an enhanced bearer, as it could overtake it on
+ * another bearer, nor while a request about it is waiting for its response.
+ */
+static bool att_attr_busy(struct bt_att *att, const struct net_buf *buf)
+{
+	uint32_t key = att_pdu_attr_key(buf);
+	struct bt_att_chan *chan;
+
+	if (!key) {
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&att->chans, chan, node) {
+		if (atomic_test_bit(chan->flags, ATT_PENDING_SENT) &&
+		    chan->sent_key == key) {
+			return true;
+		}
+
+		if (chan->req && chan->req_key == key) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#else
+static inline bool att_attr_busy(struct bt_att *att, const struct net_buf *buf)
+{
+	return false;
+}
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
+
 /* In case of success the ownership of the buffer is transferred to the stack
  * which takes care of releasing it when it completes transmitting to the
  * controller.
@@ -210,6 +280,9 @@ static int chan_send(struct bt_att_chan *chan, struct net_buf *buf)
 	struct net_buf_simple_state state;
 	int err;
 	struct bt_att_tx_meta_data *data = bt_att_tx_meta_data(buf);
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+	uint32_t key;
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
 
 	hdr = (void *)buf->data;
 
@@ -250,6 +323,11 @@ static int chan_send(struct bt_att_chan *chan, struct net_buf *buf)
 
 		data->att_chan = chan;
 
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+		/* The buffer is no longer ours once it has been sent */
+		key = att_pdu_attr_key(buf);
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
+
 		/* bt_l2cap_chan_send does actually return the number of bytes
 		 * that could be sent immediately.
 		 */
@@ -258,6 +336,10 @@ static int chan_send(struct bt_att_chan *chan, struct net_buf *buf)
 			return err;
 		}
 
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+		chan->sent_key = key;
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
+
 		return 0;
 	}
 
@@ -313,7 +395,8 @@ static struct net_buf *get_first_buf_matching_chan(struct k_fifo *fifo, struct b
 
 		while ((buf = net_buf_get(fifo, K_NO_WAIT))) {
 			if (!ret &&
-			    att_chan_matches_chan_opt(chan, bt_att_tx_meta_data(buf)->chan_opt)) {
+			    att_chan_matches_chan_opt(chan, bt_att_tx_meta_data(buf)->chan_opt) &&
+			    !att_attr_busy(chan->att, buf)) {
 				ret = buf;
 			} else {
 				net_buf_put(&skipped, buf);
@@ -334,22 +417,30 @@ static struct net_buf *get_first_buf_matching_chan(struct k_fifo *fifo, struct b
 	}
 }
 
-static struct bt_att_req *get_first_req_matching_chan(sys_slist_t *reqs, struct bt_att_chan *chan)
+/* Removes the first request the channel can send from the list. The node in
+ * front of it is stored in prev, so that it can be put back in its place with
+ * sys_slist_insert() if it cannot be sent after all.
+ */
+static struct bt_att_req *get_first_req_matching_chan(sys_slist_t *reqs, struct bt_att_chan *chan,
+						      sys_snode_t **prev)
 {
+	*prev = NULL;
+
 	if (IS_ENABLED(CONFIG_BT_EATT)) {
-		sys_snode_t *curr, *prev = NULL;
+		sys_snode_t *curr;
 
 		SYS_SLIST_FOR_EACH_NODE(reqs, curr) {
 			if (att_chan_matches_chan_opt(
-				    chan, bt_att_tx_meta_data(ATT_REQ(curr)->buf)->chan_opt)) {
+				    chan, bt_att_tx_meta_data(ATT_REQ(curr)->buf)->chan_opt) &&
+			    !att_attr_busy(chan->att, ATT_REQ(curr)->buf)) {
 				break;
 			}
 
-			prev = curr;
+			*prev = curr;
 		}
 
 		if (curr) {
-			sys_slist_remove(reqs, prev, curr);
+			sys_slist_remove(reqs, *prev, curr);
 
 			return ATT_REQ(curr);
 		}
@@ -399,6 +490,9 @@ static int chan_req_send(struct bt_att_chan *chan, struct bt_att_req *req)
 	LOG_DBG("chan %p req %p len %zu", chan, req, net_buf_frags_len(req->buf));
 
 	chan->req = req;
+#if defined(CONFIG_BT_EATT_ATTR_ORDERING)
+	chan->req_key = att_pdu_attr_key(req->buf);
+#endif /* CONFIG_BT_EATT_ATTR_ORDERING */
 
 	/* Release since bt_l2cap_send_cb takes ownership of the buffer */
 	buf = req->buf;
@@ -434,15 +528,19 @@ static void bt_att_sent(struct bt_l2cap_chan *ch)
 	 * processed before they may always contain a buffer starving the
 	 * request queue.
 	 */
-	if (!chan->req && !sys_slist_is_empty(&att->reqs)) {
-		sys_snode_t *node = sys_slist_get(&att->reqs);
+	if (!chan->req) {
+		struct bt_att_req *req;
+		sys_snode_t *prev;
 
-		if (chan_req_send(chan, ATT_REQ(node)) >= 0) {
-			return;
-		}
+		req = get_first_req_matching_chan(&att->reqs, chan, &prev);
+		if (req) {
+			if (chan_req_send(chan, req) >= 0) {
+				return;
+			}
 
-		/* Prepend back to the list as it could not be sent */
-		sys_slist_prepend(&att->reqs, node);
+			/* Put it back in its place as it could not be sent */
+			sys_slist_insert(&att->reqs, prev, &req->node);
+		}
 	}
 
 	/* Process channel queue */
@@ -812,6 +910,7 @@ static void att_req_send_process(struct bt_att *att)
 {
 	struct bt_att_req *req = NULL;
 	struct bt_att_chan *chan, *tmp, *prev = NULL;
+	sys_snode_t *prev_req;
 
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&att->chans, chan, tmp, node) {
 		/* If there is an ongoing transaction, do not use the channel */
@@ -832,7 +931,7 @@ static void att_req_send_process(struct bt_att *att)
 		prev = chan;
 
 		/* Pull next request from the list */
-		req = get_first_req_matching_chan(&att->reqs, chan);
+		req = get_first_req_matching_chan(&att->reqs, chan, &prev_req);
 		if (!req) {
 			continue;
 		}
@@ -841,8 +940,8 @@ static void att_req_send_process(struct bt_att *att)
 			return;
 		}
 
-		/* Prepend back to the list as it could not be sent */
-		sys_slist_prepend(&att->reqs, &req->node);
+		/* Put it back in its place as it could not be sent */
+		sys_slist_insert(&att->reqs, prev_req, &req->node);
 	}
 }
 
@@ -880,6 +979,12 @@ static uint8_t att_handle_rsp(struct bt_att_chan *chan, void *pdu, uint16_t len,
 process:
 	/* Process pending requests */
 	att_req_send_process(chan->att);
+
+	/* PDUs about the attribute of the request may be waiting for it */
+	if (IS_ENABLED(CONFIG_BT_EATT_ATTR_ORDERING)) {
+		att_send_process(chan->att);
+	}
+
 	if (func) {
 		func(chan->att->conn, err, pdu, len, params);
 	}
@@ -1058,42 +1163,57 @@ static uint8_t att_find_info_req(struct bt_att_chan *chan, struct net_buf *buf)
 struct find_type_data {
 	struct bt_att_chan *chan;
 	struct net_buf *buf;
-	struct bt_att_handle_group *group;
+	uint16_t end_handle;
 	const void *value;
 	uint8_t value_len;
 	uint8_t err;
 };
 
+static uint8_t find_service_end_cb(const struct bt_gatt_attr *attr,
+				   uint16_t handle, void *user_data)
+{
+	uint16_t *end_handle = user_data;
+
+	/* Stop at the next service */
+	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY) ||
+	    !bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
+		return BT_GATT_ITER_STOP;
+	}
+
+	*end_handle = handle;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static uint16_t find_service_end(uint16_t handle, uint16_t end_handle)
+{
+	uint16_t service_end = handle;
+
+	if (handle < end_handle) {
+		bt_gatt_foreach_attr(handle + 1, end_handle,
+				     find_service_end_cb, &service_end);
+	}
+
+	return service_end;
+}
+
 static uint8_t find_type_cb(const struct bt_gatt_attr *attr, uint16_t handle,
 			    void *user_data)
 {
 	struct find_type_data *data = user_data;
 	struct bt_att_chan *chan = data->chan;
 	struct bt_conn *conn = chan->chan.chan.conn;
+	struct bt_att_handle_group *group;
 	int read;
 	uint8_t uuid[16];
 	struct net_buf *frag;
 	size_t len;
 
-	/* Skip secondary services */
-	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
-		goto skip;
-	}
-
-	/* Update group end_handle if not a primary service */
-	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY)) {
-		if (data->group &&
-		    handle > sys_le16_to_cpu(data->group->end_handle)) {
-			data->group->end_handle = sys_cpu_to_le16(handle);
-		}
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	LOG_DBG("handle 0x%04x", handle);
 
 	/* stop if there is no space left */
 	if (chan->chan.tx.mtu - net_buf_frags_len(data->buf) <
-	    sizeof(*data->group)) {
+	    sizeof(*group)) {
 		return BT_GATT_ITER_STOP;
 	}
 
@@ -1119,7 +1239,7 @@ static uint8_t find_type_cb(const struct bt_gatt_attr *attr, uint16_t handle,
 		 * Since we don't know if it is the service with requested UUID,
 		 * we cannot respond with an error to this request.
 		 */
-		goto skip;
+		return BT_GATT_ITER_CONTINUE;
 	}
 
 	/* Check if data matches */
@@ -1130,32 +1250,28 @@ static uint8_t find_type_cb(const struct bt_gatt_attr *attr, uint16_t handle,
 
 		if (!bt_uuid_create(&recvd_uuid.uuid, data->value, data->value_len)) {
 			LOG_WRN("Unable to create UUID: size %u", data->value_len);
-			goto skip;
+			return BT_GATT_ITER_CONTINUE;
 		}
 		if (!bt_uuid_create(&ref_uuid.uuid, uuid, read)) {
 			LOG_WRN("Unable to create UUID: size %d", read);
-			goto skip;
+			return BT_GATT_ITER_CONTINUE;
 		}
 		if (bt_uuid_cmp(&recvd_uuid.uuid, &ref_uuid.uuid)) {
-			goto skip;
+			return BT_GATT_ITER_CONTINUE;
 		}
 	} else if (memcmp(data->value, uuid, read)) {
-		goto skip;
+		return BT_GATT_ITER_CONTINUE;
 	}
 
 	/* If service has been found, error should be cleared */
 	data->err = 0x00;
 
-	/* Fast forward to next item position */
-	data->group = net_buf_add(frag, sizeof(*data->group));
-	data->group->start_handle = sys_cpu_to_le16(handle);
-	data->group->end_handle = sys_cpu_to_le16(handle);
-
-	/* continue to find the end_handle */
-	return BT_GATT_ITER_CONTINUE;
+	/* The group ends before the next service or with the range */
+	group = net_buf_add(frag, sizeof(*group));
+	group->start_handle = sys_cpu_to_le16(handle);
+	group->end_handle = sys_cpu_to_le16(find_service_end(handle,
+							      data->end_handle));
 
-skip:
-	data->group = NULL;
 	return BT_GATT_ITER_CONTINUE;
 }
 
@@ -1174,14 +1290,16 @@ static uint8_t att_find_type_rsp(struct bt_att_chan *chan, uint16_t start_handle
 	}
 
 	data.chan = chan;
-	data.group = NULL;
+	data.end_handle = end_handle;
 	data.value = value;
 	data.value_len = value_len;
 
 	/* Pre-set error in case no service will be found */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, find_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle,
+				  BT_UUID_GATT_PRIMARY, NULL, 0, find_type_cb,
+				  &data);
 
 	/* If error has not been cleared, no service has been found */
 	if (data.err) {
@@ -1341,11 +1459,6 @@ static uint8_t read_type_cb(const struct bt_gatt_attr *attr, uint16_t handle,
 	struct bt_conn *conn = chan->chan.chan.conn;
 	ssize_t read;
 
-	/* Skip if doesn't match */
-	if (bt_uuid_cmp(attr->uuid, data->uuid)) {
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	LOG_DBG("handle 0x%04x", handle);
 
 	/*
@@ -1414,7 +1527,8 @@ static uint8_t att_read_type_rsp(struct bt_att_chan *chan, struct bt_uuid *uuid,
 	/* Pre-set error if no attr will be found in handle */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, read_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle, uuid, NULL, 0,
+				  read_type_cb, &data);
 
 	if (data.err) {
 		tx_meta_data_free(bt_att_tx_meta_data(data.buf));
@@ -3157,7 +3271,8 @@ static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
 static void bt_att_status(struct bt_l2cap_chan *ch, atomic_t *status)
 {
 	struct bt_att_chan *chan = ATT_CHAN(ch);
-	sys_snode_t *node;
+	struct bt_att_req *req;
+	sys_snode_t *prev;
 
 	LOG_DBG("chan %p status %p", ch, status);
 
@@ -3176,17 +3291,17 @@ static void bt_att_status(struct bt_l2cap_chan *ch, atomic_t *status)
 	}
 
 	/* Pull next request from the list */
-	node = sys_slist_get(&chan->att->reqs);
-	if (!node) {
+	req = get_first_req_matching_chan(&chan->att->reqs, chan, &prev);
+	if (!req) {
 		return;
 	}
 
-	if (bt_att_chan_req_send(chan, ATT_REQ(node)) >= 0) {
+	if (bt_att_chan_req_send(chan, req) >= 0) {
 		return;
 	}
 
-	/* Prepend back to the list as it could not be sent */
-	sys_slist_prepend(&chan->att->reqs, node);
+	/* Put it back in its place as it could not be sent */
+	sys_slist_insert(&chan->att->reqs, prev, &req->node);
 }
 
 static void bt_att_released(struct bt_l2cap_chan *ch)
@@ -40,6 +40,16 @@ NET_BUF_POOL_FIXED_DEFINE(discardable_pool, CONFIG_BT_BUF_EVT_DISCARDABLE_COUNT,
 			  BT_BUF_EVT_SIZE(CONFIG_BT_BUF_EVT_DISCARDABLE_SIZE), 8,
 			  NULL);
 
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+/* Dedicated pool for HCI_Command_Complete and HCI_Command_Status when several
+ * commands are in flight, as they can no longer reuse the command buffer.
+ * These events are consumed synchronously by bt_recv_prio(), so one buffer per
+ * command in flight ensures that exhaustion of the RX pool cannot block them.
+ */
+NET_BUF_POOL_FIXED_DEFINE(cmd_complete_pool, CONFIG_BT_HCI_CMD_CREDITS_MAX,
+			  BT_BUF_EVT_RX_SIZE, 8, NULL);
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
+
 #if defined(CONFIG_BT_HCI_ACL_FLOW_CONTROL)
 NET_BUF_POOL_DEFINE(acl_in_pool, CONFIG_BT_BUF_ACL_RX_COUNT,
 		    BT_BUF_ACL_SIZE(CONFIG_BT_BUF_ACL_RX_SIZE),
@@ -99,7 +109,17 @@ struct net_buf *bt_buf_get_cmd_complete(k_timeout_t timeout)
 		return buf;
 	}
 
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+	buf = net_buf_alloc(&cmd_complete_pool, timeout);
+	if (buf) {
+		net_buf_reserve(buf, BT_BUF_RESERVE);
+		bt_buf_set_type(buf, BT_BUF_EVT);
+	}
+
+	return buf;
+#else
 	return bt_buf_get_rx(BT_BUF_EVT, timeout);
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
 }
 
 struct net_buf *bt_buf_get_evt(uint8_t evt, bool discardable,
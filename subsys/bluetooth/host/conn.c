@@ -102,6 +102,32 @@ NET_BUF_POOL_FIXED_DEFINE(frag_pool, CONFIG_BT_L2CAP_TX_FRAG_COUNT,
 
 #endif /* CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0 */
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_ZERO_COPY)
+struct frag_view_meta {
+	struct tx_meta tx;
+	/* Buffer whose data the fragment points into */
+	struct net_buf *parent;
+};
+
+#define frag_view_data(buf) ((struct frag_view_meta *)net_buf_user_data(buf))
+
+static void frag_view_destroy(struct net_buf *view);
+
+/* Fragments that point into the data of the buffer being fragmented. They
+ * have no data of their own, only a reference to that buffer.
+ */
+NET_BUF_POOL_DEFINE(frag_view_pool, CONFIG_BT_BUF_ACL_TX_COUNT, 0,
+		    sizeof(struct frag_view_meta), frag_view_destroy);
+
+static void frag_view_destroy(struct net_buf *view)
+{
+	struct net_buf *parent = frag_view_data(view)->parent;
+
+	net_buf_destroy(view);
+	net_buf_unref(parent);
+}
+#endif /* CONFIG_BT_L2CAP_TX_FRAG_ZERO_COPY */
+
 #if defined(CONFIG_BT_SMP) || defined(CONFIG_BT_BREDR)
 const struct bt_conn_auth_cb *bt_auth;
 sys_slist_t bt_auth_info_cbs = SYS_SLIST_STATIC_INIT(&bt_auth_info_cbs);
@@ -201,36 +227,42 @@ static void tx_notify(struct bt_conn *conn)
 	LOG_DBG("conn %p", conn);
 
 	while (1) {
-		struct bt_conn_tx *tx = NULL;
+		sys_slist_t complete;
+		sys_snode_t *node;
 		unsigned int key;
-		bt_conn_tx_cb_t cb;
-		void *user_data;
 
+		/* Take everything completed so far in one go */
 		key = irq_lock();
-		if (!sys_slist_is_empty(&conn->tx_complete)) {
-			tx = CONTAINER_OF(sys_slist_get_not_empty(&conn->tx_complete),
-					  struct bt_conn_tx, node);
-		}
+		complete = conn->tx_complete;
+		sys_slist_init(&conn->tx_complete);
 		irq_unlock(key);
 
-		if (!tx) {
+		if (sys_slist_is_empty(&complete)) {
 			return;
 		}
 
-		LOG_DBG("tx %p cb %p user_data %p", tx, tx->cb, tx->user_data);
+		while ((node = sys_slist_get(&complete))) {
+			struct bt_conn_tx *tx = CONTAINER_OF(node, struct bt_conn_tx,
+							     node);
+			bt_conn_tx_cb_t cb;
+			void *user_data;
 
-		/* Copy over the params */
-		cb = tx->cb;
-		user_data = tx->user_data;
+			LOG_DBG("tx %p cb %p user_data %p", tx, tx->cb,
+				tx->user_data);
 
-		/* Free up TX notify since there may be user waiting */
-		tx_free(tx);
+			/* Copy over the params */
+			cb = tx->cb;
+			user_data = tx->user_data;
 
-		/* Run the callback, at this point it should be safe to
-		 * allocate new buffers since the TX should have been
-		 * unblocked by tx_free.
-		 */
-		cb(conn, user_data, 0);
+			/* Free up TX notify since there may be user waiting */
+			tx_free(tx);
+
+			/* Run the callback, at this point it should be safe to
+			 * allocate new buffers since the TX should have been
+			 * unblocked by tx_free.
+			 */
+			cb(conn, user_data, 0);
+		}
 	}
 }
 
@@ -623,7 +655,13 @@ static int send_frag(struct bt_conn *conn,
 	if (frag) {
 		uint16_t frag_len = MIN(conn_mtu(conn), net_buf_tailroom(frag));
 
-		net_buf_add_mem(frag, buf->data, frag_len);
+		/* A fragment view already points at the data */
+		if (frag->flags & NET_BUF_EXTERNAL_DATA) {
+			net_buf_add(frag, frag_len);
+		} else {
+			net_buf_add_mem(frag, buf->data, frag_len);
+		}
+
 		net_buf_pull(buf, frag_len);
 	} else {
 		/* De-queue the buffer now that we know we can send it.
@@ -638,6 +676,43 @@ static int send_frag(struct bt_conn *conn,
 	return do_send_frag(conn, frag, flags);
 }
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_ZERO_COPY)
+static struct net_buf *create_frag_view(struct bt_conn *conn,
+					struct net_buf *buf)
+{
+	const size_t hdr_len = sizeof(struct bt_hci_acl_hdr);
+	uint16_t len = MIN(conn_mtu(conn), buf->len);
+	struct net_buf *view;
+
+	/* The ACL header of the fragment is pushed over the bytes preceding
+	 * it in @p buf: either its headroom, or data the driver has already
+	 * copied when sending the previous fragment.
+	 */
+	if (!(bt_dev.drv->quirks & BT_QUIRK_ACL_SEND_COPY) ||
+	    net_buf_headroom(buf) < hdr_len) {
+		return NULL;
+	}
+
+	view = net_buf_alloc_with_data(&frag_view_pool, buf->data - hdr_len,
+				       hdr_len + len, K_NO_WAIT);
+	if (!view) {
+		return NULL;
+	}
+
+	view->len = 0U;
+	net_buf_reserve(view, hdr_len);
+	frag_view_data(view)->parent = net_buf_ref(buf);
+
+	return view;
+}
+#else
+static inline struct net_buf *create_frag_view(struct bt_conn *conn,
+					       struct net_buf *buf)
+{
+	return NULL;
+}
+#endif /* CONFIG_BT_L2CAP_TX_FRAG_ZERO_COPY */
+
 static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct net_buf *frag;
@@ -650,7 +725,10 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 #endif
 	default:
 #if defined(CONFIG_BT_CONN)
-		frag = bt_conn_create_frag(0);
+		frag = create_frag_view(conn, buf);
+		if (!frag) {
+			frag = bt_conn_create_frag(0);
+		}
 #else
 		return NULL;
 #endif /* CONFIG_BT_CONN */
@@ -1040,6 +1040,115 @@ BT_GATT_SERVICE_DEFINE(_1_gatt_svc,
 #endif /* CONFIG_BT_GATT_SERVICE_CHANGED */
 );
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+#define ATTR_INDEX_SIZE CONFIG_BT_GATT_HANDLE_INDEX_SIZE
+
+struct attr_type_entry {
+	uint16_t key;
+	uint16_t handle;
+};
+
+/* Attributes by handle, and their handles sorted by type so that the
+ * attributes of a type can be found without walking the database. Both are
+ * rebuilt whenever a service is registered or unregistered, with
+ * attr_index_lock held so that lookups from other threads do not see them
+ * half built.
+ */
+static K_MUTEX_DEFINE(attr_index_lock);
+static const struct bt_gatt_attr *attr_index[ATTR_INDEX_SIZE + 1];
+static struct attr_type_entry attr_type_index[ATTR_INDEX_SIZE];
+static uint16_t attr_type_count;
+static uint16_t attr_index_last;
+static bool attr_index_valid;
+
+/* Equal UUIDs have the same 128-bit form, in which bytes 12-13 hold the
+ * lower bits of 16 and 32-bit UUIDs. Different UUIDs may share a key, so
+ * the attributes found with one are still compared with the UUID.
+ */
+static uint16_t attr_type_key(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return BT_UUID_16(uuid)->val;
+	case BT_UUID_TYPE_32:
+		return BT_UUID_32(uuid)->val & UINT16_MAX;
+	default:
+		return sys_get_le16(&BT_UUID_128(uuid)->val[12]);
+	}
+}
+
+static int attr_type_cmp(const void *a, const void *b)
+{
+	const struct attr_type_entry *e1 = a;
+	const struct attr_type_entry *e2 = b;
+
+	if (e1->key != e2->key) {
+		return (int)e1->key - (int)e2->key;
+	}
+
+	return (int)e1->handle - (int)e2->handle;
+}
+
+static void attr_index_add(const struct bt_gatt_attr *attr, uint16_t handle)
+{
+	if (handle > ATTR_INDEX_SIZE) {
+		attr_index_valid = false;
+		return;
+	}
+
+	attr_index[handle] = attr;
+	attr_index_last = MAX(attr_index_last, handle);
+
+	attr_type_index[attr_type_count].key = attr_type_key(attr->uuid);
+	attr_type_index[attr_type_count].handle = handle;
+	attr_type_count++;
+}
+
+static void attr_index_build(void)
+{
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	struct bt_gatt_service *svc;
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+	uint16_t handle = 1;
+	size_t i;
+
+	k_mutex_lock(&attr_index_lock, K_FOREVER);
+
+	(void)memset(attr_index, 0, sizeof(attr_index));
+	attr_type_count = 0U;
+	attr_index_last = 0U;
+	attr_index_valid = true;
+
+	STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
+		for (i = 0; i < static_svc->attr_count; i++, handle++) {
+			attr_index_add(&static_svc->attrs[i], handle);
+		}
+	}
+
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		for (i = 0; i < svc->attr_count; i++) {
+			attr_index_add(&svc->attrs[i], svc->attrs[i].handle);
+		}
+	}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
+	if (!attr_index_valid) {
+		LOG_WRN("Handles above 0x%04x, database not indexed",
+			ATTR_INDEX_SIZE);
+	} else {
+		qsort(attr_type_index, attr_type_count,
+		      sizeof(attr_type_index[0]), attr_type_cmp);
+	}
+
+	k_mutex_unlock(&attr_index_lock);
+}
+#else
+static inline void attr_index_build(void)
+{
+}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 #if defined(CONFIG_BT_GATT_DYNAMIC_DB)
 static uint8_t found_attr(const struct bt_gatt_attr *attr, uint16_t handle,
 			  void *user_data)
@@ -1121,6 +1230,7 @@ populate:
 	}
 
 	gatt_insert(svc, last_handle);
+	attr_index_build();
 
 	return 0;
 }
@@ -1288,6 +1398,8 @@ static void bt_gatt_service_init(void)
 	STRUCT_SECTION_FOREACH(bt_gatt_service_static, svc) {
 		last_static_handle += svc->attr_count;
 	}
+
+	attr_index_build();
 }
 
 void bt_gatt_init(void)
@@ -1455,6 +1567,8 @@ static int gatt_unregister(struct bt_gatt_service *svc)
 		return -ENOENT;
 	}
 
+	attr_index_build();
+
 	for (uint16_t i = 0; i < svc->attr_count; i++) {
 		struct bt_gatt_attr *attr = &svc->attrs[i];
 
@@ -1808,6 +1922,64 @@ static void foreach_attr_type_dyndb(uint16_t start_handle, uint16_t end_handle,
 #endif /* CONFIG_BT_GATT_DYNAMIC_DB */
 }
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+static size_t attr_type_find(uint16_t key, uint16_t start_handle)
+{
+	size_t lo = 0;
+	size_t hi = attr_type_count;
+
+	/* First entry not below key and start_handle */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const struct attr_type_entry *entry = &attr_type_index[mid];
+
+		if (entry->key < key ||
+		    (entry->key == key && entry->handle < start_handle)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void foreach_attr_type_index(uint16_t start_handle, uint16_t end_handle,
+				    const struct bt_uuid *uuid,
+				    const void *attr_data, uint16_t num_matches,
+				    bt_gatt_attr_func_t func, void *user_data)
+{
+	end_handle = MIN(end_handle, attr_index_last);
+
+	if (uuid) {
+		uint16_t key = attr_type_key(uuid);
+
+		for (size_t i = attr_type_find(key, start_handle);
+		     i < attr_type_count && attr_type_index[i].key == key; i++) {
+			uint16_t handle = attr_type_index[i].handle;
+
+			if (gatt_foreach_iter(attr_index[handle], handle,
+					      start_handle, end_handle, uuid,
+					      attr_data, &num_matches, func,
+					      user_data) == BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+
+		return;
+	}
+
+	for (uint32_t handle = start_handle; handle <= end_handle; handle++) {
+		if (attr_index[handle] &&
+		    gatt_foreach_iter(attr_index[handle], handle, start_handle,
+				      end_handle, NULL, attr_data, &num_matches,
+				      func, user_data) == BT_GATT_ITER_STOP) {
+			return;
+		}
+	}
+}
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 			       const struct bt_uuid *uuid,
 			       const void *attr_data, uint16_t num_matches,
@@ -1819,6 +1991,21 @@ void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 		num_matches = UINT16_MAX;
 	}
 
+#if defined(CONFIG_BT_GATT_HANDLE_INDEX)
+	/* The lock is recursive, so func may look up attributes as well */
+	k_mutex_lock(&attr_index_lock, K_FOREVER);
+
+	if (attr_index_valid) {
+		foreach_attr_type_index(start_handle, end_handle, uuid,
+					attr_data, num_matches, func,
+					user_data);
+		k_mutex_unlock(&attr_index_lock);
+		return;
+	}
+
+	k_mutex_unlock(&attr_index_lock);
+#endif /* CONFIG_BT_GATT_HANDLE_INDEX */
+
 	if (start_handle <= last_static_handle) {
 		uint16_t handle = 1;
 
@@ -106,6 +106,10 @@ struct cmd_data {
 
 	/** Used by bt_hci_cmd_send_sync. */
 	struct k_sem *sync;
+
+	/** Used by bt_hci_cmd_send_cb. */
+	bt_hci_cmd_cb_t cb;
+	void *user_data;
 };
 
 static struct cmd_data cmd_data[CONFIG_BT_BUF_CMD_TX_COUNT];
@@ -266,6 +270,7 @@ struct net_buf *bt_hci_cmd_create(uint16_t opcode, uint8_t param_len)
 	cmd(buf)->opcode = opcode;
 	cmd(buf)->sync = NULL;
 	cmd(buf)->state = NULL;
+	cmd(buf)->cb = NULL;
 
 	hdr = net_buf_add(buf, sizeof(*hdr));
 	hdr->opcode = sys_cpu_to_le16(opcode);
@@ -353,6 +358,26 @@ int bt_hci_cmd_send_sync(uint16_t opcode, struct net_buf *buf,
 	return 0;
 }
 
+int bt_hci_cmd_send_cb(uint16_t opcode, struct net_buf *buf,
+		       bt_hci_cmd_cb_t cb, void *user_data)
+{
+	if (!buf) {
+		buf = bt_hci_cmd_create(opcode, 0);
+		if (!buf) {
+			return -ENOBUFS;
+		}
+	}
+
+	LOG_DBG("buf %p opcode 0x%04x len %u", buf, opcode, buf->len);
+
+	cmd(buf)->cb = cb;
+	cmd(buf)->user_data = user_data;
+
+	net_buf_put(&bt_dev.cmd_tx_queue, buf);
+
+	return 0;
+}
+
 int bt_hci_le_rand(void *buffer, size_t len)
 {
 	struct bt_hci_rp_le_rand *rp;
@@ -428,8 +453,10 @@ static void hci_num_completed_packets(struct net_buf *buf)
 	LOG_DBG("num_handles %u", evt->num_handles);
 
 	for (i = 0; i < evt->num_handles; i++) {
-		uint16_t handle, count;
+		uint16_t handle, count, freed;
+		bool completed = false;
 		struct bt_conn *conn;
+		unsigned int key;
 
 		handle = sys_le16_to_cpu(evt->h[i].handle);
 		count = sys_le16_to_cpu(evt->h[i].count);
@@ -442,37 +469,44 @@ static void hci_num_completed_packets(struct net_buf *buf)
 			continue;
 		}
 
-		while (count--) {
+		/* Complete all the packets of the handle under one lock, and
+		 * notify them with a single work item.
+		 */
+		key = irq_lock();
+
+		for (freed = 0U; freed < count; freed++) {
 			struct bt_conn_tx *tx;
 			sys_snode_t *node;
-			unsigned int key;
-
-			key = irq_lock();
 
 			if (conn->pending_no_cb) {
 				conn->pending_no_cb--;
-				irq_unlock(key);
-				k_sem_give(bt_conn_get_pkts(conn));
 				continue;
 			}
 
 			node = sys_slist_get(&conn->tx_pending);
-			irq_unlock(key);
-
 			if (!node) {
-				LOG_ERR("packets count mismatch");
 				break;
 			}
 
 			tx = CONTAINER_OF(node, struct bt_conn_tx, node);
 
-			key = irq_lock();
 			conn->pending_no_cb = tx->pending_no_cb;
 			tx->pending_no_cb = 0U;
 			sys_slist_append(&conn->tx_complete, &tx->node);
-			irq_unlock(key);
+			completed = true;
+		}
+
+		irq_unlock(key);
 
+		if (freed < count) {
+			LOG_ERR("packets count mismatch");
+		}
+
+		if (completed) {
 			k_work_submit(&conn->tx_complete_work);
+		}
+
+		while (freed--) {
 			k_sem_give(bt_conn_get_pkts(conn));
 		}
 
@@ -2063,6 +2097,140 @@ static void hci_reset_complete(struct net_buf *buf)
 	atomic_set(bt_dev.flags, flags);
 }
 
+static void hci_cmd_notify(uint16_t opcode, uint8_t status, struct net_buf *buf)
+{
+	if (cmd(buf)->state && !status) {
+		struct bt_hci_cmd_state_set *update = cmd(buf)->state;
+
+		atomic_set_bit_to(update->target, update->bit, update->val);
+	}
+
+	if (cmd(buf)->cb) {
+		cmd(buf)->cb(opcode, status, buf, cmd(buf)->user_data);
+	}
+
+	/* If the command was synchronous wake up bt_hci_cmd_send_sync() */
+	if (cmd(buf)->sync) {
+		cmd(buf)->status = status;
+		k_sem_give(cmd(buf)->sync);
+	}
+}
+
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+/* Add the command buffer to the sent commands, if the Controller can take
+ * it. The Num_HCI_Command_Packets it last reported may not account for the
+ * commands sent since, so it is counted against all the commands in flight.
+ */
+static bool sent_cmd_add(struct net_buf *buf)
+{
+	bool added = false;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (bt_dev.sent_cmds_count < bt_dev.ncmd) {
+		/* Every command buffer is in the list at most once */
+		bt_dev.sent_cmds[bt_dev.sent_cmds_count++] = net_buf_ref(buf);
+		added = true;
+	}
+
+	irq_unlock(key);
+
+	return added;
+}
+
+/* Remove the given command buffer from the sent commands or, if buf is NULL,
+ * the oldest one sent with the OpCode. The reference of the list is handed
+ * over to the caller.
+ */
+static struct net_buf *sent_cmd_remove(uint16_t opcode, struct net_buf *buf)
+{
+	struct net_buf *found = NULL;
+	unsigned int key;
+
+	key = irq_lock();
+
+	for (uint8_t i = 0U; i < bt_dev.sent_cmds_count; i++) {
+		struct net_buf *sent = bt_dev.sent_cmds[i];
+
+		if (buf ? (sent != buf) : (cmd(sent)->opcode != opcode)) {
+			continue;
+		}
+
+		found = sent;
+		bt_dev.sent_cmds_count--;
+		memmove(&bt_dev.sent_cmds[i], &bt_dev.sent_cmds[i + 1],
+			(bt_dev.sent_cmds_count - i) * sizeof(bt_dev.sent_cmds[0]));
+		break;
+	}
+
+	irq_unlock(key);
+
+	return found;
+}
+
+static void hci_cmd_done(uint16_t opcode, uint8_t status, struct net_buf *buf)
+{
+	struct net_buf *cmd_buf;
+	unsigned int key;
+
+	LOG_DBG("opcode 0x%04x status 0x%02x buf %p", opcode, status, buf);
+
+	/* Several commands may be in flight, so the Command Complete and
+	 * Command Status events come in buffers of their own. Commands that
+	 * could not be sent are completed with their own buffer.
+	 */
+	if (net_buf_pool_get(buf->pool_id) == &hci_cmd_pool) {
+		cmd_buf = sent_cmd_remove(opcode, buf);
+	} else {
+		/* The event comes with a new Num_HCI_Command_Packets, no more
+		 * commands are sent until hci_ncmd_update() takes it.
+		 */
+		key = irq_lock();
+		bt_dev.ncmd = 0U;
+		irq_unlock(key);
+
+		cmd_buf = sent_cmd_remove(opcode, NULL);
+	}
+
+	if (!cmd_buf) {
+		LOG_WRN("OpCode 0x%04x completed but was not sent", opcode);
+		return;
+	}
+
+	if (cmd_buf != buf) {
+		/* Hand the response parameters over in the command buffer, as
+		 * bt_hci_cmd_send_sync() callers expect.
+		 */
+		net_buf_reset(cmd_buf);
+		net_buf_reserve(cmd_buf, BT_BUF_RESERVE);
+		bt_buf_set_type(cmd_buf, BT_BUF_EVT);
+
+		if (buf->len > net_buf_tailroom(cmd_buf)) {
+			LOG_ERR("OpCode 0x%04x response too long (%u)", opcode, buf->len);
+			status = BT_HCI_ERR_UNSPECIFIED;
+		} else {
+			net_buf_add_mem(cmd_buf, buf->data, buf->len);
+		}
+	}
+
+	hci_cmd_notify(opcode, status, cmd_buf);
+
+	net_buf_unref(cmd_buf);
+}
+
+static void hci_ncmd_update(uint8_t ncmd)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	bt_dev.ncmd = MIN(ncmd, CONFIG_BT_HCI_CMD_CREDITS_MAX);
+	irq_unlock(key);
+
+	/* Have the TX thread check the credits again */
+	k_sem_give(&bt_dev.ncmd_sem);
+}
+#else
 static void hci_cmd_done(uint16_t opcode, uint8_t status, struct net_buf *buf)
 {
 	LOG_DBG("opcode 0x%04x status 0x%02x buf %p", opcode, status, buf);
@@ -2084,18 +2252,16 @@ static void hci_cmd_done(uint16_t opcode, uint8_t status, struct net_buf *buf)
 		bt_dev.sent_cmd = NULL;
 	}
 
-	if (cmd(buf)->state && !status) {
-		struct bt_hci_cmd_state_set *update = cmd(buf)->state;
-
-		atomic_set_bit_to(update->target, update->bit, update->val);
-	}
+	hci_cmd_notify(opcode, status, buf);
+}
 
-	/* If the command was synchronous wake up bt_hci_cmd_send_sync() */
-	if (cmd(buf)->sync) {
-		cmd(buf)->status = status;
-		k_sem_give(cmd(buf)->sync);
+static void hci_ncmd_update(uint8_t ncmd)
+{
+	if (ncmd) {
+		k_sem_give(&bt_dev.ncmd_sem);
 	}
 }
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
 
 static void hci_cmd_complete(struct net_buf *buf)
 {
@@ -2117,9 +2283,7 @@ static void hci_cmd_complete(struct net_buf *buf)
 	hci_cmd_done(opcode, status, buf);
 
 	/* Allow next command to be sent */
-	if (ncmd) {
-		k_sem_give(&bt_dev.ncmd_sem);
-	}
+	hci_ncmd_update(ncmd);
 }
 
 static void hci_cmd_status(struct net_buf *buf)
@@ -2137,9 +2301,7 @@ static void hci_cmd_status(struct net_buf *buf)
 	hci_cmd_done(opcode, evt->status, buf);
 
 	/* Allow next command to be sent */
-	if (ncmd) {
-		k_sem_give(&bt_dev.ncmd_sem);
-	}
+	hci_ncmd_update(ncmd);
 }
 
 int bt_hci_get_conn_handle(const struct bt_conn *conn, uint16_t *conn_handle)
@@ -2429,6 +2591,12 @@ static void send_cmd(void)
 	buf = net_buf_get(&bt_dev.cmd_tx_queue, K_NO_WAIT);
 	BT_ASSERT(buf);
 
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+	/* Wait until the Controller can take one more command */
+	while (!sent_cmd_add(buf)) {
+		k_sem_take(&bt_dev.ncmd_sem, K_FOREVER);
+	}
+#else
 	/* Wait until ncmd > 0 */
 	LOG_DBG("calling sem_take_wait");
 	k_sem_take(&bt_dev.ncmd_sem, K_FOREVER);
@@ -2441,6 +2609,7 @@ static void send_cmd(void)
 	}
 
 	bt_dev.sent_cmd = net_buf_ref(buf);
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
 
 	LOG_DBG("Sending command 0x%04x (buf %p) to driver", cmd(buf)->opcode, buf);
 
@@ -3631,40 +3800,48 @@ static void rx_work_handler(struct k_work *work)
 {
 	int err;
 
-	struct net_buf *buf;
+	/* Take up to CONFIG_BT_RECV_BATCH buffers per run, so that packets
+	 * arriving together from several connections do not each need a pass
+	 * through the work queue.
+	 */
+	for (int i = 0; i < CONFIG_BT_RECV_BATCH; i++) {
+		struct net_buf *buf;
 
-	LOG_DBG("Getting net_buf from queue");
-	buf = net_buf_slist_get(&bt_dev.rx_queue);
-	if (!buf) {
-		return;
-	}
+		LOG_DBG("Getting net_buf from queue");
+		buf = net_buf_slist_get(&bt_dev.rx_queue);
+		if (!buf) {
+			return;
+		}
 
-	LOG_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf), buf->len);
+		LOG_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
+			buf->len);
 
-	switch (bt_buf_get_type(buf)) {
+		switch (bt_buf_get_type(buf)) {
 #if defined(CONFIG_BT_CONN)
-	case BT_BUF_ACL_IN:
-		hci_acl(buf);
-		break;
+		case BT_BUF_ACL_IN:
+			hci_acl(buf);
+			break;
 #endif /* CONFIG_BT_CONN */
 #if defined(CONFIG_BT_ISO)
-	case BT_BUF_ISO_IN:
-		hci_iso(buf);
-		break;
+		case BT_BUF_ISO_IN:
+			hci_iso(buf);
+			break;
 #endif /* CONFIG_BT_ISO */
-	case BT_BUF_EVT:
-		hci_event(buf);
-		break;
-	default:
-		LOG_ERR("Unknown buf type %u", bt_buf_get_type(buf));
-		net_buf_unref(buf);
-		break;
+		case BT_BUF_EVT:
+			hci_event(buf);
+			break;
+		default:
+			LOG_ERR("Unknown buf type %u", bt_buf_get_type(buf));
+			net_buf_unref(buf);
+			break;
+		}
 	}
 
 	/* Schedule the work handler to be executed again if there are
 	 * additional items in the queue. This allows for other users of the
-	 * work queue to get a chance at running, which wouldn't be possible if
-	 * we used a while() loop with a k_yield() statement.
+	 * work queue to get a chance at running after each batch, which
+	 * wouldn't be possible if we used a while() loop with a k_yield()
+	 * statement.
 	 */
 	if (!sys_slist_is_empty(&bt_dev.rx_queue)) {
 
@@ -3718,6 +3895,9 @@ int bt_enable(bt_ready_cb_t cb)
 	} else {
 		k_sem_init(&bt_dev.ncmd_sem, 0, 1);
 	}
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+	bt_dev.ncmd = IS_ENABLED(CONFIG_BT_WAIT_NOP) ? 0U : 1U;
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
 	k_fifo_init(&bt_dev.cmd_tx_queue);
 	/* TX thread */
 	k_thread_create(&tx_thread_data, tx_thread_stack,
@@ -347,6 +347,15 @@ struct bt_dev {
 	/* Last sent HCI command */
 	struct net_buf		*sent_cmd;
 
+#if CONFIG_BT_HCI_CMD_CREDITS_MAX > 1
+	/* HCI commands sent and not yet completed, oldest first */
+	struct net_buf		*sent_cmds[CONFIG_BT_BUF_CMD_TX_COUNT];
+	uint8_t			sent_cmds_count;
+
+	/* Commands the Controller can take, those in flight included */
+	uint8_t			ncmd;
+#endif /* CONFIG_BT_HCI_CMD_CREDITS_MAX > 1 */
+
 #if !defined(CONFIG_BT_RECV_BLOCKING)
 	/* Queue for incoming HCI events & ACL data */
 	sys_slist_t rx_queue;
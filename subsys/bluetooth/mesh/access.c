@@ -365,6 +365,107 @@ static void mod_init(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
 	}
 }
 
+#if defined(CONFIG_BT_MESH_ACCESS_OP_INDEX)
+/* The model find_op() would find for each element and OpCode, chained into
+ * hash buckets by element and OpCode. Chain links and bucket heads are
+ * entry indexes plus one, 0 ending the chain.
+ */
+static struct op_index_entry {
+	uint32_t key;
+	struct bt_mesh_model *model;
+	const struct bt_mesh_model_op *op;
+	uint16_t chain;
+} op_index[CONFIG_BT_MESH_ACCESS_OP_INDEX_SIZE];
+static uint16_t op_index_bucket[CONFIG_BT_MESH_ACCESS_OP_INDEX_SIZE];
+static uint16_t op_index_count;
+static bool op_index_valid;
+
+/* OpCodes take at most 24 bits, and element indexes 8 */
+#define OP_INDEX_KEY(elem_idx, opcode) (((uint32_t)(elem_idx) << 24) | (opcode))
+
+static uint16_t op_index_hash(uint32_t key)
+{
+	/* Fibonacci hashing, as the OpCodes of a model are close together */
+	return ((key * 2654435761U) >> 16) % CONFIG_BT_MESH_ACCESS_OP_INDEX_SIZE;
+}
+
+static struct op_index_entry *op_index_get(uint16_t elem_idx, uint32_t opcode)
+{
+	uint32_t key = OP_INDEX_KEY(elem_idx, opcode);
+	uint16_t i;
+
+	for (i = op_index_bucket[op_index_hash(key)]; i; i = op_index[i - 1].chain) {
+		if (op_index[i - 1].key == key) {
+			return &op_index[i - 1];
+		}
+	}
+
+	return NULL;
+}
+
+static void op_index_add(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+			 bool vnd, bool primary, void *user_data)
+{
+	const struct bt_mesh_model_op *op;
+
+	for (op = mod->op; op->func; op++) {
+		struct op_index_entry *entry;
+		uint16_t *bucket;
+
+		/* find_op() only looks for 3-octet OpCodes in the vendor
+		 * models, and for the others in the SIG models.
+		 */
+		if (vnd != (BT_MESH_MODEL_OP_LEN(op->opcode) == 3)) {
+			continue;
+		}
+
+		if (IS_ENABLED(CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE) && vnd &&
+		    mod->vnd.company != (uint16_t)(op->opcode & 0xffff)) {
+			continue;
+		}
+
+		/* The models are visited in the order find_op() goes through
+		 * them, so the first one with the OpCode is kept.
+		 */
+		if (op_index_get(mod->elem_idx, op->opcode)) {
+			continue;
+		}
+
+		if (op_index_count == ARRAY_SIZE(op_index)) {
+			op_index_valid = false;
+			return;
+		}
+
+		entry = &op_index[op_index_count];
+		entry->key = OP_INDEX_KEY(mod->elem_idx, op->opcode);
+		entry->model = mod;
+		entry->op = op;
+
+		bucket = &op_index_bucket[op_index_hash(entry->key)];
+		entry->chain = *bucket;
+		*bucket = ++op_index_count;
+	}
+}
+
+static void op_index_build(void)
+{
+	(void)memset(op_index_bucket, 0, sizeof(op_index_bucket));
+	op_index_count = 0U;
+	op_index_valid = true;
+
+	bt_mesh_model_foreach(op_index_add, NULL);
+
+	if (!op_index_valid) {
+		LOG_WRN("More than %d OpCodes, not indexing them",
+			CONFIG_BT_MESH_ACCESS_OP_INDEX_SIZE);
+	}
+}
+#else
+static inline void op_index_build(void)
+{
+}
+#endif /* CONFIG_BT_MESH_ACCESS_OP_INDEX */
+
 int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 {
 	int err;
@@ -378,8 +479,13 @@ int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 
 	err = 0;
 	bt_mesh_model_foreach(mod_init, &err);
+	if (err) {
+		return err;
+	}
 
-	return err;
+	op_index_build();
+
+	return 0;
 }
 
 void bt_mesh_comp_provision(uint16_t addr)
@@ -677,56 +783,123 @@ static int get_opcode(struct net_buf_simple *buf, uint32_t *opcode)
 	CODE_UNREACHABLE;
 }
 
-void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf)
+static void model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+		       struct bt_mesh_model *model, const struct bt_mesh_model_op *op,
+		       uint32_t opcode)
 {
-	struct bt_mesh_model *model;
-	const struct bt_mesh_model_op *op;
-	uint32_t opcode;
-	int i;
+	struct net_buf_simple_state state;
 
-	LOG_DBG("app_idx 0x%04x src 0x%04x dst 0x%04x", rx->ctx.app_idx, rx->ctx.addr,
-		rx->ctx.recv_dst);
-	LOG_DBG("len %u: %s", buf->len, bt_hex(buf->data, buf->len));
+	if (!bt_mesh_model_has_key(model, rx->ctx.app_idx)) {
+		return;
+	}
 
-	if (get_opcode(buf, &opcode) < 0) {
-		LOG_WRN("Unable to decode OpCode");
+	if (!model_has_dst(model, rx->ctx.recv_dst)) {
 		return;
 	}
 
-	LOG_DBG("OpCode 0x%08x", opcode);
+	if ((op->len >= 0) && (buf->len < (size_t)op->len)) {
+		LOG_ERR("Too short message for OpCode 0x%08x", opcode);
+		return;
+	} else if ((op->len < 0) && (buf->len != (size_t)(-op->len))) {
+		LOG_ERR("Invalid message size for OpCode 0x%08x", opcode);
+		return;
+	}
+
+	/* The callback will likely parse the buffer, so
+	 * store the parsing state in case multiple models
+	 * receive the message.
+	 */
+	net_buf_simple_save(buf, &state);
+	(void)op->func(model, &rx->ctx, buf);
+	net_buf_simple_restore(buf, &state);
+}
+
+#if defined(CONFIG_BT_MESH_ACCESS_OP_INDEX)
+static void op_index_elem_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+			       uint16_t elem_idx, uint32_t opcode)
+{
+	struct op_index_entry *entry;
+
+	entry = op_index_get(elem_idx, opcode);
+	if (!entry) {
+		LOG_DBG("No OpCode 0x%08x for elem %d", opcode, elem_idx);
+		return;
+	}
+
+	model_recv(rx, buf, entry->model, entry->op, opcode);
+}
+
+static bool op_index_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+			  uint32_t opcode)
+{
+	struct bt_mesh_elem *elem;
+	int i;
+
+	if (!op_index_valid) {
+		return false;
+	}
+
+	/* Only the models of the addressed element can take a message sent to
+	 * a unicast address.
+	 */
+	if (BT_MESH_ADDR_IS_UNICAST(rx->ctx.recv_dst)) {
+		elem = bt_mesh_elem_find(rx->ctx.recv_dst);
+		if (elem) {
+			op_index_elem_recv(rx, buf, elem - dev_comp->elem, opcode);
+		}
+
+		return true;
+	}
 
 	for (i = 0; i < dev_comp->elem_count; i++) {
-		struct net_buf_simple_state state;
+		op_index_elem_recv(rx, buf, i, opcode);
+	}
+
+	return true;
+}
+#else
+static inline bool op_index_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+				 uint32_t opcode)
+{
+	return false;
+}
+#endif /* CONFIG_BT_MESH_ACCESS_OP_INDEX */
+
+static void elem_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+		      uint32_t opcode)
+{
+	struct bt_mesh_model *model;
+	const struct bt_mesh_model_op *op;
+	int i;
 
+	for (i = 0; i < dev_comp->elem_count; i++) {
 		op = find_op(&dev_comp->elem[i], opcode, &model);
 		if (!op) {
 			LOG_DBG("No OpCode 0x%08x for elem %d", opcode, i);
 			continue;
 		}
 
-		if (!bt_mesh_model_has_key(model, rx->ctx.app_idx)) {
-			continue;
-		}
+		model_recv(rx, buf, model, op, opcode);
+	}
+}
 
-		if (!model_has_dst(model, rx->ctx.recv_dst)) {
-			continue;
-		}
+void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf)
+{
+	uint32_t opcode;
 
-		if ((op->len >= 0) && (buf->len < (size_t)op->len)) {
-			LOG_ERR("Too short message for OpCode 0x%08x", opcode);
-			continue;
-		} else if ((op->len < 0) && (buf->len != (size_t)(-op->len))) {
-			LOG_ERR("Invalid message size for OpCode 0x%08x", opcode);
-			continue;
-		}
+	LOG_DBG("app_idx 0x%04x src 0x%04x dst 0x%04x", rx->ctx.app_idx, rx->ctx.addr,
+		rx->ctx.recv_dst);
+	LOG_DBG("len %u: %s", buf->len, bt_hex(buf->data, buf->len));
 
-		/* The callback will likely parse the buffer, so
-		 * store the parsing state in case multiple models
-		 * receive the message.
-		 */
-		net_buf_simple_save(buf, &state);
-		(void)op->func(model, &rx->ctx, buf);
-		net_buf_simple_restore(buf, &state);
+	if (get_opcode(buf, &opcode) < 0) {
+		LOG_WRN("Unable to decode OpCode");
+		return;
+	}
+
+	LOG_DBG("OpCode 0x%08x", opcode);
+
+	if (!op_index_recv(rx, buf, opcode)) {
+		elem_recv(rx, buf, opcode);
 	}
 
 	if (IS_ENABLED(CONFIG_BT_MESH_ACCESS_LAYER_MSG) && msg_cb) {
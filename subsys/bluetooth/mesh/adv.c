@@ -45,6 +45,12 @@ static K_FIFO_DEFINE(bt_mesh_adv_queue);
 static K_FIFO_DEFINE(bt_mesh_relay_queue);
 static K_FIFO_DEFINE(bt_mesh_friend_queue);
 
+/* Relayed messages are queued separately when relay advertising sets send
+ * them, or when they go before the local messages.
+ */
+#define RELAY_QUEUE (CONFIG_BT_MESH_RELAY_ADV_SETS || \
+		     IS_ENABLED(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO))
+
 static void adv_buf_destroy(struct net_buf *buf)
 {
 	struct bt_mesh_adv adv = *BT_MESH_ADV(buf);
@@ -131,7 +137,7 @@ struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type,
 					    tag, xmit, timeout);
 }
 
-#if CONFIG_BT_MESH_RELAY_ADV_SETS || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE
+#if RELAY_QUEUE || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE
 static struct net_buf *process_events(struct k_poll_event *ev, int count)
 {
 	for (; count; ev++, count--) {
@@ -155,17 +161,25 @@ static struct net_buf *process_events(struct k_poll_event *ev, int count)
 struct net_buf *bt_mesh_adv_buf_get(k_timeout_t timeout)
 {
 	int err;
+	/* The first queue with data is served first */
 	struct k_poll_event events[] = {
+#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO)
+		K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+						K_POLL_MODE_NOTIFY_ONLY,
+						&bt_mesh_relay_queue,
+						0),
+#endif /* CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO */
 		K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE,
 						K_POLL_MODE_NOTIFY_ONLY,
 						&bt_mesh_adv_queue,
 						0),
-#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET)
+#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET) && \
+	!defined(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO)
 		K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE,
 						K_POLL_MODE_NOTIFY_ONLY,
 						&bt_mesh_relay_queue,
 						0),
-#endif /* CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET */
+#endif /* CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET && !CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO */
 	};
 
 	err = k_poll(events, ARRAY_SIZE(events), timeout);
@@ -183,14 +197,18 @@ struct net_buf *bt_mesh_adv_buf_get_by_tag(uint8_t tag, k_timeout_t timeout)
 	}
 
 #if CONFIG_BT_MESH_RELAY_ADV_SETS
-	if (tag & BT_MESH_RELAY_ADV) {
+	/* With CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET, the main
+	 * advertising set relays messages too, but takes them together with
+	 * the local ones.
+	 */
+	if ((tag & BT_MESH_RELAY_ADV) && !(tag & BT_MESH_LOCAL_ADV)) {
 		return net_buf_get(&bt_mesh_relay_queue, timeout);
 	}
 #endif
 
 	return bt_mesh_adv_buf_get(timeout);
 }
-#else /* !(CONFIG_BT_MESH_RELAY_ADV_SETS || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE) */
+#else /* !(RELAY_QUEUE || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE) */
 struct net_buf *bt_mesh_adv_buf_get(k_timeout_t timeout)
 {
 	return net_buf_get(&bt_mesh_adv_queue, timeout);
@@ -202,7 +220,7 @@ struct net_buf *bt_mesh_adv_buf_get_by_tag(uint8_t tag, k_timeout_t timeout)
 
 	return bt_mesh_adv_buf_get(timeout);
 }
-#endif /* CONFIG_BT_MESH_RELAY_ADV_SETS || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE */
+#endif /* RELAY_QUEUE || CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE */
 
 void bt_mesh_adv_buf_get_cancel(void)
 {
@@ -210,9 +228,9 @@ void bt_mesh_adv_buf_get_cancel(void)
 
 	k_fifo_cancel_wait(&bt_mesh_adv_queue);
 
-#if CONFIG_BT_MESH_RELAY_ADV_SETS
+#if RELAY_QUEUE
 	k_fifo_cancel_wait(&bt_mesh_relay_queue);
-#endif /* CONFIG_BT_MESH_RELAY_ADV_SETS */
+#endif /* RELAY_QUEUE */
 
 	if (IS_ENABLED(CONFIG_BT_MESH_ADV_EXT_FRIEND_SEPARATE)) {
 		k_fifo_cancel_wait(&bt_mesh_friend_queue);
@@ -236,7 +254,7 @@ void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 		return;
 	}
 
-#if CONFIG_BT_MESH_RELAY_ADV_SETS
+#if RELAY_QUEUE
 	if (BT_MESH_ADV(buf)->tag == BT_MESH_RELAY_ADV) {
 		net_buf_put(&bt_mesh_relay_queue, net_buf_ref(buf));
 		bt_mesh_adv_buf_relay_ready();
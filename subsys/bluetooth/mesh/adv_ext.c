@@ -74,9 +74,10 @@ static STRUCT_SECTION_ITERABLE(bt_mesh_ext_adv, adv_main) = {
 #if !defined(CONFIG_BT_MESH_ADV_EXT_GATT_SEPARATE)
 		BT_MESH_PROXY_ADV |
 #endif /* !CONFIG_BT_MESH_ADV_EXT_GATT_SEPARATE */
-#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET)
+#if defined(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET) || \
+	defined(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO)
 		BT_MESH_RELAY_ADV |
-#endif /* CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET */
+#endif /* CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET || CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO */
 		BT_MESH_LOCAL_ADV),
 
 	.work = Z_WORK_DELAYABLE_INITIALIZER(send_pending_adv),
@@ -358,8 +359,11 @@ void bt_mesh_adv_buf_relay_ready(void)
 		}
 	}
 
-	/* Attempt to use the main adv set for the sending of relay messages. */
-	if (IS_ENABLED(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET)) {
+	/* Attempt to use the main adv set for the sending of relay messages.
+	 * Without relay adv sets, it is the only one that sends them.
+	 */
+	if (IS_ENABLED(CONFIG_BT_MESH_ADV_EXT_RELAY_USING_MAIN_ADV_SET) ||
+	    CONFIG_BT_MESH_RELAY_ADV_SETS == 0) {
 		(void)schedule_send(&adv_main);
 	}
 }
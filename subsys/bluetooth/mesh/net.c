@@ -79,11 +79,24 @@ struct iv_val {
 	      iv_duration:7;
 } __packed;
 
-static struct {
-	uint32_t src : 15, /* MSb of source is always 0 */
-	      seq : 17;
-} msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static uint16_t msg_cache_next;
+/* Ring of the values seen last, with each value also chained into a hash
+ * bucket so that looking it up does not go through the whole ring. Chain
+ * links and bucket heads are entry indexes plus one, 0 ending the chain.
+ */
+struct net_cache {
+	uint32_t val[CONFIG_BT_MESH_MSG_CACHE_SIZE];
+	uint16_t chain[CONFIG_BT_MESH_MSG_CACHE_SIZE];
+	uint16_t bucket[CONFIG_BT_MESH_MSG_CACHE_SIZE];
+	uint16_t next;
+	uint16_t count;
+};
+
+/* Network Message Cache, keyed by source and the low 17 bits of SeqNum.
+ * The MSb of the source is always 0, so the key fits 32 bits.
+ */
+#define MSG_CACHE_VAL(src, seq) (((uint32_t)(src) << 17) | ((seq) & BIT_MASK(17)))
+
+static struct net_cache msg_cache;
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -110,62 +123,93 @@ K_MEM_SLAB_DEFINE(loopback_buf_pool,
 		  sizeof(struct loopback_buf),
 		  CONFIG_BT_MESH_LOOPBACK_BUFS, __alignof__(struct loopback_buf));
 
-static uint32_t dup_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static int   dup_cache_next;
+static struct net_cache dup_cache;
 
-static bool check_dup(struct net_buf_simple *data)
+static uint16_t net_cache_bucket(uint32_t val)
 {
-	const uint8_t *tail = net_buf_simple_tail(data);
-	uint32_t val;
-	int i;
+	/* Fibonacci hashing, as the values are close together for messages
+	 * from the same source.
+	 */
+	return ((val * 2654435761U) >> 16) % CONFIG_BT_MESH_MSG_CACHE_SIZE;
+}
 
-	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+static bool net_cache_has(const struct net_cache *cache, uint32_t val)
+{
+	uint16_t i;
 
-	for (i = dup_cache_next; i > 0;) {
-		if (dup_cache[--i] == val) {
+	for (i = cache->bucket[net_cache_bucket(val)]; i; i = cache->chain[i - 1]) {
+		if (cache->val[i - 1] == val) {
 			return true;
 		}
 	}
 
-	for (i = ARRAY_SIZE(dup_cache); i > dup_cache_next;) {
-		if (dup_cache[--i] == val) {
-			return true;
-		}
-	}
+	return false;
+}
+
+static void net_cache_unlink(struct net_cache *cache, uint16_t idx)
+{
+	uint16_t *link = &cache->bucket[net_cache_bucket(cache->val[idx])];
 
-	dup_cache_next %= ARRAY_SIZE(dup_cache);
-	dup_cache[dup_cache_next++] = val;
+	while (*link && *link != idx + 1) {
+		link = &cache->chain[*link - 1];
+	}
 
-	return false;
+	if (*link) {
+		*link = cache->chain[idx];
+	}
 }
 
-static bool msg_cache_match(struct net_buf_simple *pdu)
+static void net_cache_add(struct net_cache *cache, uint32_t val)
 {
-	uint16_t i;
+	uint16_t *bucket = &cache->bucket[net_cache_bucket(val)];
 
-	for (i = msg_cache_next; i > 0U;) {
-		if (msg_cache[--i].src == SRC(pdu->data) &&
-		    msg_cache[i].seq == (SEQ(pdu->data) & BIT_MASK(17))) {
-			return true;
-		}
+	cache->next %= CONFIG_BT_MESH_MSG_CACHE_SIZE;
+
+	/* Once the ring is full, the oldest value is replaced */
+	if (cache->count == CONFIG_BT_MESH_MSG_CACHE_SIZE) {
+		net_cache_unlink(cache, cache->next);
+	} else {
+		cache->count++;
 	}
 
-	for (i = ARRAY_SIZE(msg_cache); i > msg_cache_next;) {
-		if (msg_cache[--i].src == SRC(pdu->data) &&
-		    msg_cache[i].seq == (SEQ(pdu->data) & BIT_MASK(17))) {
-			return true;
-		}
+	cache->val[cache->next] = val;
+	cache->chain[cache->next] = *bucket;
+	*bucket = cache->next + 1;
+	cache->next++;
+}
+
+/* Remove the value added last */
+static void net_cache_remove_last(struct net_cache *cache)
+{
+	net_cache_unlink(cache, --cache->next);
+	cache->count--;
+}
+
+static bool check_dup(struct net_buf_simple *data)
+{
+	const uint8_t *tail = net_buf_simple_tail(data);
+	uint32_t val;
+
+	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+
+	if (net_cache_has(&dup_cache, val)) {
+		return true;
 	}
 
+	net_cache_add(&dup_cache, val);
+
 	return false;
 }
 
+static bool msg_cache_match(struct net_buf_simple *pdu)
+{
+	return net_cache_has(&msg_cache,
+			     MSG_CACHE_VAL(SRC(pdu->data), SEQ(pdu->data)));
+}
+
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
-	msg_cache[msg_cache_next].src = rx->ctx.addr;
-	msg_cache[msg_cache_next].seq = rx->seq;
-	msg_cache_next++;
+	net_cache_add(&msg_cache, MSG_CACHE_VAL(rx->ctx.addr, rx->seq));
 }
 
 static void store_iv(bool only_duration)
@@ -208,8 +252,7 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const uint8_t key[16],
 		return err;
 	}
 
-	(void)memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0U;
+	(void)memset(&msg_cache, 0, sizeof(msg_cache));
 
 	bt_mesh.iv_index = iv_index;
 	atomic_set_bit_to(bt_mesh.flags, BT_MESH_IVU_IN_PROGRESS,
@@ -859,8 +902,12 @@ void bt_mesh_net_recv(struct net_buf_simple *data, int8_t rssi,
 	if (bt_mesh_trans_recv(&buf, &rx) == -EAGAIN) {
 		LOG_WRN("Removing rejected message from Network Message Cache");
 		/* Rewind the next index now that we're not using this entry */
-		msg_cache[--msg_cache_next].src = BT_MESH_ADDR_UNASSIGNED;
-		dup_cache[--dup_cache_next] = 0;
+		net_cache_remove_last(&msg_cache);
+
+		/* Only advertising bearer PDUs are in the duplicate cache */
+		if (rx.net_if == BT_MESH_NET_IF_ADV) {
+			net_cache_remove_last(&dup_cache);
+		}
 	}
 
 	/* Relay if this was a group/virtual address, or if the destination
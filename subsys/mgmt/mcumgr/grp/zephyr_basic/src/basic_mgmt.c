@@ -8,13 +8,19 @@
 #include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/heap_profiler.h>
 
 #include <zephyr/mgmt/mcumgr/mgmt/mgmt.h>
 #include <zephyr/mgmt/mcumgr/mgmt/handlers.h>
+#include <zephyr/mgmt/mcumgr/smp/smp.h>
 #include <zephyr/mgmt/mcumgr/grp/zephyr/zephyr_basic.h>
 
+#include <zcbor_common.h>
+#include <zcbor_encode.h>
+
 LOG_MODULE_REGISTER(mcumgr_zbasic_grp, CONFIG_MCUMGR_GRP_ZBASIC_LOG_LEVEL);
 
+#ifdef CONFIG_MCUMGR_GRP_ZBASIC_STORAGE_ERASE
 #define ERASE_TARGET		storage_partition
 #define ERASE_TARGET_ID		FIXED_PARTITION_ID(ERASE_TARGET)
 
@@ -46,12 +52,70 @@ static int storage_erase_handler(struct smp_streamer *ctxt)
 	 */
 	return rc;
 }
+#endif /* CONFIG_MCUMGR_GRP_ZBASIC_STORAGE_ERASE */
+
+#ifdef CONFIG_MCUMGR_GRP_ZBASIC_HEAP_PROFILE
+struct heap_profile_encode_ctx {
+	zcbor_state_t *zse;
+	bool ok;
+};
+
+static void heap_profile_encode_site(const struct heap_profiler_site *site,
+				     void *user_data)
+{
+	struct heap_profile_encode_ctx *ctx = user_data;
+
+	ctx->ok = ctx->ok							&&
+		  zcbor_map_start_encode(ctx->zse, 5)				&&
+		  zcbor_tstr_put_lit(ctx->zse, "site")				&&
+		  zcbor_uint64_put(ctx->zse, (uintptr_t)site->site)		&&
+		  zcbor_tstr_put_lit(ctx->zse, "live")				&&
+		  zcbor_uint64_put(ctx->zse, site->live_bytes)			&&
+		  zcbor_tstr_put_lit(ctx->zse, "peak")				&&
+		  zcbor_uint64_put(ctx->zse, site->peak_bytes)			&&
+		  zcbor_tstr_put_lit(ctx->zse, "allocs")			&&
+		  zcbor_uint32_put(ctx->zse, site->allocs)			&&
+		  zcbor_tstr_put_lit(ctx->zse, "frees")				&&
+		  zcbor_uint32_put(ctx->zse, site->frees)			&&
+		  zcbor_map_end_encode(ctx->zse, 5);
+}
+
+static int heap_profile_handler(struct smp_streamer *ctxt)
+{
+	struct heap_profile_encode_ctx ctx = {
+		.zse = ctxt->writer->zs,
+		.ok = true,
+	};
+
+	ctx.ok = zcbor_tstr_put_lit(ctx.zse, "dropped")				&&
+		 zcbor_uint32_put(ctx.zse, heap_profiler_dropped_get())		&&
+		 zcbor_tstr_put_lit(ctx.zse, "sites")				&&
+		 zcbor_list_start_encode(ctx.zse, CONFIG_HEAP_PROFILER_MAX_SITES);
+
+	heap_profiler_foreach_site(heap_profile_encode_site, &ctx);
+
+	if (!ctx.ok ||
+	    !zcbor_list_end_encode(ctx.zse, CONFIG_HEAP_PROFILER_MAX_SITES)) {
+		return MGMT_ERR_EMSGSIZE;
+	}
+
+	return MGMT_ERR_EOK;
+}
+#endif /* CONFIG_MCUMGR_GRP_ZBASIC_HEAP_PROFILE */
 
 static const struct mgmt_handler zephyr_mgmt_basic_handlers[] = {
+#ifdef CONFIG_MCUMGR_GRP_ZBASIC_STORAGE_ERASE
 	[ZEPHYR_MGMT_GRP_BASIC_CMD_ERASE_STORAGE] = {
 		.mh_read  = NULL,
 		.mh_write = storage_erase_handler,
 	},
+#endif
+#ifdef CONFIG_MCUMGR_GRP_ZBASIC_HEAP_PROFILE
+	[ZEPHYR_MGMT_GRP_BASIC_CMD_HEAP_PROFILE] = {
+		.mh_read  = heap_profile_handler,
+		.mh_write = NULL,
+	},
+#endif
 };
 
 static struct mgmt_group zephyr_basic_mgmt_group = {
@@ -27,87 +27,132 @@ LOG_MODULE_DECLARE(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
 /* Timeout for various buffer allocations in this file. */
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
+#define REASSEMBLY_HASH_SIZE BIT(LOG2CEIL(CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT))
+
 static void reassembly_timeout(struct k_work *work);
 
 static struct net_ipv4_reassembly reassembly[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
 
-static struct net_ipv4_reassembly *reassembly_get(uint16_t id, struct in_addr *src,
-						  struct in_addr *dst, uint8_t protocol)
+/* Slots that are in use are found through the hash table, the others are
+ * kept in the free list. Both, and the slots themselves, are protected by
+ * the reassembly lock, as the timeouts run in the system work queue.
+ */
+static sys_slist_t reassembly_hash[REASSEMBLY_HASH_SIZE];
+static sys_slist_t reassembly_free_list;
+static uint32_t reassembly_hash_seed;
+
+static K_MUTEX_DEFINE(reassembly_lock);
+
+static inline uint32_t reassembly_hash_mix(uint32_t hash, uint32_t word)
 {
-	int i, avail = -1;
+	word *= 0xcc9e2d51U;
+	word = (word << 15) | (word >> 17);
+	word *= 0x1b873593U;
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv4_addr_cmp(src, &reassembly[i].src) &&
-		    net_ipv4_addr_cmp(dst, &reassembly[i].dst) &&
-		    reassembly[i].protocol == protocol) {
-			return &reassembly[i];
-		}
+	hash ^= word;
+	hash = (hash << 13) | (hash >> 19);
 
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
+	return hash * 5U + 0xe6546b64U;
+}
+
+/* MurmurHash3 of the fragment key, seeded at boot */
+static uint32_t reassembly_hash_calc(uint16_t id, struct in_addr *src,
+				     struct in_addr *dst, uint8_t protocol)
+{
+	uint32_t hash = reassembly_hash_seed;
+
+	hash = reassembly_hash_mix(hash, ((uint32_t)id << 8) | protocol);
+	hash = reassembly_hash_mix(hash, UNALIGNED_GET(&src->s_addr));
+	hash = reassembly_hash_mix(hash, UNALIGNED_GET(&dst->s_addr));
 
-		if (avail < 0) {
-			avail = i;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+/* Must be invoked with the reassembly lock held */
+static struct net_ipv4_reassembly *reassembly_get(uint16_t id, struct in_addr *src,
+						  struct in_addr *dst, uint8_t protocol)
+{
+	uint32_t hash = reassembly_hash_calc(id, src, dst, protocol);
+	sys_slist_t *bucket = &reassembly_hash[hash & (REASSEMBLY_HASH_SIZE - 1)];
+	struct net_ipv4_reassembly *reass;
+	sys_snode_t *free_node;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, reass, node) {
+		if (reass->hash == hash && reass->id == id &&
+		    net_ipv4_addr_cmp(src, &reass->src) &&
+		    net_ipv4_addr_cmp(dst, &reass->dst) &&
+		    reass->protocol == protocol) {
+			return reass;
 		}
 	}
 
-	if (avail < 0) {
+	free_node = sys_slist_get(&reassembly_free_list);
+	if (!free_node) {
 		return NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
+	reass = CONTAINER_OF(free_node, struct net_ipv4_reassembly, node);
 
-	net_ipaddr_copy(&reassembly[avail].src, src);
-	net_ipaddr_copy(&reassembly[avail].dst, dst);
+	k_work_reschedule(&reass->timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
 
-	reassembly[avail].protocol = protocol;
-	reassembly[avail].id = id;
+	net_ipaddr_copy(&reass->src, src);
+	net_ipaddr_copy(&reass->dst, dst);
 
-	return &reassembly[avail];
-}
+	reass->protocol = protocol;
+	reass->id = id;
+	reass->hash = hash;
 
-static bool reassembly_cancel(uint32_t id, struct in_addr *src, struct in_addr *dst)
-{
-	int i, j;
+	sys_slist_prepend(bucket, &reass->node);
 
-	LOG_DBG("Cancel 0x%x", id);
+	return reass;
+}
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+/* Must be invoked with the reassembly lock held */
+static void reassembly_free(struct net_ipv4_reassembly *reass)
+{
+	sys_slist_find_and_remove(&reassembly_hash[reass->hash & (REASSEMBLY_HASH_SIZE - 1)],
+				  &reass->node);
 
-		if (reassembly[i].id != id ||
-		    !net_ipv4_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv4_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
-		}
+	reass->id = 0U;
+	reass->count = 0U;
+	reass->received = 0U;
+	reass->total = 0U;
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+	sys_slist_prepend(&reassembly_free_list, &reass->node);
+}
 
-		LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reassembly[i].id, remaining);
+/* Must be invoked with the reassembly lock held */
+static void reassembly_cancel(struct net_ipv4_reassembly *reass)
+{
+	int32_t remaining;
+	int j;
 
-		reassembly[i].id = 0U;
+	LOG_DBG("Cancel 0x%x", reass->id);
 
-		for (j = 0; j < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	remaining = k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer));
+	k_work_cancel_delayable(&reass->timer);
 
-			LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", j,
-				reassembly[i].pkt[j], net_pkt_get_len(reassembly[i].pkt[j]));
+	LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reass->id, remaining);
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	for (j = 0; j < reass->count; j++) {
+		if (!reass->pkt[j]) {
+			continue;
 		}
 
-		return true;
+		LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", j, reass->pkt[j],
+			net_pkt_get_len(reass->pkt[j]));
+
+		net_pkt_unref(reass->pkt[j]);
+		reass->pkt[j] = NULL;
 	}
 
-	return false;
+	reassembly_free(reass);
 }
 
 static void reassembly_info(char *str, struct net_ipv4_reassembly *reass)
@@ -124,17 +169,55 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv4_reassembly *reass =
 		CONTAINER_OF(work, struct net_ipv4_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The packet was completed, or the slot reused, while this was
+	 * waiting for the lock.
+	 */
+	if (reass->count == 0U || k_work_delayable_remaining_get(&reass->timer)) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv4 Time Exceeded only if we received the first fragment */
-	if (reass->pkt[0] && net_pkt_ipv4_fragment_offset(reass->pkt[0]) == 0) {
+	if (net_pkt_ipv4_fragment_offset(reass->pkt[0]) == 0) {
 		net_icmpv4_send_error(reass->pkt[0], NET_ICMPV4_TIME_EXCEEDED,
 				      NET_ICMPV4_TIME_EXCEEDED_FRAGMENT_REASSEMBLY_TIME);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
+}
+
+/* Removes the first len bytes of the packet by moving the start of its
+ * buffers, so that the data that follows stays where it is.
+ */
+static int reassembly_strip(struct net_pkt *pkt, size_t len)
+{
+	while (len > 0 && pkt->buffer) {
+		struct net_buf *buf = pkt->buffer;
+
+		if (buf->len > len) {
+			net_buf_pull(buf, len);
+			len = 0;
+			break;
+		}
+
+		len -= buf->len;
+		pkt->buffer = buf->frags;
+		buf->frags = NULL;
+		net_buf_unref(buf);
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return len > 0 ? -ENOBUFS : 0;
 }
 
+/* Must be invoked with the reassembly lock held */
 static void reassemble_packet(struct net_ipv4_reassembly *reass)
 {
 	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
@@ -147,29 +230,22 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 
 	NET_ASSERT(reass->pkt[0]);
 
+	/* The buffers of the fragments are chained after the ones of the
+	 * first fragment, none of the data is copied.
+	 */
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
 
 	/* We start from 2nd packet which is then appended to the first one */
-	for (i = 1; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
+	for (i = 1; i < reass->count; i++) {
 		pkt = reass->pkt[i];
-		if (!pkt) {
-			break;
-		}
-
-		net_pkt_cursor_init(pkt);
-
-		/* Get rid of IPv4 header which is at the beginning of the fragment. */
-		ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
-		if (!ipv4_hdr) {
-			goto error;
-		}
 
 		LOG_DBG("Removing %d bytes from start of pkt %p", net_pkt_ip_hdr_len(pkt),
 			pkt->buffer);
 
-		if (net_pkt_pull(pkt, net_pkt_ip_hdr_len(pkt))) {
+		/* Get rid of IPv4 header which is at the beginning of the fragment. */
+		if (reassembly_strip(pkt, net_pkt_ip_hdr_len(pkt)) || !pkt->buffer) {
 			LOG_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
+			reassembly_cancel(reass);
 			return;
 		}
 
@@ -186,6 +262,8 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	reassembly_free(reass);
+
 	/* Update the header details for the packet */
 	net_pkt_cursor_init(pkt);
 
@@ -223,6 +301,8 @@ void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
 {
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
 		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
 			continue;
@@ -230,109 +310,102 @@ void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
 
 		cb(&reassembly[i], user_data);
 	}
+
+	k_mutex_unlock(&reassembly_lock);
+}
+
+static uint32_t fragment_end(struct net_pkt *pkt)
+{
+	return net_pkt_ipv4_fragment_offset(pkt) + net_pkt_get_len(pkt) -
+	       net_pkt_ip_hdr_len(pkt);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Store the fragment in the reassembly, in offset order. Fragments that
+ * overlap are refused, so that once the last fragment has told the length
+ * of the packet, it is complete when that many bytes have been received.
  * Return:
- * - a negative value if the fragments are erroneous and must be dropped
- * - zero if we are expecting more fragments
- * - a positive value if we can proceed with the reassembly
+ * - -EBADMSG if the fragments are erroneous and must be dropped
+ * - -ENOMEM if there is no room left for the fragment
+ * - zero if the fragment was stored
  */
-static int fragments_are_ready(struct net_ipv4_reassembly *reass)
+static int fragment_insert(struct net_ipv4_reassembly *reass, struct net_pkt *pkt)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
-	int i;
+	uint32_t offset = net_pkt_ipv4_fragment_offset(pkt);
+	int payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
+	int lo = 0, hi = reass->count;
 
-	/* Fragments can arrive in any order, for example in reverse order:
-	 *   1 -> Fragment3(M=0, offset=x2)
-	 *   2 -> Fragment2(M=1, offset=x1)
-	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
-	 */
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
+	if (payload_len < 0) {
+		return -EBADMSG;
+	}
 
-		if (!pkt) {
-			break;
+	/* Find the first fragment that does not start before this one */
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (net_pkt_ipv4_fragment_offset(reass->pkt[mid]) < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
+	}
 
-		offset = net_pkt_ipv4_fragment_offset(pkt);
+	/* Overlapping or duplicated, drop it */
+	if ((lo > 0 && fragment_end(reass->pkt[lo - 1]) > offset) ||
+	    (lo < reass->count &&
+	     (net_pkt_ipv4_fragment_offset(reass->pkt[lo]) == offset ||
+	      net_pkt_ipv4_fragment_offset(reass->pkt[lo]) < offset + payload_len))) {
+		return -EBADMSG;
+	}
 
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated, drop it */
+	if (net_pkt_ipv4_fragment_more(pkt)) {
+		if (reass->total && offset + payload_len > reass->total) {
 			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
 		}
-
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
-
-		if (payload_len < 0) {
+	} else {
+		/* Only one last fragment, and nothing after it */
+		if (reass->total || lo < reass->count) {
 			return -EBADMSG;
 		}
-
-		expected_offset += payload_len;
-		more = net_pkt_ipv4_fragment_more(pkt);
 	}
 
-	if (more) {
-		return 0;
+	if (reass->count == CONFIG_NET_IPV4_FRAGMENT_MAX_PKT) {
+		return -ENOMEM;
 	}
 
-	return 1;
-}
-
-static int shift_packets(struct net_ipv4_reassembly *reass, int pos)
-{
-	int i;
+	LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, lo, offset);
 
-	for (i = pos + 1; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			LOG_DBG("Moving [%d] %p (offset 0x%x) to [%d]", pos, reass->pkt[pos],
-				net_pkt_ipv4_fragment_offset(reass->pkt[pos]), pos + 1);
-
-			/* pkt[i] is free, so shift everything between [pos] and [i - 1] by one
-			 * element
-			 */
-			memmove(&reass->pkt[pos + 1], &reass->pkt[pos],
-				sizeof(void *) * (i - pos));
+	memmove(&reass->pkt[lo + 1], &reass->pkt[lo],
+		sizeof(void *) * (reass->count - lo));
+	reass->pkt[lo] = pkt;
+	reass->count++;
 
-			/* pkt[pos] is now free */
-			reass->pkt[pos] = NULL;
-
-			return 0;
-		}
+	reass->received += payload_len;
+	if (!net_pkt_ipv4_fragment_more(pkt)) {
+		reass->total = offset + payload_len;
 	}
 
-	/* We do not have free space left in the array */
-	return -ENOMEM;
+	return 0;
 }
 
 enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ipv4_hdr *hdr)
 {
 	struct net_ipv4_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_DROP;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint16_t id;
 	int ret;
-	int i;
 
 	flag = ntohs(*((uint16_t *)&hdr->offset));
 	id = ntohs(*((uint16_t *)&hdr->id));
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	reass = reassembly_get(id, (struct in_addr *)hdr->src,
 			       (struct in_addr *)hdr->dst, hdr->proto);
 	if (!reass) {
 		LOG_ERR("Cannot get reassembly slot, dropping pkt %p", pkt);
-		goto drop;
+		goto out;
 	}
 
 	more = (flag & NET_IPV4_MORE_FRAG_MASK) ? true : false;
@@ -347,57 +420,28 @@ enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ip
 		goto drop;
 	}
 
-	/* The fragments might come in wrong order so place them in the reassembly chain in the
-	 * correct order.
+	/* The fragments might come in wrong order so they are placed in the
+	 * reassembly chain in the correct order.
 	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		if (reass->pkt[i]) {
-			if (net_pkt_ipv4_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv4_fragment_offset(pkt)) {
-				continue;
-			}
-
-			/* Make room for this fragment. If there is no room then it will discard
-			 * the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
-		}
-
-		LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, i,
-			net_pkt_ipv4_fragment_offset(pkt));
-		reass->pkt[i] = pkt;
-		found = true;
-
-		break;
-	}
-
-	if (!found) {
+	ret = fragment_insert(reass, pkt);
+	if (ret == -ENOMEM) {
 		/* We could not add this fragment into our saved fragment list. The whole packet
 		 * must be discarded at this point.
 		 */
 		LOG_ERR("No slots available for 0x%x", reass->id);
-		net_pkt_unref(pkt);
 		goto drop;
-	}
-
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
+	} else if (ret < 0) {
 		LOG_ERR("Reassembled IPv4 verify failed, dropping id %u", reass->id);
+		goto drop;
+	}
 
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
+	verdict = NET_OK;
 
-		net_pkt_unref(pkt);
-		goto drop;
-	} else if (ret == 0) {
+	if (reass->total == 0U || reass->received < reass->total) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		LOG_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
@@ -405,17 +449,18 @@ enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ip
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
 
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
-	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
-	}
+	/* The whole packet is dropped, including this fragment */
+	net_pkt_unref(pkt);
+	reassembly_cancel(reass);
+	verdict = NET_OK;
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 
-	return NET_DROP;
+	return verdict;
 }
 
 static int send_ipv4_fragment(struct net_pkt *pkt, uint16_t rand_id, uint16_t fit_len,
@@ -640,5 +685,8 @@ void net_ipv4_setup_fragment_buffers(void)
 	 */
 	for (int i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
 		k_work_init_delayable(&reassembly[i].timer, reassembly_timeout);
+		sys_slist_append(&reassembly_free_list, &reassembly[i].node);
 	}
+
+	reassembly_hash_seed = sys_rand32_get();
 }
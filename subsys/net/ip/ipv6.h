@@ -417,9 +417,24 @@ struct net_ipv6_reassembly {
 	 */
 	struct k_work_delayable timer;
 
-	/** Pointers to pending fragments */
+	/** Pointers to pending fragments, sorted by their offset */
 	struct net_pkt *pkt[CONFIG_NET_IPV6_FRAGMENT_MAX_PKT];
 
+	/** Node in the lookup hash table, or in the list of free slots */
+	sys_snode_t node;
+
+	/** Hash of the fragment identification and addresses */
+	uint32_t hash;
+
+	/** Number of payload bytes received so far */
+	uint32_t received;
+
+	/** Payload length of the packet, 0 until its last fragment arrives */
+	uint32_t total;
+
+	/** Number of pending fragments */
+	uint16_t count;
+
 	/** IPv6 fragment identification */
 	uint32_t id;
 };
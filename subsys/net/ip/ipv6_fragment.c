@@ -40,12 +40,24 @@ LOG_MODULE_DECLARE(net_ipv6, CONFIG_NET_IPV6_LOG_LEVEL);
 
 #define FRAG_BUF_WAIT K_MSEC(10) /* how long to max wait for a buffer */
 
+#define REASSEMBLY_HASH_SIZE BIT(LOG2CEIL(CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT))
+
 static void reassembly_timeout(struct k_work *work);
 static bool reassembly_init_done;
 
 static struct net_ipv6_reassembly
 reassembly[CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
 
+/* Slots that are in use are found through the hash table, the others are
+ * kept in the free list. Both, and the slots themselves, are protected by
+ * the reassembly lock, as the timeouts run in the system work queue.
+ */
+static sys_slist_t reassembly_hash[REASSEMBLY_HASH_SIZE];
+static sys_slist_t reassembly_free_list;
+static uint32_t reassembly_hash_seed;
+
+static K_MUTEX_DEFINE(reassembly_lock);
+
 int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, uint16_t *next_hdr_off,
 			       uint16_t *last_hdr_off)
 {
@@ -120,86 +132,122 @@ fail:
 	return -EINVAL;
 }
 
+static inline uint32_t reassembly_hash_mix(uint32_t hash, uint32_t word)
+{
+	word *= 0xcc9e2d51U;
+	word = (word << 15) | (word >> 17);
+	word *= 0x1b873593U;
+
+	hash ^= word;
+	hash = (hash << 13) | (hash >> 19);
+
+	return hash * 5U + 0xe6546b64U;
+}
+
+/* MurmurHash3 of the fragment key, seeded at boot */
+static uint32_t reassembly_hash_calc(uint32_t id, struct in6_addr *src,
+				     struct in6_addr *dst)
+{
+	uint32_t hash = reassembly_hash_seed;
+	int i;
+
+	hash = reassembly_hash_mix(hash, id);
+
+	for (i = 0; i < 4; i++) {
+		hash = reassembly_hash_mix(hash, UNALIGNED_GET(&src->s6_addr32[i]));
+		hash = reassembly_hash_mix(hash, UNALIGNED_GET(&dst->s6_addr32[i]));
+	}
+
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+/* Must be invoked with the reassembly lock held */
 static struct net_ipv6_reassembly *reassembly_get(uint32_t id,
 						  struct in6_addr *src,
 						  struct in6_addr *dst)
 {
-	int i, avail = -1;
-
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv6_addr_cmp(src, &reassembly[i].src) &&
-		    net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			return &reassembly[i];
-		}
-
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
-			continue;
-		}
-
-		if (avail < 0) {
-			avail = i;
+	uint32_t hash = reassembly_hash_calc(id, src, dst);
+	sys_slist_t *bucket = &reassembly_hash[hash & (REASSEMBLY_HASH_SIZE - 1)];
+	struct net_ipv6_reassembly *reass;
+	sys_snode_t *free_node;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, reass, node) {
+		if (reass->hash == hash && reass->id == id &&
+		    net_ipv6_addr_cmp(src, &reass->src) &&
+		    net_ipv6_addr_cmp(dst, &reass->dst)) {
+			return reass;
 		}
 	}
 
-	if (avail < 0) {
+	free_node = sys_slist_get(&reassembly_free_list);
+	if (!free_node) {
 		return NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, IPV6_REASSEMBLY_TIMEOUT);
+	reass = CONTAINER_OF(free_node, struct net_ipv6_reassembly, node);
 
-	net_ipaddr_copy(&reassembly[avail].src, src);
-	net_ipaddr_copy(&reassembly[avail].dst, dst);
+	k_work_reschedule(&reass->timer, IPV6_REASSEMBLY_TIMEOUT);
 
-	reassembly[avail].id = id;
+	net_ipaddr_copy(&reass->src, src);
+	net_ipaddr_copy(&reass->dst, dst);
 
-	return &reassembly[avail];
-}
+	reass->id = id;
+	reass->hash = hash;
 
-static bool reassembly_cancel(uint32_t id,
-			      struct in6_addr *src,
-			      struct in6_addr *dst)
-{
-	int i, j;
+	sys_slist_prepend(bucket, &reass->node);
 
-	NET_DBG("Cancel 0x%x", id);
+	return reass;
+}
 
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+/* Must be invoked with the reassembly lock held */
+static void reassembly_free(struct net_ipv6_reassembly *reass)
+{
+	sys_slist_find_and_remove(&reassembly_hash[reass->hash &
+						   (REASSEMBLY_HASH_SIZE - 1)],
+				  &reass->node);
 
-		if (reassembly[i].id != id ||
-		    !net_ipv6_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
-		}
+	reass->id = 0U;
+	reass->count = 0U;
+	reass->received = 0U;
+	reass->total = 0U;
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+	sys_slist_prepend(&reassembly_free_list, &reass->node);
+}
 
-		NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
-			reassembly[i].id, remaining);
+/* Must be invoked with the reassembly lock held */
+static void reassembly_cancel(struct net_ipv6_reassembly *reass)
+{
+	int32_t remaining;
+	int j;
 
-		reassembly[i].id = 0U;
+	NET_DBG("Cancel 0x%x", reass->id);
 
-		for (j = 0; j < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	remaining = k_ticks_to_ms_ceil32(
+		k_work_delayable_remaining_get(&reass->timer));
+	k_work_cancel_delayable(&reass->timer);
 
-			NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
-				j, reassembly[i].pkt[j],
-				net_pkt_get_len(reassembly[i].pkt[j]));
+	NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
+		reass->id, remaining);
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	for (j = 0; j < reass->count; j++) {
+		if (!reass->pkt[j]) {
+			continue;
 		}
 
-		return true;
+		NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
+			j, reass->pkt[j], net_pkt_get_len(reass->pkt[j]));
+
+		net_pkt_unref(reass->pkt[j]);
+		reass->pkt[j] = NULL;
 	}
 
-	return false;
+	reassembly_free(reass);
 }
 
 static void reassembly_info(char *str, struct net_ipv6_reassembly *reass)
@@ -216,16 +264,82 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv6_reassembly *reass =
 		CONTAINER_OF(work, struct net_ipv6_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The packet was completed, or the slot reused, while this was
+	 * waiting for the lock.
+	 */
+	if (reass->count == 0U ||
+	    k_work_delayable_remaining_get(&reass->timer)) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv6 Time Exceeded only if we received the first fragment (RFC 2460 Sec. 5) */
-	if (reass->pkt[0] && net_pkt_ipv6_fragment_offset(reass->pkt[0]) == 0) {
+	if (net_pkt_ipv6_fragment_offset(reass->pkt[0]) == 0) {
 		net_icmpv6_send_error(reass->pkt[0], NET_ICMPV6_TIME_EXCEEDED, 1, 0);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 }
 
+/* Removes the first len bytes of the packet by moving the start of its
+ * buffers, so that the data that follows stays where it is.
+ */
+static int reassembly_strip(struct net_pkt *pkt, size_t len)
+{
+	while (len > 0 && pkt->buffer) {
+		struct net_buf *buf = pkt->buffer;
+
+		if (buf->len > len) {
+			net_buf_pull(buf, len);
+			len = 0;
+			break;
+		}
+
+		len -= buf->len;
+		pkt->buffer = buf->frags;
+		buf->frags = NULL;
+		net_buf_unref(buf);
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return len > 0 ? -ENOBUFS : 0;
+}
+
+/* Removes the fragment header of the first fragment. When the headers in
+ * front of it are in the first buffer, they are moved over the fragment
+ * header instead of moving the payload that follows it.
+ */
+static int reassembly_remove_frag_hdr(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t start = net_pkt_ipv6_fragment_start(pkt);
+
+	if (start + sizeof(struct net_ipv6_frag_hdr) <= buf->len) {
+		memmove(buf->data + sizeof(struct net_ipv6_frag_hdr),
+			buf->data, start);
+		net_buf_pull(buf, sizeof(struct net_ipv6_frag_hdr));
+		net_pkt_cursor_init(pkt);
+
+		return 0;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, start)) {
+		return -ENOBUFS;
+	}
+
+	return net_pkt_pull(pkt, sizeof(struct net_ipv6_frag_hdr));
+}
+
+/* Must be invoked with the reassembly lock held */
 static void reassemble_packet(struct net_ipv6_reassembly *reass)
 {
 	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv6_access, struct net_ipv6_hdr);
@@ -244,20 +358,18 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 
 	NET_ASSERT(reass->pkt[0]);
 
+	/* The buffers of the fragments are chained after the ones of the
+	 * first fragment, none of the payload is copied.
+	 */
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
 
 	/* We start from 2nd packet which is then appended to
 	 * the first one.
 	 */
-	for (i = 1; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
+	for (i = 1; i < reass->count; i++) {
 		int removed_len;
 
 		pkt = reass->pkt[i];
-		if (!pkt) {
-			break;
-		}
-
-		net_pkt_cursor_init(pkt);
 
 		/* Get rid of IPv6 and fragment header which are at
 		 * the beginning of the fragment.
@@ -268,9 +380,9 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 		NET_DBG("Removing %d bytes from start of pkt %p",
 			removed_len, pkt->buffer);
 
-		if (net_pkt_pull(pkt, removed_len)) {
+		if (reassembly_strip(pkt, removed_len) || !pkt->buffer) {
 			NET_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
+			reassembly_cancel(reass);
 			return;
 		}
 
@@ -287,6 +399,8 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	reassembly_free(reass);
+
 	/* Next we need to strip away the fragment header from the first packet
 	 * and set the various pointers and values in packet.
 	 */
@@ -306,7 +420,7 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 
 	next_hdr = ipv6.frag_hdr->nexthdr;
 
-	if (net_pkt_pull(pkt, sizeof(struct net_ipv6_frag_hdr))) {
+	if (reassembly_remove_frag_hdr(pkt)) {
 		NET_ERR("Failed to remove fragment header");
 		goto error;
 	}
@@ -358,6 +472,8 @@ void net_ipv6_frag_foreach(net_ipv6_frag_cb_t cb, void *user_data)
 {
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	for (i = 0; reassembly_init_done &&
 		     i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
 		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
@@ -366,93 +482,91 @@ void net_ipv6_frag_foreach(net_ipv6_frag_cb_t cb, void *user_data)
 
 		cb(&reassembly[i], user_data);
 	}
+
+	k_mutex_unlock(&reassembly_lock);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+static uint32_t fragment_end(struct net_pkt *pkt)
+{
+	return net_pkt_ipv6_fragment_offset(pkt) + net_pkt_get_len(pkt) -
+	       net_pkt_ipv6_fragment_start(pkt) -
+	       sizeof(struct net_ipv6_frag_hdr);
+}
+
+/* Store the fragment in the reassembly, in offset order. Fragments can
+ * arrive in any order, for example in reverse order:
+ *   1 -> Fragment3(M=0, offset=x2)
+ *   2 -> Fragment2(M=1, offset=x1)
+ *   3 -> Fragment1(M=1, offset=0)
+ * Overlapping fragments are refused (RFC 8200 lets us drop them), so once
+ * the last fragment has told the length of the packet, it is complete
+ * when that many bytes have been received.
  * Return:
- * - a negative value if the fragments are erroneous and must be dropped
- * - zero if we are expecting more fragments
- * - a positive value if we can proceed with the reassembly
+ * - -EBADMSG if the fragments are erroneous and must be dropped
+ * - -ENOMEM if there is no room left for the fragment
+ * - zero if the fragment was stored
  */
-static int fragments_are_ready(struct net_ipv6_reassembly *reass)
+static int fragment_insert(struct net_ipv6_reassembly *reass,
+			   struct net_pkt *pkt)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
-	int i;
+	uint32_t offset = net_pkt_ipv6_fragment_offset(pkt);
+	int payload_len;
+	int lo = 0, hi = reass->count;
 
-	/* Fragments can arrive in any order, for example in reverse order:
-	 *   1 -> Fragment3(M=0, offset=x2)
-	 *   2 -> Fragment2(M=1, offset=x1)
-	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
-	 */
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
+	payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt);
+	payload_len -= sizeof(struct net_ipv6_frag_hdr);
+	if (payload_len < 0) {
+		return -EBADMSG;
+	}
 
-		if (!pkt) {
-			break;
+	/* Find the first fragment that does not start before this one */
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (net_pkt_ipv6_fragment_offset(reass->pkt[mid]) < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
+	}
 
-		offset = net_pkt_ipv6_fragment_offset(pkt);
+	/* Overlapping or duplicated */
+	if ((lo > 0 && fragment_end(reass->pkt[lo - 1]) > offset) ||
+	    (lo < reass->count &&
+	     (net_pkt_ipv6_fragment_offset(reass->pkt[lo]) == offset ||
+	      net_pkt_ipv6_fragment_offset(reass->pkt[lo]) <
+	      offset + payload_len))) {
+		return -EBADMSG;
+	}
 
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated
-			 * According to RFC8200 we can drop it
-			 */
+	if (net_pkt_ipv6_fragment_more(pkt)) {
+		if (reass->total && offset + payload_len > reass->total) {
 			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
 		}
-
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt);
-		payload_len -= sizeof(struct net_ipv6_frag_hdr);
-		if (payload_len < 0) {
+	} else {
+		/* Only one last fragment, and nothing after it */
+		if (reass->total || lo < reass->count) {
 			return -EBADMSG;
 		}
-
-		expected_offset += payload_len;
-		more = net_pkt_ipv6_fragment_more(pkt);
 	}
 
-	if (more) {
-		return 0;
+	if (reass->count == CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
+		return -ENOMEM;
 	}
 
-	return 1;
-}
+	NET_DBG("Storing pkt %p to slot %d offset %d", pkt, lo, offset);
 
-static int shift_packets(struct net_ipv6_reassembly *reass, int pos)
-{
-	int i;
+	memmove(&reass->pkt[lo + 1], &reass->pkt[lo],
+		sizeof(void *) * (reass->count - lo));
+	reass->pkt[lo] = pkt;
+	reass->count++;
 
-	for (i = pos + 1; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			NET_DBG("Moving [%d] %p (offset 0x%x) to [%d]",
-				pos, reass->pkt[pos],
-				net_pkt_ipv6_fragment_offset(reass->pkt[pos]),
-				pos + 1);
-
-			/* pkt[i] is free, so shift everything between
-			 * [pos] and [i - 1] by one element
-			 */
-			memmove(&reass->pkt[pos + 1], &reass->pkt[pos],
-				sizeof(void *) * (i - pos));
-
-			/* pkt[pos] is now free */
-			reass->pkt[pos] = NULL;
-
-			return 0;
-		}
+	reass->received += payload_len;
+	if (!net_pkt_ipv6_fragment_more(pkt)) {
+		reass->total = offset + payload_len;
 	}
 
-	/* We do not have free space left in the array */
-	return -ENOMEM;
+	return 0;
 }
 
 enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
@@ -460,13 +574,15 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 					      uint8_t nexthdr)
 {
 	struct net_ipv6_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_DROP;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint32_t id;
 	int ret;
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	if (!reassembly_init_done) {
 		/* Static initializing does not work here because of the array
 		 * so we must do it at runtime.
@@ -474,8 +590,10 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 		for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
 			k_work_init_delayable(&reassembly[i].timer,
 					      reassembly_timeout);
+			sys_slist_append(&reassembly_free_list, &reassembly[i].node);
 		}
 
+		reassembly_hash_seed = sys_rand32_get();
 		reassembly_init_done = true;
 	}
 
@@ -487,14 +605,14 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 	if (net_pkt_skip(pkt, 1) || /* reserved */
 	    net_pkt_read_be16(pkt, &flag) ||
 	    net_pkt_read_be32(pkt, &id)) {
-		goto drop;
+		goto out;
 	}
 
 	reass = reassembly_get(id, (struct in6_addr *)hdr->src,
 			       (struct in6_addr *)hdr->dst);
 	if (!reass) {
 		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
-		goto drop;
+		goto out;
 	}
 
 	more = flag & 0x01;
@@ -513,55 +631,26 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 	/* The fragments might come in wrong order so place them
 	 * in reassembly chain in correct order.
 	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		if (reass->pkt[i]) {
-			if (net_pkt_ipv6_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv6_fragment_offset(pkt)) {
-				continue;
-			}
-
-			/* Make room for this fragment. If there is no room,
-			 * then it will discard the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
-		}
-
-		NET_DBG("Storing pkt %p to slot %d offset %d",
-			pkt, i, net_pkt_ipv6_fragment_offset(pkt));
-		reass->pkt[i] = pkt;
-		found = true;
-
-		break;
-	}
-
-	if (!found) {
+	ret = fragment_insert(reass, pkt);
+	if (ret == -ENOMEM) {
 		/* We could not add this fragment into our saved fragment
 		 * list. We must discard the whole packet at this point.
 		 */
 		NET_DBG("No slots available for 0x%x", reass->id);
-		net_pkt_unref(pkt);
 		goto drop;
-	}
-
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
+	} else if (ret < 0) {
 		NET_DBG("Reassembled IPv6 verify failed, dropping id %u",
 			reass->id);
+		goto drop;
+	}
 
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
+	verdict = NET_OK;
 
-		net_pkt_unref(pkt);
-		goto drop;
-	} else if (ret == 0) {
+	if (reass->total == 0U || reass->received < reass->total) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		NET_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
@@ -569,17 +658,18 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
 
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
-	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
-	}
+	/* The whole packet is dropped, including this fragment */
+	net_pkt_unref(pkt);
+	reassembly_cancel(reass);
+	verdict = NET_OK;
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 
-	return NET_DROP;
+	return verdict;
 }
 
 #define BUF_ALLOC_TIMEOUT K_MSEC(100)
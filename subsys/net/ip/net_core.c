@@ -384,7 +384,7 @@ void net_process_rx_packet(struct net_pkt *pkt)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+static uint8_t net_rx_tc_update(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
@@ -399,6 +399,13 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_rx_tc_update(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
 	} else {
@@ -443,6 +450,67 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 	return 0;
 }
 
+#if defined(CONFIG_NET_BATCH)
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+	size_t queued = 0;
+
+	if (!pkts || !iface) {
+		return -EINVAL;
+	}
+
+	if (!net_if_flag_is_set(iface, NET_IF_UP)) {
+		return -ENETDOWN;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+
+		if (!pkt) {
+			continue;
+		}
+
+		if (net_pkt_is_empty(pkt)) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		net_pkt_set_overwrite(pkt, true);
+		net_pkt_cursor_init(pkt);
+
+		if (IS_ENABLED(CONFIG_NET_ROUTING)) {
+			net_pkt_set_orig_iface(pkt, iface);
+		}
+
+		net_pkt_set_iface(pkt, iface);
+
+		if (!net_pkt_filter_recv_ok(pkt)) {
+			/* silently drop the packet */
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		(void)net_rx_tc_update(iface, pkt);
+
+		if (NET_TC_RX_COUNT == 0) {
+			net_process_rx_packet(pkt);
+		} else {
+			/* Compact the array in place, for the queueing below */
+			pkts[queued++] = pkt;
+		}
+	}
+
+	NET_DBG("iface %p %zu pkts, %zu queued", iface, count, queued);
+
+	if (queued > 0) {
+		net_tc_submit_batch_to_rx_queue(pkts, queued);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_BATCH */
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
@@ -207,6 +207,28 @@ static void update_txtime_stats_detail(struct net_pkt *pkt,
 	}
 }
 
+static void net_if_tx_done(struct net_if *iface, struct net_pkt *pkt,
+			   struct net_context *context,
+			   struct net_linkaddr *ll_dst, int status)
+{
+	if (status < 0) {
+		net_pkt_unref(pkt);
+	} else {
+		net_stats_update_bytes_sent(iface, status);
+	}
+
+	if (context) {
+		NET_DBG("Calling context send cb %p status %d",
+			context, status);
+
+		net_context_send_cb(context, status);
+	}
+
+	if (ll_dst->addr) {
+		net_if_call_link_cb(iface, ll_dst, status);
+	}
+}
+
 static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct net_linkaddr ll_dst = {
@@ -300,25 +322,61 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 		status = -ENETDOWN;
 	}
 
-	if (status < 0) {
-		net_pkt_unref(pkt);
-	} else {
-		net_stats_update_bytes_sent(iface, status);
-	}
+	net_if_tx_done(iface, pkt, context, &ll_dst, status);
 
-	if (context) {
-		NET_DBG("Calling context send cb %p status %d",
-			context, status);
+	return true;
+}
 
-		net_context_send_cb(context, status);
+#if defined(CONFIG_NET_BATCH)
+static void net_if_tx_batch(struct net_if *iface, struct net_pkt **pkts,
+			    size_t count)
+{
+	struct net_linkaddr_storage ll_dst_storage[CONFIG_NET_BATCH_SIZE];
+	struct net_linkaddr ll_dst[CONFIG_NET_BATCH_SIZE];
+	struct net_context *context[CONFIG_NET_BATCH_SIZE];
+	int status[CONFIG_NET_BATCH_SIZE];
+	size_t i;
+
+	__ASSERT_NO_MSG(count <= CONFIG_NET_BATCH_SIZE);
+
+	for (i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+
+		debug_check_packet(pkt);
+
+		ll_dst[i].addr = NULL;
+		if (!sys_slist_is_empty(&link_callbacks) &&
+		    net_linkaddr_set(&ll_dst_storage[i],
+				     net_pkt_lladdr_dst(pkt)->addr,
+				     net_pkt_lladdr_dst(pkt)->len) == 0) {
+			ll_dst[i].addr = ll_dst_storage[i].addr;
+			ll_dst[i].len = ll_dst_storage[i].len;
+			ll_dst[i].type = net_pkt_lladdr_dst(pkt)->type;
+		}
+
+		context[i] = net_pkt_context(pkt);
+
+		if (IS_ENABLED(CONFIG_NET_TCP) &&
+		    net_pkt_family(pkt) != AF_UNSPEC) {
+			net_pkt_set_queued(pkt, false);
+		}
+
+		status[i] = -ENETDOWN;
 	}
 
-	if (ll_dst.addr) {
-		net_if_call_link_cb(iface, &ll_dst, status);
+	if (net_if_flag_is_set(iface, NET_IF_LOWER_UP)) {
+		net_if_l2(iface)->send_batch(iface, pkts, status, count);
+	} else {
+		/* Drop packets if interface is not up */
+		NET_WARN("iface %p is down", iface);
 	}
 
-	return true;
+	for (i = 0; i < count; i++) {
+		net_if_tx_done(iface, pkts[i], context[i], &ll_dst[i],
+			       status[i]);
+	}
 }
+#endif /* CONFIG_NET_BATCH */
 
 void net_process_tx_packet(struct net_pkt *pkt)
 {
@@ -335,6 +393,44 @@ void net_process_tx_packet(struct net_pkt *pkt)
 #endif
 }
 
+#if defined(CONFIG_NET_BATCH)
+/* Packets for an interface whose L2 can send in batches are given to it
+ * in runs of consecutive packets for the same interface.
+ */
+void net_process_tx_batch(struct net_pkt **pkts, size_t count)
+{
+	size_t start = 0;
+
+	while (start < count) {
+		struct net_if *iface = net_pkt_iface(pkts[start]);
+		size_t end = start + 1;
+
+		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS) ||
+		    !net_if_l2(iface) || !net_if_l2(iface)->send_batch) {
+			net_process_tx_packet(pkts[start]);
+			start++;
+			continue;
+		}
+
+		while (end < count && end - start < CONFIG_NET_BATCH_SIZE &&
+		       net_pkt_iface(pkts[end]) == iface) {
+			end++;
+		}
+
+		for (size_t i = start; i < end; i++) {
+			net_pkt_set_tx_stats_tick(pkts[i], k_cycle_get_32());
+		}
+
+		net_if_tx_batch(iface, &pkts[start], end - start);
+
+#if defined(CONFIG_NET_POWER_MANAGEMENT)
+		iface->tx_pending -= end - start;
+#endif
+		start = end;
+	}
+}
+#endif /* CONFIG_NET_BATCH */
+
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!net_pkt_filter_send_ok(pkt)) {
@@ -378,6 +474,139 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
+#if defined(CONFIG_NET_BATCH)
+void net_if_queue_tx_batch(struct net_if *iface, struct net_pkt **pkts,
+			   size_t count)
+{
+	size_t queued = 0;
+	int run_tc = -1;
+
+	for (size_t i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+		uint8_t prio, tc;
+
+		if (!net_pkt_filter_send_ok(pkt)) {
+			/* silently drop the packet */
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		prio = net_pkt_priority(pkt);
+		tc = net_tx_priority2tc(prio);
+
+		net_stats_update_tc_sent_pkt(iface, tc);
+		net_stats_update_tc_sent_bytes(iface, tc, net_pkt_get_len(pkt));
+		net_stats_update_tc_sent_priority(iface, tc, prio);
+
+		if (IS_ENABLED(CONFIG_NET_TC_SKIP_FOR_HIGH_PRIO) &&
+		    prio == NET_PRIORITY_CA && NET_TC_TX_COUNT > 0) {
+			net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
+
+			net_if_tx(net_pkt_iface(pkt), pkt);
+			continue;
+		}
+
+		/* Queue the packets gathered so far when the class changes,
+		 * reusing the start of the array for them. Without TX queues
+		 * they are all sent together below.
+		 */
+		if (tc != run_tc && queued > 0 && NET_TC_TX_COUNT > 0) {
+			net_tc_submit_batch_to_tx_queue(run_tc, pkts, queued);
+			queued = 0;
+		}
+
+#if defined(CONFIG_NET_POWER_MANAGEMENT)
+		iface->tx_pending++;
+#endif
+		run_tc = tc;
+		pkts[queued++] = pkt;
+	}
+
+	if (queued == 0) {
+		return;
+	}
+
+	if (NET_TC_TX_COUNT == 0) {
+		net_process_tx_batch(pkts, queued);
+	} else {
+		net_tc_submit_batch_to_tx_queue(run_tc, pkts, queued);
+	}
+}
+
+/* Held packets cannot be freed, keep enough of the TX pools for the
+ * packets that are still to be allocated.
+ */
+#define TX_BATCH_MAX MAX(MIN(CONFIG_NET_BATCH_SIZE,			\
+			     MIN(CONFIG_NET_PKT_TX_COUNT,		\
+				 CONFIG_NET_BUF_TX_COUNT) / 2), 1)
+
+static void tx_batch_flush(struct net_if_tx_batch *batch)
+{
+	if (batch->count > 0) {
+		net_if_queue_tx_batch(batch->iface, batch->pkts, batch->count);
+		batch->count = 0;
+	}
+}
+
+void net_if_tx_batch_begin(struct net_if_tx_batch *batch,
+			   struct net_context *context)
+{
+	batch->thread = k_current_get();
+	batch->context = context;
+	batch->iface = NULL;
+	batch->count = 0;
+
+	k_mutex_lock(&lock, K_FOREVER);
+	context->tx_batch = batch;
+	k_mutex_unlock(&lock);
+}
+
+void net_if_tx_batch_end(struct net_if_tx_batch *batch)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+
+	batch->context->tx_batch = NULL;
+	tx_batch_flush(batch);
+
+	k_mutex_unlock(&lock);
+}
+
+/* Called with the lock held, returns true if the packet was taken */
+static bool tx_batch_hold(struct net_if *iface, struct net_pkt *pkt,
+			  struct net_context *context)
+{
+	struct net_if_tx_batch *batch;
+
+	if (!context || !context->tx_batch) {
+		return false;
+	}
+
+	batch = context->tx_batch;
+	if (batch->thread != k_current_get()) {
+		return false;
+	}
+
+	if (batch->count > 0 && batch->iface != iface) {
+		tx_batch_flush(batch);
+	}
+
+	batch->iface = iface;
+	batch->pkts[batch->count++] = pkt;
+
+	if (batch->count >= TX_BATCH_MAX) {
+		tx_batch_flush(batch);
+	}
+
+	return true;
+}
+#else
+static inline bool tx_batch_hold(struct net_if *iface, struct net_pkt *pkt,
+				 struct net_context *context)
+{
+	return false;
+}
+#endif /* CONFIG_NET_BATCH */
+
 void net_if_stats_reset(struct net_if *iface)
 {
 #if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
@@ -518,7 +747,9 @@ done:
 		}
 	} else if (verdict == NET_OK) {
 		/* Packet is ready to be sent by L2, let's queue */
-		net_if_queue_tx(iface, pkt);
+		if (!tx_batch_hold(iface, pkt, context)) {
+			net_if_queue_tx(iface, pkt);
+		}
 	}
 
 	k_mutex_unlock(&lock);
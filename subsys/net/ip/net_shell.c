@@ -2229,6 +2229,92 @@ static int cmd_net_dns_cancel(const struct shell *sh, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const char *query, enum dns_query_type type,
+			 const struct dns_addrinfo *addrs, int count,
+			 uint32_t ttl, void *user_data)
+{
+	const struct shell *sh = user_data;
+	char addr[NET_IPV6_ADDR_LEN];
+	int i;
+
+	PR("%-32s %-4s %6u  ", query,
+	   type == DNS_QUERY_TYPE_AAAA ? "AAAA" : "A", ttl);
+
+	if (count == 0) {
+		PR("<none>\n");
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (addrs[i].ai_family == AF_INET6) {
+			net_addr_ntop(AF_INET6,
+				      &net_sin6(&addrs[i].ai_addr)->sin6_addr,
+				      addr, sizeof(addr));
+		} else {
+			net_addr_ntop(AF_INET,
+				      &net_sin(&addrs[i].ai_addr)->sin_addr,
+				      addr, sizeof(addr));
+		}
+
+		PR("%s%s", i > 0 ? " " : "", addr);
+	}
+
+	PR("\n");
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *sh, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	PR("%-32s %-4s %6s  %s\n", "Name", "Type", "TTL", "Addresses");
+
+	if (dns_resolve_cache_foreach(dns_cache_cb, (void *)sh) == 0) {
+		PR("No cached entries.\n");
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_flush(const struct shell *sh, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	int ret;
+
+	if (argc > 1) {
+		ret = dns_resolve_cache_remove(argv[1]);
+		if (ret < 0) {
+			PR_WARNING("'%s' is not cached.\n", argv[1]);
+		} else {
+			PR("Removed %d entries.\n", ret);
+		}
+
+		return 0;
+	}
+
+	(void)dns_resolve_cache_flush();
+
+	PR("DNS cache flushed.\n");
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns_query(const struct shell *sh, size_t argc,
 			     char *argv[])
 {
@@ -6232,8 +6318,14 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 );
 
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, NULL, "Show the cached DNS results.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
+	SHELL_CMD(flush, NULL,
+		  "'net dns flush [hostname]' removes the cached results for "
+		  "a host name, or all of them.",
+		  cmd_net_dns_flush),
 	SHELL_CMD(query, NULL,
 		  "'net dns <hostname> [A or AAAA]' queries IPv4 address "
 		  "(default) or IPv6 address for a host name.",
@@ -13,6 +13,8 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/sys/byteorder.h>
 
 #include "net_private.h"
 #include "net_stats.h"
@@ -21,15 +23,24 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * With CONFIG_NET_TC_RX_RSS, the RX queue of each class is "q[y.z]" where z
+ * is the flow queue index.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.z]")
+
+/* Number of RX queues, each with its own thread, per traffic class */
+#if defined(CONFIG_NET_TC_RX_RSS)
+#define NET_TC_RX_QUEUES CONFIG_NET_TC_RX_RSS_QUEUES
+#else
+#define NET_TC_RX_QUEUES 1
+#endif
 
 /* Stacks for TX work queue */
 K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT * NET_TC_RX_QUEUES,
 			    CONFIG_NET_RX_STACK_SIZE);
 
 #if NET_TC_TX_COUNT > 0
@@ -37,7 +48,7 @@ static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_COUNT * NET_TC_RX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -45,6 +56,21 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 {
 	k_fifo_put(queue, pkt);
 }
+
+#if defined(CONFIG_NET_BATCH)
+/* Chain the packets through their fifo word and queue them all at once,
+ * so that the queue is locked and its thread woken up only once.
+ */
+static void submit_batch_to_queue(struct k_fifo *queue, struct net_pkt **pkts,
+				  size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		pkts[i]->fifo = i + 1 < count ? (intptr_t)pkts[i + 1] : 0;
+	}
+
+	k_fifo_put_list(queue, pkts[0], pkts[count - 1]);
+}
+#endif
 #endif
 
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
@@ -60,18 +86,227 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 	return true;
 }
 
+#if defined(CONFIG_NET_TC_RX_RSS)
+static inline uint32_t rx_flow_mix(uint32_t hash, uint32_t word)
+{
+	hash ^= word;
+	hash *= 0x9e3779b1U;
+
+	return (hash << 13) | (hash >> 19);
+}
+
+static uint32_t rx_flow_mix_bytes(uint32_t hash, const uint8_t *data,
+				  size_t len)
+{
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = rx_flow_mix(hash, UNALIGNED_GET((uint32_t *)&data[i]));
+	}
+
+	return hash;
+}
+
+/* Skip the L2 header, returning the Ethernet type of what follows or 0
+ * if it is not known.
+ */
+static uint16_t rx_flow_l3_type(struct net_if *iface, const uint8_t **data,
+				size_t *len)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		uint16_t type;
+
+		if (*len < sizeof(struct net_eth_hdr)) {
+			return 0;
+		}
+
+		type = sys_get_be16(&(*data)[12]);
+		*data += sizeof(struct net_eth_hdr);
+		*len -= sizeof(struct net_eth_hdr);
+
+		if (type == NET_ETH_PTYPE_VLAN) {
+			if (*len < 4) {
+				return 0;
+			}
+
+			type = sys_get_be16(&(*data)[2]);
+			*data += 4;
+			*len -= 4;
+		}
+
+		return type;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	/* Loopback and other raw IP interfaces */
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY) && *len > 0) {
+		return ((*data)[0] >> 4) == 6 ? NET_ETH_PTYPE_IPV6 :
+						NET_ETH_PTYPE_IP;
+	}
+#endif
+
+	return 0;
+}
+
+/* Hash the addresses, protocol and ports of a packet that has not been
+ * through the L2 yet, so that all the packets of a flow end up in the
+ * same queue. The headers must be in the first buffer, anything that
+ * can't be parsed goes to the first queue.
+ */
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	const uint8_t *data = pkt->buffer ? pkt->buffer->data : NULL;
+	size_t len = pkt->buffer ? pkt->buffer->len : 0;
+	const uint8_t *ports = NULL;
+	uint32_t hash;
+	uint16_t type;
+	uint8_t proto;
+
+	if (data == NULL) {
+		return 0;
+	}
+
+	type = rx_flow_l3_type(net_pkt_iface(pkt), &data, &len);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && type == NET_ETH_PTYPE_IP) {
+		size_t hdr_len;
+
+		if (len < sizeof(struct net_ipv4_hdr)) {
+			return 0;
+		}
+
+		hdr_len = (data[0] & 0x0f) * 4U;
+		proto = data[9];
+		hash = rx_flow_mix_bytes(proto, &data[12],
+					 2 * sizeof(struct in_addr));
+
+		/* Only the first fragment has the ports, so leave them out
+		 * for all fragments. A datagram that is fragmented can then
+		 * be processed out of order with the unfragmented ones of
+		 * the same flow.
+		 */
+		if (!(sys_get_be16(&data[6]) & 0x3fff) && len >= hdr_len + 4U) {
+			ports = &data[hdr_len];
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && type == NET_ETH_PTYPE_IPV6) {
+		if (len < sizeof(struct net_ipv6_hdr)) {
+			return 0;
+		}
+
+		proto = data[6];
+
+		/* Like IPv4 fragments, hash fragments by the protocol they
+		 * carry and without ports. Ports behind other extension
+		 * headers are not looked for.
+		 */
+		if (proto == NET_IPV6_NEXTHDR_FRAG) {
+			if (len < sizeof(struct net_ipv6_hdr) + 1U) {
+				return 0;
+			}
+
+			proto = data[sizeof(struct net_ipv6_hdr)];
+		} else if (len >= sizeof(struct net_ipv6_hdr) + 4U) {
+			ports = &data[sizeof(struct net_ipv6_hdr)];
+		}
+
+		hash = rx_flow_mix_bytes(proto, &data[8],
+					 2 * sizeof(struct in6_addr));
+	} else {
+		return 0;
+	}
+
+	if (ports != NULL && (proto == IPPROTO_TCP || proto == IPPROTO_UDP)) {
+		hash = rx_flow_mix(hash, UNALIGNED_GET((uint32_t *)ports));
+	}
+
+	/* Final avalanche, so that the low bits depend on all the input */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+
+	return hash;
+}
+#endif /* CONFIG_NET_TC_RX_RSS */
+
+#if NET_TC_RX_COUNT > 0
+static int rx_queue_index(uint8_t tc, struct net_pkt *pkt)
+{
+	int queue = tc * NET_TC_RX_QUEUES;
+
+#if defined(CONFIG_NET_TC_RX_RSS)
+	queue += rx_flow_hash(pkt) % NET_TC_RX_QUEUES;
+#else
+	ARG_UNUSED(pkt);
+#endif
+
+	return queue;
+}
+#endif
+
 void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_RX_COUNT > 0
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+	submit_to_queue(&rx_classes[rx_queue_index(tc, pkt)].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
 #endif
 }
 
+#if defined(CONFIG_NET_BATCH)
+void net_tc_submit_batch_to_tx_queue(uint8_t tc, struct net_pkt **pkts,
+				     size_t count)
+{
+#if NET_TC_TX_COUNT > 0
+	for (size_t i = 0; i < count; i++) {
+		net_pkt_set_tx_stats_tick(pkts[i], k_cycle_get_32());
+	}
+
+	submit_batch_to_queue(&tx_classes[tc].fifo, pkts, count);
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(pkts);
+	ARG_UNUSED(count);
+#endif
+}
+
+/* Each run of consecutive packets going to the same queue is queued at
+ * once, which keeps the order of the packets within every queue.
+ */
+void net_tc_submit_batch_to_rx_queue(struct net_pkt **pkts, size_t count)
+{
+#if NET_TC_RX_COUNT > 0
+	size_t start = 0;
+	int queue = -1;
+
+	for (size_t i = 0; i < count; i++) {
+		uint8_t tc = net_rx_priority2tc(net_pkt_priority(pkts[i]));
+		int next = rx_queue_index(tc, pkts[i]);
+
+		net_pkt_set_rx_stats_tick(pkts[i], k_cycle_get_32());
+
+		if (next != queue && i > start) {
+			submit_batch_to_queue(&rx_classes[queue].fifo,
+					      &pkts[start], i - start);
+			start = i;
+		}
+
+		queue = next;
+	}
+
+	if (count > start) {
+		submit_batch_to_queue(&rx_classes[queue].fifo, &pkts[start],
+				      count - start);
+	}
+#else
+	ARG_UNUSED(pkts);
+	ARG_UNUSED(count);
+#endif
+}
+#endif /* CONFIG_NET_BATCH */
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -255,6 +490,27 @@ static void tc_rx_handler(struct k_fifo *fifo)
 #if NET_TC_TX_COUNT > 0
 static void tc_tx_handler(struct k_fifo *fifo)
 {
+#if defined(CONFIG_NET_BATCH)
+	struct net_pkt *pkts[CONFIG_NET_BATCH_SIZE];
+	size_t count;
+
+	while (1) {
+		pkts[0] = k_fifo_get(fifo, K_FOREVER);
+		if (pkts[0] == NULL) {
+			continue;
+		}
+
+		/* Take whatever else is already queued, up to a batch */
+		for (count = 1; count < ARRAY_SIZE(pkts); count++) {
+			pkts[count] = k_fifo_get(fifo, K_NO_WAIT);
+			if (pkts[count] == NULL) {
+				break;
+			}
+		}
+
+		net_process_tx_batch(pkts, count);
+	}
+#else
 	struct net_pkt *pkt;
 
 	while (1) {
@@ -265,6 +521,7 @@ static void tc_tx_handler(struct k_fifo *fifo)
 
 		net_process_tx_packet(pkt);
 	}
+#endif
 }
 #endif
 
@@ -336,6 +593,10 @@ void net_tc_rx_init(void)
 	return;
 #else
 	int i;
+#if defined(CONFIG_NET_TC_RX_RSS) && defined(CONFIG_SCHED_CPU_MASK) && \
+	CONFIG_MP_MAX_NUM_CPUS > 1
+	int ret;
+#endif
 
 	BUILD_ASSERT(NET_TC_RX_COUNT >= 0);
 
@@ -343,12 +604,12 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_COUNT * NET_TC_RX_QUEUES; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_RX_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -378,10 +639,27 @@ void net_tc_rx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
+			if (IS_ENABLED(CONFIG_NET_TC_RX_RSS)) {
+				snprintk(name, sizeof(name), "rx_q[%d.%d]",
+					 i / NET_TC_RX_QUEUES,
+					 i % NET_TC_RX_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "rx_q[%d]", i);
+			}
 			k_thread_name_set(tid, name);
 		}
 
+#if defined(CONFIG_NET_TC_RX_RSS) && defined(CONFIG_SCHED_CPU_MASK) && \
+	CONFIG_MP_MAX_NUM_CPUS > 1
+		/* Spread the flow queues of a class over the CPUs */
+		ret = k_thread_cpu_pin(tid, (i % NET_TC_RX_QUEUES) %
+					    arch_num_cpus());
+		if (ret < 0) {
+			NET_WARN("Cannot pin RX handler %d to a CPU (%d)",
+				 i, ret);
+		}
+#endif
+
 		k_thread_start(tid);
 	}
 #endif
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_core.h>
@@ -36,7 +37,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 /* Track currently active route lifetime timers */
 static sys_slist_t active_route_lifetime_timers;
@@ -272,19 +273,253 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_TRIE)
+/* Path compressed binary trie of the route prefixes. A node holds the
+ * routes (one per interface) for its prefix, and the nodes below it
+ * extend the prefix, branching on the bit that follows it. Nodes that
+ * hold no route always have two children, so there are never more than
+ * two nodes per route.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+static struct route_trie_node route_trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *route_trie_free;
+static struct route_trie_node *route_trie;
+
+static inline int prefix_bit(const struct in6_addr *addr, uint8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Number of leading bits that a and b have in common, given that they
+ * are known to share the first from bits, and up to max bits.
+ */
+static uint8_t prefix_common(const struct in6_addr *a,
+			     const struct in6_addr *b,
+			     uint8_t from, uint8_t max)
+{
+	uint8_t len = from;
+
+	while (len < max) {
+		uint8_t diff = (a->s6_addr[len / 8] ^ b->s6_addr[len / 8]) &
+			       (0xff >> (len % 8));
+
+		if (diff) {
+			len = ROUND_DOWN(len, 8) + __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len = ROUND_DOWN(len, 8) + 8;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_trie_node *route_trie_node_alloc(const struct in6_addr *prefix,
+						     uint8_t len)
+{
+	struct route_trie_node *node = route_trie_free;
+
+	NET_ASSERT(node, "Out of route trie nodes");
+
+	route_trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	net_ipaddr_copy(&node->prefix, prefix);
+	node->len = len;
+
+	return node;
+}
+
+static void route_trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = route_trie_free;
+	route_trie_free = node;
+}
+
+static void route_trie_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(route_trie_nodes); i++) {
+		route_trie_node_free(&route_trie_nodes[i]);
+	}
+}
+
+static void route_trie_insert(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie;
+	struct route_trie_node *node, *leaf;
+	uint8_t len = route->prefix_len;
+	uint8_t depth = 0U;
+
+	while ((node = *link) != NULL) {
+		uint8_t common = prefix_common(&route->addr, &node->prefix,
+					       depth, MIN(len, node->len));
+
+		if (common < node->len) {
+			/* The route goes above node, either directly or
+			 * through a new branch node.
+			 */
+			leaf = route_trie_node_alloc(&route->addr, len);
+
+			if (common == len) {
+				leaf->child[prefix_bit(&node->prefix, len)] = node;
+				*link = leaf;
+			} else {
+				struct route_trie_node *branch;
+
+				branch = route_trie_node_alloc(&route->addr,
+							       common);
+				branch->child[prefix_bit(&route->addr, common)] = leaf;
+				branch->child[prefix_bit(&node->prefix, common)] = node;
+				*link = branch;
+			}
+
+			goto add;
+		}
+
+		if (node->len == len) {
+			leaf = node;
+			goto add;
+		}
+
+		depth = node->len;
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+	}
+
+	leaf = route_trie_node_alloc(&route->addr, len);
+	*link = leaf;
+
+add:
+	sys_slist_prepend(&leaf->routes, &route->trie_node);
+}
+
+static void route_trie_remove(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie, **parent_link = NULL;
+	struct route_trie_node *node, *parent;
+
+	while ((node = *link) != NULL && node->len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+	}
+
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->trie_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	route_trie_node_free(node);
+
+	/* A parent without routes is left with a single child when node
+	 * was a leaf, so it is not needed anymore either.
+	 */
+	if (*link || !parent_link) {
+		return;
+	}
+
+	parent = *parent_link;
+	if (sys_slist_is_empty(&parent->routes)) {
+		*parent_link = parent->child[0] ? parent->child[0] :
+						  parent->child[1];
+		route_trie_node_free(parent);
+	}
+}
+
+static struct net_route_entry *route_trie_match(struct route_trie_node *node,
+						struct net_if *iface)
+{
+	struct net_route_entry *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+		if (!iface || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+static struct net_route_entry *route_find_longest(struct net_if *iface,
+						  struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie;
+	struct net_route_entry *route, *found = NULL;
+	uint8_t depth = 0U;
+
+	while (node) {
+		if (prefix_common(dst, &node->prefix, depth,
+				  node->len) < node->len) {
+			break;
+		}
+
+		route = route_trie_match(node, iface);
+		if (route) {
+			found = route;
+		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		depth = node->len;
+		node = node->child[prefix_bit(dst, node->len)];
+	}
+
+	return found;
+}
+
+static struct net_route_entry *route_find_exact(struct net_if *iface,
+						struct in6_addr *addr,
+						uint8_t prefix_len)
+{
+	struct route_trie_node *node = route_trie;
+	uint8_t depth = 0U;
+
+	while (node && node->len <= prefix_len) {
+		if (prefix_common(addr, &node->prefix, depth,
+				  node->len) < node->len) {
+			break;
+		}
+
+		if (node->len == prefix_len) {
+			return route_trie_match(node, iface);
+		}
+
+		depth = node->len;
+		node = node->child[prefix_bit(addr, node->len)];
+	}
+
+	return NULL;
+}
+#else
+#define route_trie_init()
+#define route_trie_insert(route)
+#define route_trie_remove(route)
+
+static struct net_route_entry *route_find_longest(struct net_if *iface,
+						  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
 	int i;
 
-	k_mutex_lock(&lock, K_FOREVER);
-
 	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
 		struct net_nbr *nbr = get_nbr(i);
 
@@ -307,6 +542,44 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+
+static struct net_route_entry *route_find_exact(struct net_if *iface,
+						struct in6_addr *addr,
+						uint8_t prefix_len)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES; i++) {
+		struct net_nbr *nbr = get_nbr(i);
+		struct net_route_entry *route;
+
+		if (!nbr->ref || nbr->iface != iface) {
+			continue;
+		}
+
+		route = net_route_data(nbr);
+
+		if (route->prefix_len == prefix_len &&
+		    net_ipv6_is_prefix(addr->s6_addr, route->addr.s6_addr,
+				       prefix_len)) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_NET_ROUTE_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	found = route_find_longest(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -370,7 +643,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 			net_sprint_ll_addr(nexthop_lladdr->addr, nexthop_lladdr->len));
 	}
 
-	route = net_route_lookup(iface, addr);
+	route = route_find_exact(iface, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -402,9 +675,9 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
-		sys_slist_find_and_remove(&routes, last);
+		sys_dlist_remove(last);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -453,7 +726,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_update_lifetime(route, lifetime);
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_trie_insert(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -595,7 +869,9 @@ int net_route_del(struct net_route_entry *route)
 		}
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -603,6 +879,8 @@ int net_route_del(struct net_route_entry *route)
 		return -ENOENT;
 	}
 
+	route_trie_remove(route);
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -1100,5 +1378,7 @@ void net_route_init(void)
 	NET_DBG("Allocated %d nexthop entries (%zu bytes)",
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
+	route_trie_init();
+
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
 }
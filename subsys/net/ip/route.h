@@ -15,6 +15,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/net_timeout.h>
@@ -47,11 +48,16 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	/** Node in the list of routes with the same prefix. */
+	sys_snode_t trie_node;
+#endif
+
 	/** Network interface for the route. */
 	struct net_if *iface;
 
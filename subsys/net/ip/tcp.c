@@ -46,16 +46,34 @@ static int tcp_window =
 	CONFIG_NET_BUF_DATA_POOL_SIZE / 3;
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 #endif
-#ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
+#if defined(CONFIG_NET_TCP_RANDOMIZED_RTO) || defined(CONFIG_NET_TCP_TIMESTAMPS)
 #define TCP_RTO_MS (conn->rto)
 #else
 #define TCP_RTO_MS (tcp_rto)
 #endif
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+#define TCP_MAX_RECV_WIN ((int32_t)UINT16_MAX << NET_TCP_MAX_WINDOW_SCALE)
+#else
+#define TCP_MAX_RECV_WIN UINT16_MAX
+#endif
+
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
 static K_MUTEX_DEFINE(tcp_lock);
 
+#define TCP_CONN_HASH_SIZE BIT(CONFIG_NET_TCP_CONN_HASH_BITS)
+
+/* Connections whose both endpoints are known, for the lookup of
+ * incoming segments. Listening connections are only in tcp_conns.
+ */
+static struct tcp_conn_bucket {
+	sys_slist_t conns;
+	struct k_spinlock lock;
+} tcp_conn_hash[TCP_CONN_HASH_SIZE];
+
+static uint64_t tcp_conn_hash_key[2];
+
 K_MEM_SLAB_DEFINE_STATIC(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
@@ -361,11 +379,24 @@ out:
 
 static void tcp_derive_rto(struct tcp *conn)
 {
+#if defined(CONFIG_NET_TCP_RANDOMIZED_RTO) || defined(CONFIG_NET_TCP_TIMESTAMPS)
+	uint32_t rto = (uint32_t)tcp_rto;
 #ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
-	/* Compute a randomized rto 1 and 1.5 times tcp_rto */
 	uint32_t gain;
 	uint8_t gain8;
-	uint32_t rto;
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	/* SRTT + 4 * RTTVAR as in RFC 6298, the initial RTO is kept as
+	 * the lower bound.
+	 */
+	if (conn->srtt != 0U) {
+		rto = MAX(rto, (conn->srtt >> 3) + conn->rttvar);
+	}
+#endif
+
+#ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
+	/* Compute a randomized rto 1 and 1.5 times the base rto */
 
 	/* Getting random is computational expensive, so only use 8 bits */
 	sys_rand_get(&gain8, sizeof(uint8_t));
@@ -373,14 +404,145 @@ static void tcp_derive_rto(struct tcp *conn)
 	gain = (uint32_t)gain8;
 	gain += 1 << 9;
 
-	rto = (uint32_t)tcp_rto;
 	rto = (gain * rto) >> 9;
-	conn->rto = (uint16_t)rto;
+#endif
+	conn->rto = (uint16_t)MIN(rto, UINT16_MAX);
 #else
 	ARG_UNUSED(conn);
 #endif
 }
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+static void tcp_rtt_update(struct tcp *conn, uint32_t rtt)
+{
+	bool first = (conn->srtt == 0U);
+
+	if (first) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		int32_t delta = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+
+		conn->srtt = (uint32_t)((int32_t)conn->srtt + delta);
+		if (delta < 0) {
+			delta = -delta;
+		}
+		delta -= (int32_t)(conn->rttvar >> 2);
+		conn->rttvar = (uint32_t)((int32_t)conn->rttvar + delta);
+	}
+
+	/* Zero means no sample yet */
+	conn->srtt = MAX(conn->srtt, 1U);
+
+	NET_DBG("conn: %p rtt=%u srtt=%u rttvar=%u", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2);
+
+	/* Randomizing the RTO is not free, so in that case only the
+	 * first sample is applied right away and later ones when the RTO
+	 * is next derived after a retransmission.
+	 */
+	if (first || !IS_ENABLED(CONFIG_NET_TCP_RANDOMIZED_RTO)) {
+		tcp_derive_rto(conn);
+	}
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+static void tcp_ca_init(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	/* Initial window from RFC 6928 */
+	conn->ca.cwnd = MIN(10U * mss, MAX(2U * mss, 14600U));
+	conn->ca.ssthresh = UINT32_MAX;
+	conn->ca.acked_bytes = 0;
+	conn->ca.in_recovery = false;
+
+	if (conn->ca_ops->init) {
+		conn->ca_ops->init(conn);
+	}
+}
+
+static void tcp_ca_fast_retransmit(struct tcp *conn)
+{
+	conn->ca.ssthresh = conn->ca_ops->ssthresh(conn);
+	conn->ca.cwnd = conn->ca.ssthresh + 3U * conn_mss(conn);
+	conn->ca.recover = conn->seq + conn->unacked_len;
+	conn->ca.acked_bytes = 0;
+	conn->ca.in_recovery = true;
+
+	NET_DBG("conn: %p fast recovery, cwnd=%u ssthresh=%u", conn,
+		conn->ca.cwnd, conn->ca.ssthresh);
+}
+
+static void tcp_ca_dup_ack(struct tcp *conn)
+{
+	/* Every further duplicate ACK means a segment has left the
+	 * network, so inflate the window by one.
+	 */
+	if (conn->ca.in_recovery) {
+		conn->ca.cwnd += conn_mss(conn);
+	}
+}
+
+static void tcp_ca_timeout(struct tcp *conn)
+{
+	/* Only the first timeout of a loss episode lowers the
+	 * threshold, backed off retransmissions keep it (RFC 5681).
+	 */
+	if (conn->send_data_retries == 0) {
+		conn->ca.ssthresh = conn->ca_ops->ssthresh(conn);
+	}
+
+	conn->ca.cwnd = conn_mss(conn);
+	conn->ca.acked_bytes = 0;
+	conn->ca.in_recovery = false;
+
+	NET_DBG("conn: %p timeout, cwnd=%u ssthresh=%u", conn,
+		conn->ca.cwnd, conn->ca.ssthresh);
+}
+
+/* Returns true for a partial ACK in fast recovery, in which case the
+ * first unacknowledged segment has to be retransmitted (RFC 6582).
+ */
+static bool tcp_ca_pkts_acked(struct tcp *conn, uint32_t ack, uint32_t acked)
+{
+	struct tcp_ca *ca = &conn->ca;
+
+	if (ca->in_recovery) {
+		if (net_tcp_seq_cmp(ack, ca->recover) >= 0) {
+			ca->cwnd = ca->ssthresh;
+			ca->in_recovery = false;
+			return false;
+		}
+
+		ca->cwnd -= MIN(ca->cwnd, acked);
+		ca->cwnd += conn_mss(conn);
+		return true;
+	}
+
+	if (ca->cwnd < ca->ssthresh) {
+		ca->cwnd += MIN(acked, conn_mss(conn));
+	} else {
+		conn->ca_ops->cong_avoid(conn, acked);
+	}
+
+	return false;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_AVOIDANCE */
+
+/* The amount of data allowed in flight, limited by both the peer's
+ * receive window and our congestion window.
+ */
+static int tcp_tx_window(struct tcp *conn)
+{
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+	return MIN((uint32_t)conn->send_win, conn->ca.cwnd);
+#else
+	return conn->send_win;
+#endif
+}
+
 static void tcp_send_queue_flush(struct tcp *conn)
 {
 	struct net_pkt *pkt;
@@ -394,6 +556,110 @@ static void tcp_send_queue_flush(struct tcp *conn)
 }
 
 
+static inline uint64_t tcp_rol64(uint64_t word, unsigned int shift)
+{
+	return (word << shift) | (word >> (64 - shift));
+}
+
+static inline void tcp_sipround(uint64_t v[4])
+{
+	v[0] += v[1];
+	v[1] = tcp_rol64(v[1], 13) ^ v[0];
+	v[0] = tcp_rol64(v[0], 32);
+	v[2] += v[3];
+	v[3] = tcp_rol64(v[3], 16) ^ v[2];
+	v[0] += v[3];
+	v[3] = tcp_rol64(v[3], 21) ^ v[0];
+	v[2] += v[1];
+	v[1] = tcp_rol64(v[1], 17) ^ v[2];
+	v[2] = tcp_rol64(v[2], 32);
+}
+
+/* SipHash-1-3 of the connection 4-tuple, with a key chosen at boot */
+static uint32_t tcp_conn_hash_calc(const union tcp_endpoint *src,
+				   const union tcp_endpoint *dst)
+{
+	uint64_t m[5] = { 0 };
+	uint64_t v[4];
+	size_t n;
+
+	m[0] = (uint64_t)src->sa.sa_family |
+	       ((uint64_t)src->sin.sin_port << 16) |
+	       ((uint64_t)dst->sin.sin_port << 32);
+
+	if (src->sa.sa_family == AF_INET6) {
+		memcpy(&m[1], &src->sin6.sin6_addr, sizeof(struct in6_addr));
+		memcpy(&m[3], &dst->sin6.sin6_addr, sizeof(struct in6_addr));
+		n = 5;
+	} else {
+		memcpy(&m[1], &src->sin.sin_addr, sizeof(struct in_addr));
+		memcpy((uint8_t *)&m[1] + sizeof(struct in_addr),
+		       &dst->sin.sin_addr, sizeof(struct in_addr));
+		n = 2;
+	}
+
+	v[0] = tcp_conn_hash_key[0] ^ 0x736f6d6570736575ULL;
+	v[1] = tcp_conn_hash_key[1] ^ 0x646f72616e646f6dULL;
+	v[2] = tcp_conn_hash_key[0] ^ 0x6c7967656e657261ULL;
+	v[3] = tcp_conn_hash_key[1] ^ 0x7465646279746573ULL;
+
+	for (size_t i = 0; i < n; i++) {
+		v[3] ^= m[i];
+		tcp_sipround(v);
+		v[0] ^= m[i];
+	}
+
+	m[0] = (uint64_t)(n * sizeof(uint64_t)) << 56;
+	v[3] ^= m[0];
+	tcp_sipround(v);
+	v[0] ^= m[0];
+
+	v[2] ^= 0xff;
+	tcp_sipround(v);
+	tcp_sipround(v);
+	tcp_sipround(v);
+
+	m[0] = v[0] ^ v[1] ^ v[2] ^ v[3];
+
+	return (uint32_t)(m[0] ^ (m[0] >> 32));
+}
+
+static void tcp_conn_hash_remove(struct tcp *conn)
+{
+	struct tcp_conn_bucket *bucket;
+	k_spinlock_key_t key;
+
+	if (!conn->hashed) {
+		return;
+	}
+
+	bucket = &tcp_conn_hash[conn->hash & (TCP_CONN_HASH_SIZE - 1)];
+
+	key = k_spin_lock(&bucket->lock);
+	sys_slist_find_and_remove(&bucket->conns, &conn->hash_node);
+	conn->hashed = false;
+	k_spin_unlock(&bucket->lock, key);
+}
+
+/* Make the connection visible to the lookup of incoming segments, to be
+ * called once its src and dst endpoints are set.
+ */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	struct tcp_conn_bucket *bucket;
+	k_spinlock_key_t key;
+
+	tcp_conn_hash_remove(conn);
+
+	conn->hash = tcp_conn_hash_calc(&conn->src, &conn->dst);
+	bucket = &tcp_conn_hash[conn->hash & (TCP_CONN_HASH_SIZE - 1)];
+
+	key = k_spin_lock(&bucket->lock);
+	sys_slist_prepend(&bucket->conns, &conn->hash_node);
+	conn->hashed = true;
+	k_spin_unlock(&bucket->lock, key);
+}
+
 static int tcp_conn_unref(struct tcp *conn)
 {
 	int ref_count = atomic_get(&conn->ref_count);
@@ -444,6 +710,7 @@ static int tcp_conn_unref(struct tcp *conn)
 	tcp_pkt_unref(conn->send_data);
 
 	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
+		(void)k_work_cancel_delayable(&conn->recv_queue_timer);
 		tcp_pkt_unref(conn->queue_recv_data);
 	}
 
@@ -452,6 +719,7 @@ static int tcp_conn_unref(struct tcp *conn)
 	(void)k_work_cancel_delayable(&conn->persist_timer);
 	(void)k_work_cancel_delayable(&conn->ack_timer);
 
+	tcp_conn_hash_remove(conn);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
 
 	memset(conn, 0, sizeof(*conn));
@@ -659,8 +927,13 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
+	/* MSS and window scale are only sent in SYN segments and stay
+	 * valid for the connection, the rest is per segment.
+	 */
+	recv_options->ts_found = false;
+#ifdef CONFIG_NET_TCP_SACK
+	recv_options->sack_count = 0U;
+#endif
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -706,9 +979,50 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = MIN(options[2],
+						   NET_TCP_MAX_WINDOW_SCALE);
 			recv_options->wnd_found = true;
 			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (opt_len != NET_TCP_SACK_PERM_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case NET_TCP_TIMESTAMP_OPT:
+			if (opt_len != NET_TCP_TIMESTAMP_SIZE) {
+				result = false;
+				goto end;
+			}
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+			recv_options->tsval =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 2)));
+			recv_options->tsecr =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 6)));
+#endif
+			recv_options->ts_found = true;
+			break;
+#ifdef CONFIG_NET_TCP_SACK
+		case NET_TCP_SACK_OPT:
+			if ((opt_len - 2) % NET_TCP_SACK_BLOCK_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_count < NET_TCP_MAX_SACK_BLOCKS;
+			     i += NET_TCP_SACK_BLOCK_SIZE) {
+				struct tcp_sack_block *b =
+					&recv_options->sack[recv_options->sack_count++];
+
+				b->start = ntohl(UNALIGNED_GET((uint32_t *)(options + i)));
+				b->end = ntohl(UNALIGNED_GET((uint32_t *)(options + i + 4)));
+			}
+			break;
+#endif
 		default:
 			continue;
 		}
@@ -748,7 +1062,7 @@ static int tcp_update_recv_wnd(struct tcp *conn, int32_t delta)
 	bool short_win_after;
 
 	new_win = conn->recv_win + delta;
-	if (new_win < 0 || new_win > UINT16_MAX) {
+	if (new_win < 0 || new_win > TCP_MAX_RECV_WIN) {
 		return -EINVAL;
 	}
 
@@ -880,8 +1194,116 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+static uint16_t tcp_recv_win_adv(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+	/* The window of a SYN segment is never scaled */
+	if (!(flags & SYN)) {
+		win >>= conn->recv_wscale;
+	}
+#endif
+
+	return MIN(win, UINT16_MAX);
+}
+
+/* Build the options of an outgoing segment into buf, which must hold
+ * at least 40 bytes. Returns the options length, a multiple of 4.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags, uint8_t *buf)
+{
+	size_t len = 0;
+
+	if (conn->send_options.mss_found) {
+		uint32_t recv_mss = net_tcp_get_supported_mss(conn);
+
+		recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
+		UNALIGNED_PUT(htonl(recv_mss), (uint32_t *)buf);
+		len += NET_TCP_MSS_SIZE;
+	}
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+	if ((flags & SYN) && conn->wscale_ok) {
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_WINDOW_SCALE_OPT;
+		buf[len++] = NET_TCP_WINDOW_SCALE_SIZE;
+		buf[len++] = conn->recv_wscale;
+	}
+#endif
+
+	/* SACK permitted shares its 4 bytes with the timestamp padding */
+	if ((flags & SYN) && conn->sack_ok) {
+		if (!conn->ts_ok) {
+			buf[len++] = NET_TCP_NOP_OPT;
+			buf[len++] = NET_TCP_NOP_OPT;
+		}
+		buf[len++] = NET_TCP_SACK_PERM_OPT;
+		buf[len++] = NET_TCP_SACK_PERM_SIZE;
+	}
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	if (conn->ts_ok && !(flags & RST)) {
+		if (!((flags & SYN) && conn->sack_ok)) {
+			buf[len++] = NET_TCP_NOP_OPT;
+			buf[len++] = NET_TCP_NOP_OPT;
+		}
+		buf[len++] = NET_TCP_TIMESTAMP_OPT;
+		buf[len++] = NET_TCP_TIMESTAMP_SIZE;
+		UNALIGNED_PUT(htonl(k_uptime_get_32()), (uint32_t *)&buf[len]);
+		UNALIGNED_PUT(htonl(conn->ts_recent), (uint32_t *)&buf[len + 4]);
+		len += 8;
+	}
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+	/* The out-of-order queue is kept contiguous, so there is at most
+	 * one block to report.
+	 */
+	if (conn->sack_ok && (flags & ACK) && !(flags & SYN) &&
+	    conn->queue_recv_data && conn->queue_recv_data->buffer) {
+		uint32_t start = tcp_get_seq(conn->queue_recv_data->buffer);
+		uint32_t end = start + net_pkt_get_len(conn->queue_recv_data);
+
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_SACK_OPT;
+		buf[len++] = 2 + NET_TCP_SACK_BLOCK_SIZE;
+		UNALIGNED_PUT(htonl(start), (uint32_t *)&buf[len]);
+		UNALIGNED_PUT(htonl(end), (uint32_t *)&buf[len + 4]);
+		len += NET_TCP_SACK_BLOCK_SIZE;
+	}
+#endif
+
+	return len;
+}
+
+/* Largest amount of data that fits in a segment once the options that
+ * tcp_options_build() adds to data segments are taken off the MSS
+ * (RFC 6691).
+ */
+static int tcp_send_mss(struct tcp *conn)
+{
+	int mss = conn_mss(conn);
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	if (conn->ts_ok) {
+		mss -= 2 * NET_TCP_NOP_SIZE + NET_TCP_TIMESTAMP_SIZE;
+	}
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+	if (conn->sack_ok && conn->queue_recv_data &&
+	    conn->queue_recv_data->buffer) {
+		mss -= 2 * NET_TCP_NOP_SIZE + 2 + NET_TCP_SACK_BLOCK_SIZE;
+	}
+#endif
+
+	return mss;
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, size_t options_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
@@ -895,14 +1317,10 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
-
-	if (conn->send_options.mss_found) {
-		th->th_off++;
-	}
+	th->th_off = 5 + options_len / 4;
 
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_recv_win_adv(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
@@ -960,25 +1378,6 @@ static int get_tcp_nodelay(struct tcp *conn, void *value, size_t *len)
 	return 0;
 }
 
-static int net_tcp_set_mss_opt(struct tcp *conn, struct net_pkt *pkt)
-{
-	NET_PKT_DATA_ACCESS_DEFINE(mss_opt_access, struct tcp_mss_option);
-	struct tcp_mss_option *mss;
-	uint32_t recv_mss;
-
-	mss = net_pkt_get_data(pkt, &mss_opt_access);
-	if (!mss) {
-		return -ENOBUFS;
-	}
-
-	recv_mss = net_tcp_get_supported_mss(conn);
-	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
-
-	UNALIGNED_PUT(htonl(recv_mss), (uint32_t *)mss);
-
-	return net_pkt_set_data(pkt, &mss_opt_access);
-}
-
 static bool is_destination_local(struct net_pkt *pkt)
 {
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
@@ -1005,14 +1404,12 @@ static bool is_destination_local(struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
-	size_t alloc_len = sizeof(struct tcphdr);
+	uint8_t options[40]; /* TCP header max options size is 40 */
+	size_t options_len = tcp_options_build(conn, flags, options);
+	size_t alloc_len = sizeof(struct tcphdr) + options_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	if (conn->send_options.mss_found) {
-		alloc_len += sizeof(uint32_t);
-	}
-
 	pkt = tcp_pkt_alloc(conn, alloc_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
@@ -1031,14 +1428,14 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, options_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
 	}
 
-	if (conn->send_options.mss_found) {
-		ret = net_tcp_set_mss_opt(conn, pkt);
+	if (options_len) {
+		ret = net_pkt_write(pkt, options, options_len);
 		if (ret < 0) {
 			tcp_pkt_unref(pkt);
 			goto out;
@@ -1132,10 +1529,11 @@ static int tcp_unsent_len(struct tcp *conn)
 	}
 
 	unsent_len = conn->send_data_total - conn->unacked_len;
-	if (conn->unacked_len >= conn->send_win) {
+	if (conn->unacked_len >= tcp_tx_window(conn)) {
 		unsent_len = 0;
 	} else {
-		unsent_len = MIN(unsent_len, conn->send_win - conn->unacked_len);
+		unsent_len = MIN(unsent_len,
+				 tcp_tx_window(conn) - conn->unacked_len);
 	}
  out:
 	NET_DBG("unsent_len=%d", unsent_len);
@@ -1150,8 +1548,8 @@ static int tcp_send_data(struct tcp *conn)
 	struct net_pkt *pkt;
 
 	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
+		   MAX(tcp_tx_window(conn) - conn->unacked_len, 0),
+		   tcp_send_mss(conn));
 	if (len == 0) {
 		NET_DBG("conn: %p no data to send", conn);
 		ret = -ENODATA;
@@ -1197,6 +1595,74 @@ static int tcp_send_data(struct tcp *conn)
 	return ret;
 }
 
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+#ifdef CONFIG_NET_TCP_SACK
+/* Offset from the first unacknowledged byte past any SACKed range that
+ * pos falls into, or 0 if no SACK block lies beyond pos, i.e. there is
+ * no known hole left.
+ */
+static uint32_t tcp_sack_next_hole(struct tcp *conn, uint32_t pos,
+				   uint32_t flight)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	bool moved, beyond;
+
+	do {
+		moved = false;
+		beyond = false;
+
+		for (int i = 0; i < opts->sack_count; i++) {
+			uint32_t start = opts->sack[i].start - conn->seq;
+			uint32_t end = opts->sack[i].end - conn->seq;
+
+			/* Ignore blocks that don't fit in what is in flight */
+			if (start >= end || end > flight) {
+				continue;
+			}
+
+			if (start <= pos && pos < end) {
+				pos = end;
+				moved = true;
+			} else if (start > pos) {
+				beyond = true;
+			}
+		}
+	} while (moved);
+
+	return beyond ? pos : 0;
+}
+#endif
+
+/* Retransmit the segment at the first unacknowledged byte. With SACK
+ * information from the peer, also resend the rest of the holes below
+ * the highest SACKed byte as far as the window allows.
+ */
+static void tcp_resend_lost(struct tcp *conn)
+{
+	int temp_unacked_len = conn->unacked_len;
+
+	conn->unacked_len = 0;
+
+	if (tcp_send_data(conn) == 0) {
+#ifdef CONFIG_NET_TCP_SACK
+		uint32_t pos;
+
+		while (conn->sack_ok &&
+		       (pos = tcp_sack_next_hole(conn, conn->unacked_len,
+						 temp_unacked_len)) != 0U) {
+			conn->unacked_len = pos;
+			if (tcp_send_data(conn) < 0) {
+				break;
+			}
+		}
+#endif
+	}
+
+	/* Restore the current transmission */
+	conn->unacked_len = temp_unacked_len;
+}
+#endif /* CONFIG_NET_TCP_FAST_RETRANSMIT */
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
@@ -1212,7 +1678,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 		/* Implement Nagle's algorithm */
 		if ((conn->tcp_nodelay == false) && (conn->unacked_len > 0)) {
 			/* If there is already pending data */
-			if (tcp_unsent_len(conn) < conn_mss(conn)) {
+			if (tcp_unsent_len(conn) < tcp_send_mss(conn)) {
 				/* The number of bytes to be transmitted is less than an MSS,
 				 * skip transmission for now.
 				 * Wait for more data to be transmitted or all pending data
@@ -1280,6 +1746,12 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+	if (conn->send_data_total > 0) {
+		tcp_ca_timeout(conn);
+	}
+#endif
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1458,6 +1930,10 @@ static struct tcp *tcp_conn_alloc(struct net_context *context)
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
 	conn->dup_ack_cnt = 0;
 #endif
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+	conn->ca_ops = IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CUBIC) ?
+		&tcp_ca_cubic : &tcp_ca_newreno;
+#endif
 
 	/* Set the recv_win with the rcvbuf configured for the socket. */
 	if (IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF) &&
@@ -1467,8 +1943,22 @@ static struct tcp *tcp_conn_alloc(struct net_context *context)
 		}
 	}
 
+	conn->recv_win_max = MIN(conn->recv_win_max, TCP_MAX_RECV_WIN);
 	conn->recv_win = conn->recv_win_max;
 
+	/* Offered in our SYN, narrowed down to what the peer supports
+	 * during the handshake.
+	 */
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE);
+	conn->ts_ok = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS);
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK);
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+	while (conn->recv_wscale < NET_TCP_MAX_WINDOW_SCALE &&
+	       (conn->recv_win_max >> conn->recv_wscale) > UINT16_MAX) {
+		conn->recv_wscale++;
+	}
+#endif
+
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
 	 */
@@ -1524,38 +2014,37 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	union tcp_endpoint src, dst;
+	struct tcp_conn_bucket *bucket;
+	struct tcp *conn, *found = NULL;
+	k_spinlock_key_t key;
+	uint32_t hash;
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
+	/* The source of the packet is the destination of the connection */
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
+	hash = tcp_conn_hash_calc(&src, &dst);
+	bucket = &tcp_conn_hash[hash & (TCP_CONN_HASH_SIZE - 1)];
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
-}
+	key = k_spin_lock(&bucket->lock);
 
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
-{
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
-
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&bucket->conns, conn, hash_node) {
+		if (conn->hash == hash &&
+		    !memcmp(&conn->src, &src, tcp_endpoint_len(src.sa.sa_family)) &&
+		    !memcmp(&conn->dst, &dst, tcp_endpoint_len(dst.sa.sa_family))) {
+			found = conn;
 			break;
 		}
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&bucket->lock, key);
+
+	return found;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1734,6 +2223,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_hash_add(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr),
@@ -2017,6 +2508,45 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
 }
 
+/* Keep only the options that the peer also sent in its SYN */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+	conn->wscale_ok = conn->wscale_ok && conn->recv_options.wnd_found;
+	conn->ts_ok = conn->ts_ok && conn->recv_options.ts_found;
+	conn->sack_ok = conn->sack_ok && conn->recv_options.sack_perm_found;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+	if (conn->wscale_ok) {
+		conn->send_wscale = conn->recv_options.window;
+	} else {
+		conn->send_wscale = 0U;
+		conn->recv_wscale = 0U;
+	}
+#endif
+
+	/* Without scaling, the window can't be advertised past 64 KiB */
+	if (!conn->wscale_ok) {
+		conn->recv_win_max = MIN(conn->recv_win_max, UINT16_MAX);
+		conn->recv_win = MIN(conn->recv_win, conn->recv_win_max);
+	}
+
+	NET_DBG("conn: %p wscale %d ts %d sack %d", conn, conn->wscale_ok,
+		conn->ts_ok, conn->sack_ok);
+}
+
+static void tcp_ts_rtt_sample(struct tcp *conn)
+{
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	if (conn->ts_ok && conn->recv_options.ts_found &&
+	    conn->recv_options.tsecr != 0U) {
+		tcp_rtt_update(conn, k_uptime_get_32() -
+				     conn->recv_options.tsecr);
+	}
+#else
+	ARG_UNUSED(conn);
+#endif
+}
+
 /* TCP state machine, everything happens here */
 static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 {
@@ -2080,6 +2610,23 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th && !tcp_options_len) {
+		conn->recv_options.ts_found = false;
+#ifdef CONFIG_NET_TCP_SACK
+		conn->recv_options.sack_count = 0U;
+#endif
+	}
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	/* Remember the timestamp to echo from in-sequence segments only
+	 * (RFC 7323, section 4.3)
+	 */
+	if (th && conn->ts_ok && conn->recv_options.ts_found &&
+	    ((th_flags(th) & SYN) || th_seq(th) == conn->ack)) {
+		conn->ts_recent = conn->recv_options.tsval;
+	}
+#endif
+
 	if (th && (conn->state != TCP_LISTEN) && (conn->state != TCP_SYN_SENT) &&
 	    tcp_validate_seq(conn, th) && FL(&fl, &, SYN)) {
 		/* According to RFC 793, ch 3.9 Event Processing, receiving SYN
@@ -2099,6 +2646,12 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		size_t max_win;
 
 		conn->send_win = ntohs(th_win(th));
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+		/* The window of a SYN segment is never scaled */
+		if (!(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->send_wscale;
+		}
+#endif
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
@@ -2153,6 +2706,8 @@ next_state:
 	switch (conn->state) {
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
+			tcp_options_negotiate(conn);
+
 			/* Make sure our MSS is also sent in the ACK */
 			conn->send_options.mss_found = true;
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
@@ -2179,6 +2734,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_ts_rtt_sample(conn);
 			next = TCP_ESTABLISHED;
 			tcp_conn_ref(conn);
 			net_context_set_state(conn->context,
@@ -2213,6 +2769,8 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_options_negotiate(conn);
+			tcp_ts_rtt_sample(conn);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				verdict = tcp_data_get(conn, pkt, &len);
@@ -2276,6 +2834,12 @@ next_state:
 					 */
 					conn->dup_ack_cnt = MIN(conn->dup_ack_cnt + 1,
 						DUPLICATE_ACK_RETRANSMIT_TRHESHOLD + 1);
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+					if (conn->ca.in_recovery) {
+						tcp_ca_dup_ack(conn);
+						(void)tcp_send_queued_data(conn);
+					}
+#endif
 				}
 			} else {
 				conn->dup_ack_cnt = 0;
@@ -2283,16 +2847,16 @@ next_state:
 
 			/* Only do fast retransmit when not already in a resend state */
 			if ((conn->data_mode == TCP_DATA_MODE_SEND) &&
-			    (conn->dup_ack_cnt == DUPLICATE_ACK_RETRANSMIT_TRHESHOLD)) {
+			    (conn->dup_ack_cnt == DUPLICATE_ACK_RETRANSMIT_TRHESHOLD)
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+			    && !conn->ca.in_recovery
+#endif
+			    ) {
 				/* Apply a fast retransmit */
-				int temp_unacked_len = conn->unacked_len;
-
-				conn->unacked_len = 0;
-
-				(void)tcp_send_data(conn);
-
-				/* Restore the current transmission */
-				conn->unacked_len = temp_unacked_len;
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+				tcp_ca_fast_retransmit(conn);
+#endif
+				tcp_resend_lost(conn);
 			}
 		}
 #endif
@@ -2333,6 +2897,15 @@ next_state:
 
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
+			tcp_ts_rtt_sample(conn);
+
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+			if (tcp_ca_pkts_acked(conn, th_ack(th), len_acked) &&
+			    conn->data_mode == TCP_DATA_MODE_SEND) {
+				/* Partial ACK, resend the next missing segment */
+				tcp_resend_lost(conn);
+			}
+#endif
 
 			conn_send_data_dump(conn);
 
@@ -2471,6 +3044,11 @@ next_state:
 		pkt = NULL;
 		th = NULL;
 		conn_state(conn, next);
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+		if (next == TCP_ESTABLISHED) {
+			tcp_ca_init(conn);
+		}
+#endif
 		next = 0;
 
 		if (connection_ok) {
@@ -2817,6 +3395,10 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	if (ret == 0) {
+		tcp_conn_hash_add(conn);
+	}
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -3023,6 +3605,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -3145,6 +3728,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 				conn = context->tcp;
 				tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 				tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+				tcp_conn_hash_add(conn);
 				conn->iface = pkt->iface;
 				tcp_conn_ref(conn);
 			}
@@ -3417,6 +4001,8 @@ void net_tcp_init(void)
 		tcp_fin_timeout_ms += tcp_fin_timeout_ms >> 1;
 	}
 
+	sys_rand_get(tcp_conn_hash_key, sizeof(tcp_conn_hash_key));
+
 	k_thread_name_set(&tcp_work_q.thread, "tcp_work");
 	NET_DBG("Workq started. Thread ID: %p", &tcp_work_q.thread);
 }
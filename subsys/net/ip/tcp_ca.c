@@ -0,0 +1,145 @@
+/** @file
+ * @brief TCP congestion control algorithms
+ */
+
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+/* NewReno (RFC 5681): one segment per window worth of acked data */
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	return MAX((uint32_t)conn->unacked_len / 2U, 2U * conn_mss(conn));
+}
+
+static void newreno_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_ca *ca = &conn->ca;
+
+	ca->acked_bytes += acked;
+	if (ca->acked_bytes >= ca->cwnd) {
+		ca->acked_bytes -= ca->cwnd;
+		ca->cwnd += conn_mss(conn);
+	}
+}
+
+const struct tcp_ca_ops tcp_ca_newreno = {
+	.name = "newreno",
+	.ssthresh = newreno_ssthresh,
+	.cong_avoid = newreno_cong_avoid,
+};
+
+/* CUBIC (RFC 8312): W(t) = C * (t - K)^3 + W_max, with C = 0.4 and
+ * beta = 0.7.  Time is in milliseconds and windows in segments for the
+ * cubic function, so K = cbrt((W_max - cwnd) / C) seconds becomes
+ * cbrt(segments * 2.5e9) ms, and C * t^3 becomes 4 * t^3 / 1e10.
+ */
+#define CUBIC_K_SCALE 2500000000ULL
+/* Bounds t^3 so that the scaled offset can't overflow */
+#define CUBIC_T_MAX_MS (1LL << 20)
+
+uint32_t tcp_ca_cubic_root(uint64_t a)
+{
+	uint64_t x = 0;
+
+	for (int s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		x <<= 1;
+		b = 3 * x * (x + 1) + 1;
+		if ((a >> s) >= b) {
+			a -= b << s;
+			x++;
+		}
+	}
+
+	return (uint32_t)x;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	conn->ca.w_max = 0;
+	conn->ca.epoch_start = 0;
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	struct tcp_ca *ca = &conn->ca;
+
+	ca->epoch_start = 0;
+
+	/* Fast convergence: release bandwidth to new flows when the
+	 * window did not get back to where it was at the last loss.
+	 */
+	if (ca->cwnd < ca->w_max) {
+		ca->w_max = ca->cwnd / 20U * 17U;
+	} else {
+		ca->w_max = ca->cwnd;
+	}
+
+	return MAX(ca->cwnd / 10U * 7U, 2U * conn_mss(conn));
+}
+
+static void cubic_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_ca *ca = &conn->ca;
+	uint32_t mss = conn_mss(conn);
+	int64_t now = k_uptime_get();
+	uint64_t cubic_inc = 0, reno_inc, inc;
+	int64_t t, target;
+
+	if (ca->epoch_start == 0) {
+		ca->epoch_start = now;
+		ca->acked_bytes = 0;
+
+		if (ca->cwnd < ca->w_max) {
+			ca->k_ms = tcp_ca_cubic_root((uint64_t)((ca->w_max - ca->cwnd) / mss) *
+						     CUBIC_K_SCALE);
+			ca->origin = ca->w_max;
+		} else {
+			ca->k_ms = 0;
+			ca->origin = ca->cwnd;
+		}
+	}
+
+	t = now - ca->epoch_start - ca->k_ms;
+	t = CLAMP(t, -CUBIC_T_MAX_MS, CUBIC_T_MAX_MS);
+	target = (int64_t)ca->origin + t * t * t / 1000000 * 4 * mss / 10000;
+
+	ca->acked_bytes += acked;
+
+	if (target > (int64_t)ca->cwnd) {
+		cubic_inc = (uint64_t)(target - ca->cwnd) * ca->acked_bytes /
+			    ca->cwnd;
+	}
+
+	/* Never grow slower than NewReno would (the "TCP-friendly"
+	 * region), nor faster than slow start.
+	 */
+	reno_inc = (uint64_t)mss * ca->acked_bytes / ca->cwnd;
+	inc = MIN(MAX(cubic_inc, reno_inc), ca->acked_bytes);
+
+	if (inc > 0) {
+		ca->cwnd += (uint32_t)inc;
+		ca->acked_bytes = 0;
+	}
+}
+
+const struct tcp_ca_ops tcp_ca_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.ssthresh = cubic_ssthresh,
+	.cong_avoid = cubic_cong_avoid,
+};
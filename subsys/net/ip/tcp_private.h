@@ -128,7 +128,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			_conn->unacked_len, _conn->send_win,                   \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -208,22 +208,91 @@ union tcp_endpoint {
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
+#define NET_TCP_TIMESTAMP_OPT    8
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+#define NET_TCP_TIMESTAMP_SIZE    10
+
+/* Largest shift allowed by RFC 7323 */
+#define NET_TCP_MAX_WINDOW_SCALE  14
+/* What fits in the option space next to a timestamp */
+#define NET_TCP_MAX_SACK_BLOCKS   3
+
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
 
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	uint32_t tsval;
+	uint32_t tsecr;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+	struct tcp_sack_block sack[NET_TCP_MAX_SACK_BLOCKS];
+	uint8_t sack_count;
+#endif
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool ts_found : 1;
+	bool sack_perm_found : 1;
 };
 
+struct tcp;
+
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+/* Congestion control state.  Windows are in bytes. */
+struct tcp_ca {
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	/* Highest sequence number sent when fast recovery was entered */
+	uint32_t recover;
+	/* Bytes acknowledged towards the next congestion avoidance step */
+	uint32_t acked_bytes;
+	/* CUBIC: window before the last reduction, and the cubic
+	 * function origin and inflection point for the current epoch
+	 */
+	uint32_t w_max;
+	uint32_t origin;
+	uint32_t k_ms;
+	int64_t epoch_start;
+	bool in_recovery : 1;
+};
+
+/* Congestion control algorithm.  The generic code in tcp.c takes care
+ * of slow start and fast recovery, the algorithm decides on the window
+ * after a loss and on its growth in congestion avoidance.
+ */
+struct tcp_ca_ops {
+	const char *name;
+	/* Called when the connection is established */
+	void (*init)(struct tcp *conn);
+	/* Return the slow start threshold to use after a loss */
+	uint32_t (*ssthresh)(struct tcp *conn);
+	/* Grow cwnd for acked bytes while above ssthresh */
+	void (*cong_avoid)(struct tcp *conn, uint32_t acked);
+};
+
+extern const struct tcp_ca_ops tcp_ca_newreno;
+extern const struct tcp_ca_ops tcp_ca_cubic;
+
+/* Integer cube root, rounded down */
+uint32_t tcp_ca_cubic_root(uint64_t a);
+#endif
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_node; /* in the bucket of the connection 4-tuple */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -257,6 +326,7 @@ struct tcp { /* TCP connection */
 	};
 	union tcp_endpoint src;
 	union tcp_endpoint dst;
+	uint32_t hash; /* of src and dst, valid when hashed */
 	size_t send_data_total;
 	size_t send_retries;
 	int unacked_len;
@@ -265,21 +335,43 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win_max;
-	uint16_t recv_win;
-	uint16_t send_win;
-#ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+	const struct tcp_ca_ops *ca_ops;
+	struct tcp_ca ca;
+#endif
+	uint32_t recv_win_max;
+	uint32_t recv_win;
+	uint32_t send_win;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+	/* Last timestamp of the peer, echoed in our segments */
+	uint32_t ts_recent;
+	/* Smoothed round trip time in 1/8 ms, and its variance in 1/4 ms */
+	uint32_t srtt;
+	uint32_t rttvar;
+#endif
+#if defined(CONFIG_NET_TCP_RANDOMIZED_RTO) || defined(CONFIG_NET_TCP_TIMESTAMPS)
 	uint16_t rto;
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+	uint8_t send_wscale; /* shift applied to the peer's window */
+	uint8_t recv_wscale; /* shift applied to our window */
 #endif
 	uint8_t send_data_retries;
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
 	uint8_t dup_ack_cnt;
 #endif
 	uint8_t zwp_retries;
+	/* Options offered in our SYN, and once the handshake is done,
+	 * the ones agreed on by both ends
+	 */
+	bool wscale_ok : 1;
+	bool ts_ok : 1;
+	bool sack_ok : 1;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
 	bool tcp_nodelay : 1;
+	bool hashed : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -45,9 +45,39 @@ static inline int dummy_send(struct net_if *iface, struct net_pkt *pkt)
 	return ret;
 }
 
+#if defined(CONFIG_NET_BATCH)
+static void dummy_send_batch(struct net_if *iface, struct net_pkt **pkts,
+			     int *status, size_t count)
+{
+	const struct dummy_api *api = net_if_get_device(iface)->api;
+	int sent;
+
+	if (!api || !api->send_batch) {
+		for (size_t i = 0; i < count; i++) {
+			status[i] = dummy_send(iface, pkts[i]);
+		}
+
+		return;
+	}
+
+	sent = net_l2_send_batch(api->send_batch, net_if_get_device(iface),
+				 iface, pkts, count);
+
+	for (int i = 0; i < (int)count; i++) {
+		if (i < sent) {
+			status[i] = net_pkt_get_len(pkts[i]);
+			net_pkt_unref(pkts[i]);
+		} else {
+			status[i] = sent < 0 ? sent : -EIO;
+		}
+	}
+}
+#endif
+
 static enum net_l2_flags dummy_flags(struct net_if *iface)
 {
 	return NET_L2_MULTICAST;
 }
 
-NET_L2_INIT(DUMMY_L2, dummy_recv, dummy_send, NULL, dummy_flags);
+NET_L2_INIT_BATCH(DUMMY_L2, dummy_recv, dummy_send, dummy_send_batch, NULL,
+		  dummy_flags);
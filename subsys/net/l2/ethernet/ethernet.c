@@ -596,30 +596,20 @@ static void ethernet_remove_l2_header(struct net_pkt *pkt)
 	net_pkt_frag_unref(buf);
 }
 
-static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
+/* Add the L2 header to the packet, which can be replaced by an ARP
+ * request if the destination is not known yet. Returns 1 if the packet
+ * is sent as is (bridged), 0 if a header was added, or a negative error.
+ */
+static int ethernet_prepare(struct net_if *iface, struct net_pkt **pkt_ptr)
 {
-	const struct ethernet_api *api = net_if_get_device(iface)->api;
 	struct ethernet_context *ctx = net_if_l2_data(iface);
+	struct net_pkt *pkt = *pkt_ptr;
 	uint16_t ptype;
-	int ret;
-
-	if (!api) {
-		ret = -ENOENT;
-		goto error;
-	}
 
 	if (IS_ENABLED(CONFIG_NET_ETHERNET_BRIDGE) &&
 	    net_pkt_is_l2_bridged(pkt)) {
 		net_pkt_cursor_init(pkt);
-		ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
-		if (ret != 0) {
-			eth_stats_update_errors_tx(iface);
-			goto error;
-		}
-		ethernet_update_tx_stats(iface, pkt);
-		ret = net_pkt_get_len(pkt);
-		net_pkt_unref(pkt);
-		return ret;
+		return 1;
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
 	    net_pkt_family(pkt) == AF_INET) {
 		struct net_pkt *tmp;
@@ -629,13 +619,13 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		} else {
 			tmp = ethernet_ll_prepare_on_ipv4(iface, pkt);
 			if (!tmp) {
-				ret = -ENOMEM;
-				goto error;
+				return -ENOMEM;
 			} else if (IS_ENABLED(CONFIG_NET_ARP) && tmp != pkt) {
 				/* Original pkt got queued and is replaced
 				 * by an ARP request packet.
 				 */
 				pkt = tmp;
+				*pkt_ptr = pkt;
 				ptype = htons(NET_ETH_PTYPE_ARP);
 				net_pkt_set_family(pkt, AF_INET);
 			} else {
@@ -667,7 +657,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 						sizeof(struct net_eth_addr);
 			ptype = dst_addr->sll_protocol;
 		} else {
-			goto send;
+			return 0;
 		}
 	} else if (IS_ENABLED(CONFIG_NET_L2_PTP) && net_pkt_is_ptp(pkt)) {
 		ptype = htons(NET_ETH_PTYPE_PTP);
@@ -679,8 +669,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		ptype = htons(NET_ETH_PTYPE_ARP);
 		net_pkt_set_family(pkt, AF_INET);
 	} else {
-		ret = -ENOTSUP;
-		goto error;
+		return -ENOTSUP;
 	}
 
 	/* If the ll dst addr has not been set before, let's assume
@@ -695,8 +684,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 	if (IS_ENABLED(CONFIG_NET_VLAN) &&
 	    net_eth_is_vlan_enabled(ctx, iface)) {
 		if (set_vlan_tag(ctx, iface, pkt) == NET_DROP) {
-			ret = -EINVAL;
-			goto error;
+			return -EINVAL;
 		}
 
 		set_vlan_priority(ctx, pkt);
@@ -705,30 +693,110 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 	/* Then set the ethernet header.
 	 */
 	if (!ethernet_fill_header(ctx, pkt, ptype)) {
-		ret = -ENOMEM;
-		goto error;
+		return -ENOMEM;
 	}
 
 	net_pkt_cursor_init(pkt);
 
-send:
-	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
+	return 0;
+}
+
+/* Account for a packet once the driver is done with it. Returns what
+ * the L2 send returns for it.
+ */
+static int ethernet_sent(struct net_if *iface, struct net_pkt *pkt,
+			 bool l2_hdr, int ret)
+{
 	if (ret != 0) {
 		eth_stats_update_errors_tx(iface);
-		ethernet_remove_l2_header(pkt);
-		goto error;
+		if (l2_hdr) {
+			ethernet_remove_l2_header(pkt);
+		}
+
+		return ret;
 	}
 
 	ethernet_update_tx_stats(iface, pkt);
 
 	ret = net_pkt_get_len(pkt);
-	ethernet_remove_l2_header(pkt);
+	if (l2_hdr) {
+		ethernet_remove_l2_header(pkt);
+	}
 
 	net_pkt_unref(pkt);
-error:
+
 	return ret;
 }
 
+static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct ethernet_api *api = net_if_get_device(iface)->api;
+	int ret;
+
+	if (!api) {
+		return -ENOENT;
+	}
+
+	ret = ethernet_prepare(iface, &pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ethernet_sent(iface, pkt, ret == 0,
+			     net_l2_send(api->send, net_if_get_device(iface),
+					 iface, pkt));
+}
+
+#if defined(CONFIG_NET_BATCH)
+static void ethernet_send_batch(struct net_if *iface, struct net_pkt **pkts,
+				int *status, size_t count)
+{
+	const struct ethernet_api *api = net_if_get_device(iface)->api;
+	struct net_pkt *ready[CONFIG_NET_BATCH_SIZE];
+	uint8_t index[CONFIG_NET_BATCH_SIZE];
+	bool l2_hdr[CONFIG_NET_BATCH_SIZE];
+	size_t n = 0;
+	int sent;
+
+	if (!api || !api->send_batch) {
+		for (size_t i = 0; i < count; i++) {
+			status[i] = ethernet_send(iface, pkts[i]);
+		}
+
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+		int ret;
+
+		ret = ethernet_prepare(iface, &pkt);
+		if (ret < 0) {
+			status[i] = ret;
+			continue;
+		}
+
+		ready[n] = pkt;
+		index[n] = i;
+		l2_hdr[n] = ret == 0;
+		n++;
+	}
+
+	if (n == 0) {
+		return;
+	}
+
+	sent = net_l2_send_batch(api->send_batch, net_if_get_device(iface),
+				 iface, ready, n);
+
+	for (size_t i = 0; i < n; i++) {
+		status[index[i]] = ethernet_sent(iface, ready[i], l2_hdr[i],
+						 (int)i < sent ? 0 :
+						 (sent < 0 ? sent : -EIO));
+	}
+}
+#endif /* CONFIG_NET_BATCH */
+
 static inline int ethernet_enable(struct net_if *iface, bool state)
 {
 	int ret = 0;
@@ -1042,8 +1110,8 @@ int net_eth_vlan_disable(struct net_if *iface, uint16_t tag)
 }
 #endif /* CONFIG_NET_VLAN */
 
-NET_L2_INIT(ETHERNET_L2, ethernet_recv, ethernet_send, ethernet_enable,
-	    ethernet_flags);
+NET_L2_INIT_BATCH(ETHERNET_L2, ethernet_recv, ethernet_send,
+		  ethernet_send_batch, ethernet_enable, ethernet_flags);
 
 static void carrier_on_off(struct k_work *work)
 {
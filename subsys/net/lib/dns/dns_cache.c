@@ -0,0 +1,213 @@
+/** @file
+ * @brief DNS resolver cache
+ *
+ * Remembers the results of DNS queries for as long as their TTL allows.
+ */
+
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <strings.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/dns_resolve.h>
+#include "dns_internal.h"
+
+struct dns_cache_entry {
+	/** Cached addresses, none for a negative result */
+	struct dns_addrinfo addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+	/** Uptime in ms when the entry expires, 0 if the entry is free */
+	int64_t expires;
+
+	/** Value of the use counter when the entry was last used */
+	uint32_t used;
+
+	enum dns_query_type type;
+	uint8_t count;
+	char query[CONFIG_DNS_RESOLVER_CACHE_MAX_NAME_LEN + 1];
+};
+
+static struct dns_cache_entry dns_cache[CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES];
+static uint32_t dns_cache_uses;
+
+static K_MUTEX_DEFINE(dns_cache_lock);
+
+/* Must be invoked with the cache lock held */
+static bool dns_cache_is_live(struct dns_cache_entry *entry, int64_t now)
+{
+	if (entry->expires != 0 && entry->expires <= now) {
+		NET_DBG("Expired %s (type %d)", entry->query, entry->type);
+
+		entry->expires = 0;
+	}
+
+	return entry->expires != 0;
+}
+
+/* Must be invoked with the cache lock held */
+static struct dns_cache_entry *dns_cache_lookup(const char *query,
+						enum dns_query_type type,
+						int64_t now)
+{
+	for (int i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (dns_cache_is_live(entry, now) && entry->type == type &&
+		    strcasecmp(entry->query, query) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   struct dns_addrinfo *addrs, size_t max)
+{
+	struct dns_cache_entry *entry;
+	int count;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_lookup(query, type, k_uptime_get());
+	if (!entry) {
+		count = -ENOENT;
+		goto out;
+	}
+
+	count = MIN(entry->count, max);
+	memcpy(addrs, entry->addrs, count * sizeof(*addrs));
+
+	entry->used = ++dns_cache_uses;
+
+	NET_DBG("Found %s (type %d), %d addresses", query, type, count);
+
+out:
+	k_mutex_unlock(&dns_cache_lock);
+
+	return count;
+}
+
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct dns_addrinfo *addrs, size_t count,
+		   uint32_t ttl)
+{
+	int64_t now = k_uptime_get();
+	struct dns_cache_entry *entry;
+
+	if (ttl == 0U || strlen(query) > CONFIG_DNS_RESOLVER_CACHE_MAX_NAME_LEN) {
+		return;
+	}
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_lookup(query, type, now);
+	if (!entry) {
+		/* Take a free entry, or else the least recently used one */
+		entry = &dns_cache[0];
+
+		for (int i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+			if (!dns_cache_is_live(&dns_cache[i], now)) {
+				entry = &dns_cache[i];
+				break;
+			}
+
+			if ((int32_t)(dns_cache[i].used - entry->used) < 0) {
+				entry = &dns_cache[i];
+			}
+		}
+
+		strcpy(entry->query, query);
+		entry->type = type;
+	}
+
+	entry->count = MIN(count, ARRAY_SIZE(entry->addrs));
+	if (entry->count > 0) {
+		memcpy(entry->addrs, addrs, entry->count * sizeof(*addrs));
+	}
+	entry->expires = now + (int64_t)MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_MAX_TTL) *
+			       MSEC_PER_SEC;
+	entry->used = ++dns_cache_uses;
+
+	NET_DBG("Added %s (type %d), %d addresses for %u s", query, type,
+		entry->count, ttl);
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+
+int dns_resolve_cache_flush(void)
+{
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		dns_cache[i].expires = 0;
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+
+	return 0;
+}
+
+int dns_resolve_cache_remove(const char *query)
+{
+	int64_t now = k_uptime_get();
+	int removed = 0;
+
+	if (!query) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (dns_cache_is_live(entry, now) &&
+		    strcasecmp(entry->query, query) == 0) {
+			entry->expires = 0;
+			removed++;
+		}
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+
+	return removed > 0 ? removed : -ENOENT;
+}
+
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data)
+{
+	int64_t now = k_uptime_get();
+	int ret = 0;
+
+	if (!cb) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (!dns_cache_is_live(entry, now)) {
+			continue;
+		}
+
+		cb(entry->query, entry->type, entry->addrs, entry->count,
+		   (uint32_t)((entry->expires - now) / MSEC_PER_SEC),
+		   user_data);
+		ret++;
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+
+	return ret;
+}
@@ -18,3 +18,18 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		     struct net_buf *dns_cname,
 		     uint16_t *query_hash);
 #endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Returns the number of cached addresses copied to addrs, which is 0 for
+ * a cached negative result, or -ENOENT if nothing is cached for the name.
+ */
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   struct dns_addrinfo *addrs, size_t max);
+
+/* Caches count addresses for ttl seconds, or a negative result if count
+ * is 0. A ttl of 0 means that the result must not be cached.
+ */
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct dns_addrinfo *addrs, size_t count,
+		   uint32_t ttl);
+#endif
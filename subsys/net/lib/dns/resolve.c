@@ -460,6 +460,60 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 	return -ENOENT;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Answer the query from the DNS cache if possible, the same way as a
+ * response from a server would be passed to the callback.
+ */
+static int dns_cache_answer(const char *query, enum dns_query_type type,
+			    dns_resolve_cb_t cb, void *user_data)
+{
+	struct dns_addrinfo addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	int count;
+
+	count = dns_cache_find(query, type, addrs, ARRAY_SIZE(addrs));
+	if (count < 0) {
+		return count;
+	}
+
+	for (int i = 0; i < count; i++) {
+		cb(DNS_EAI_INPROGRESS, &addrs[i], user_data);
+	}
+
+	cb(count > 0 ? DNS_EAI_ALLDONE : DNS_EAI_NODATA, NULL, user_data);
+
+	return 0;
+}
+
+/* Must be invoked with context lock held */
+static void dns_cache_result(struct dns_pending_query *pending_query,
+			     int status, struct dns_msg_t *dns_msg)
+{
+	int rcode;
+
+	if (pending_query->query == NULL) {
+		return;
+	}
+
+	if (status == DNS_EAI_ALLDONE) {
+		dns_cache_add(pending_query->query, pending_query->query_type,
+			      pending_query->cache_addrs,
+			      pending_query->cache_count,
+			      pending_query->cache_ttl);
+		return;
+	}
+
+	/* Only a name that does not exist, or that has no records of the
+	 * type we asked for, is worth remembering. Server failures are not.
+	 */
+	rcode = dns_header_rcode(dns_msg->msg);
+	if (status == DNS_EAI_NODATA &&
+	    (rcode == DNS_HEADER_NOERROR || rcode == DNS_HEADER_NAMEERROR)) {
+		dns_cache_add(pending_query->query, pending_query->query_type,
+			      NULL, 0, CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL);
+	}
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /* Unit test needs to be able to call this function */
 #if !defined(CONFIG_NET_TEST)
 static
@@ -473,6 +527,7 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 {
 	struct dns_addrinfo info = { 0 };
 	uint32_t ttl; /* RR ttl, so far it is not passed to caller */
+	uint32_t min_ttl = UINT32_MAX;
 	uint8_t *src, *addr;
 	const char *query_name;
 	int address_size;
@@ -556,6 +611,8 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 			goto quit;
 		}
 
+		min_ttl = MIN(min_ttl, ttl);
+
 		switch (dns_msg->response_type) {
 		case DNS_RESPONSE_IP:
 			if (*query_idx >= 0) {
@@ -633,6 +690,19 @@ query_known:
 			src = dns_msg->msg + dns_msg->response_position;
 			memcpy(addr, src, address_size);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			{
+				struct dns_pending_query *pending_query =
+					&ctx->queries[*query_idx];
+
+				if (pending_query->cache_count <
+				    ARRAY_SIZE(pending_query->cache_addrs)) {
+					pending_query->cache_addrs[
+						pending_query->cache_count++] = info;
+				}
+			}
+#endif
+
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
 			items++;
@@ -673,6 +743,14 @@ query_known:
 		}
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* The results can be cached as long as any of the records, CNAMEs
+	 * included, is valid.
+	 */
+	ctx->queries[*query_idx].cache_ttl =
+		MIN(ctx->queries[*query_idx].cache_ttl, min_ttl);
+#endif
+
 	/* No IP addresses were found, so we take the last CNAME to generate
 	 * another query. Number of additional queries is controlled via Kconfig
 	 */
@@ -719,7 +797,7 @@ static int dns_read(struct dns_resolve_context *ctx,
 		    uint16_t *query_hash)
 {
 	/* Helper struct to track the dns msg received from the server */
-	struct dns_msg_t dns_msg;
+	struct dns_msg_t dns_msg = { 0 };
 	int data_len;
 	int ret;
 	int query_idx = -1;
@@ -739,6 +817,13 @@ static int dns_read(struct dns_resolve_context *ctx,
 
 	ret = dns_validate_msg(ctx, &dns_msg, dns_id, &query_idx,
 			       dns_cname, query_hash);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (query_idx >= 0 && query_idx < CONFIG_DNS_NUM_CONCUR_QUERIES) {
+		dns_cache_result(&ctx->queries[query_idx], ret, &dns_msg);
+	}
+#endif
+
 	if (ret == DNS_EAI_AGAIN) {
 		goto finished;
 	}
@@ -1182,6 +1267,16 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	}
 
 try_resolve:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_cache_answer(query, type, cb, user_data) == 0) {
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		return 0;
+	}
+#endif
+
 	k_mutex_lock(&ctx->lock, K_FOREVER);
 
 	if (ctx->state != DNS_RESOLVE_CONTEXT_ACTIVE) {
@@ -1202,6 +1297,10 @@ try_resolve:
 	ctx->queries[i].user_data = user_data;
 	ctx->queries[i].ctx = ctx;
 	ctx->queries[i].query_hash = 0;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].cache_count = 0U;
+	ctx->queries[i].cache_ttl = UINT32_MAX;
+#endif
 
 	k_work_init_delayable(&ctx->queries[i].timer, query_timeout);
 
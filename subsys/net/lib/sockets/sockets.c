@@ -22,6 +22,7 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <zephyr/syscall_handler.h>
 #include <zephyr/sys/fdtable.h>
 #include <zephyr/sys/math_extras.h>
+#include <time.h>
 
 #if defined(CONFIG_SOCKS)
 #include "socks.h"
@@ -263,6 +264,8 @@ int zsock_close_ctx(struct net_context *ctx)
 
 	zsock_flush_queue(ctx);
 
+	zsock_epoll_remove_ctx(ctx);
+
 	SET_ERRNO(net_context_put(ctx));
 
 	return 0;
@@ -354,6 +357,7 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_condvar_init(&new_ctx->cond.recv);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_epoll_notify(parent);
 
 		/* TCP context is effectively owned by both application
 		 * and the stack: stack may detect that peer closed/aborted
@@ -417,6 +421,8 @@ unlock:
 		(void)k_mutex_unlock(ctx->cond.lock);
 	}
 
+	zsock_epoll_notify(ctx);
+
 	/* Let reader to wake if it was sleeping */
 	(void)k_condvar_signal(&ctx->cond.recv);
 }
@@ -434,6 +440,8 @@ int zsock_shutdown_ctx(struct net_context *ctx, int how)
 
 		zsock_flush_queue(ctx);
 
+		zsock_epoll_notify(ctx);
+
 		/* Let reader to wake if it was sleeping */
 		(void)k_condvar_signal(&ctx->cond.recv);
 	} else if (how == ZSOCK_SHUT_WR || how == ZSOCK_SHUT_RDWR) {
@@ -1110,16 +1118,16 @@ int zsock_wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+/* Receives one datagram into the buffers of msg. msg_namelen is the size
+ * of msg_name on input and the size of the source address on output.
+ */
+static ssize_t zsock_recv_dgram_msg(struct net_context *ctx,
+				    struct msghdr *msg,
+				    int flags)
 {
 	k_timeout_t timeout = K_FOREVER;
 	size_t recv_len = 0;
-	size_t read_len;
+	size_t read_len = 0;
 	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
@@ -1159,7 +1167,9 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 
 	net_pkt_cursor_backup(pkt, &backup);
 
-	if (src_addr && addrlen) {
+	if (msg->msg_name) {
+		struct sockaddr *src_addr = msg->msg_name;
+
 		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
 			/*
@@ -1170,7 +1180,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			 */
 			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
 				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
+				       MIN(msg->msg_namelen, sizeof(ctx->remote)));
 			} else {
 				errno = ENOTSUP;
 				goto fail;
@@ -1179,7 +1189,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			int rv;
 
 			rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
-						   src_addr, *addrlen);
+						   src_addr, msg->msg_namelen);
 			if (rv < 0) {
 				errno = -rv;
 				LOG_ERR("sock_get_pkt_src_addr %d", rv);
@@ -1187,13 +1197,13 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			}
 		}
 
-		/* addrlen is a value-result argument, set to actual
+		/* msg_namelen is a value-result argument, set to actual
 		 * size of source address
 		 */
 		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
+			msg->msg_namelen = sizeof(struct sockaddr_in);
 		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
+			msg->msg_namelen = sizeof(struct sockaddr_in6);
 		} else {
 			errno = ENOTSUP;
 			goto fail;
@@ -1201,11 +1211,21 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
-	read_len = MIN(recv_len, max_len);
+	msg->msg_flags = 0;
 
-	if (net_pkt_read(pkt, buf, read_len)) {
-		errno = ENOBUFS;
-		goto fail;
+	for (size_t i = 0; i < msg->msg_iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(recv_len - read_len, msg->msg_iov[i].iov_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+
+		read_len += len;
+	}
+
+	if (read_len < recv_len) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
@@ -1229,6 +1249,33 @@ fail:
 	return -1;
 }
 
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       void *buf,
+				       size_t max_len,
+				       int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+	struct msghdr msg = {
+		.msg_name = addrlen ? src_addr : NULL,
+		.msg_namelen = addrlen ? *addrlen : 0,
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	ssize_t ret;
+
+	ret = zsock_recv_dgram_msg(ctx, &msg, flags);
+	if (ret >= 0 && msg.msg_name) {
+		*addrlen = msg.msg_namelen;
+	}
+
+	return ret;
+}
+
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 					void *buf,
 					size_t max_len,
@@ -1418,6 +1465,330 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+				 int flags)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recv_dgram_msg(ctx, msg, flags);
+	}
+
+	if (msg->msg_iovlen == 1) {
+		socklen_t *addrlen = msg->msg_name ? &msg->msg_namelen : NULL;
+
+		msg->msg_flags = 0;
+
+		return zsock_recvfrom_ctx(ctx, msg->msg_iov[0].iov_base,
+					  msg->msg_iov[0].iov_len, flags,
+					  msg->msg_name, addrlen);
+	}
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+/* Receives one message with the socket lock held, falling back to recvfrom
+ * for sockets that do not implement recvmsg.
+ */
+static ssize_t sock_recvmsg_locked(const struct socket_op_vtable *vtable,
+				   void *obj, struct msghdr *msg, int flags)
+{
+	socklen_t *addrlen;
+
+	msg->msg_controllen = 0;
+
+	if (vtable->recvmsg != NULL) {
+		return vtable->recvmsg(obj, msg, flags);
+	}
+
+	if (vtable->recvfrom == NULL || msg->msg_iovlen != 1) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	addrlen = msg->msg_name ? &msg->msg_namelen : NULL;
+	msg->msg_flags = 0;
+
+	return vtable->recvfrom(obj, msg->msg_iov[0].iov_base,
+				msg->msg_iov[0].iov_len, flags,
+				msg->msg_name, addrlen);
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int count = 0;
+#if defined(CONFIG_NET_BATCH)
+	struct net_if_tx_batch batch;
+	bool batched;
+#endif
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX);
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+#if defined(CONFIG_NET_BATCH)
+	/* The datagrams of native sockets are queued for sending together,
+	 * the socket lock keeps other threads from sending meanwhile.
+	 */
+	batched = vtable == &sock_fd_op_vtable &&
+		  net_context_get_type(obj) == SOCK_DGRAM;
+	if (batched) {
+		net_if_tx_batch_begin(&batch, obj);
+	}
+#endif
+
+	while (count < vlen) {
+		ssize_t ret;
+
+		ret = vtable->sendmsg(obj, &msgvec[count].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+		count++;
+	}
+
+#if defined(CONFIG_NET_BATCH)
+	if (batched) {
+		net_if_tx_batch_end(&batch);
+	}
+#endif
+
+	k_mutex_unlock(lock);
+
+	/* Like on other systems, an error is only reported if no message
+	 * was sent, errno is left as set by the failing call.
+	 */
+	return count > 0 ? count : (vlen > 0 ? -1 : 0);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	int count = 0;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX);
+
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	/* Each message is copied and sent on its own, the user buffers
+	 * cannot be passed down as they are.
+	 */
+	while (count < vlen) {
+		unsigned int msg_len;
+		ssize_t ret;
+
+		ret = z_vrfy_zsock_sendmsg(sock, &msgvec[count].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msg_len = ret;
+		Z_OOPS(z_user_to_copy(&msgvec[count].msg_len, &msg_len,
+				      sizeof(msg_len)));
+		count++;
+	}
+
+	return count > 0 ? count : (vlen > 0 ? -1 : 0);
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Longest recvmmsg() timeout in seconds whose end can be computed in
+ * ticks without overflowing. Longer ones never expire.
+ */
+#define MMSG_TIMEOUT_MAX_SEC						\
+	(IS_ENABLED(CONFIG_TIMEOUT_64BIT) ?				\
+	 (int64_t)UINT32_MAX :						\
+	 (int64_t)(INT32_MAX / CONFIG_SYS_CLOCK_TICKS_PER_SEC))
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags, struct timespec *timeout)
+{
+	const struct socket_op_vtable *vtable;
+	uint64_t end = 0;
+	struct k_mutex *lock;
+	void *obj;
+	int count = 0;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (timeout != NULL) {
+		if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+		    timeout->tv_nsec >= NSEC_PER_SEC) {
+			errno = EINVAL;
+			return -1;
+		}
+
+		if (timeout->tv_sec >= MMSG_TIMEOUT_MAX_SEC) {
+			end = UINT64_MAX;
+		} else {
+			end = sys_clock_timeout_end_calc(
+				K_MSEC((uint64_t)timeout->tv_sec * MSEC_PER_SEC +
+				       timeout->tv_nsec / NSEC_PER_MSEC));
+		}
+	}
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX);
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	while (count < vlen) {
+		int msg_flags = flags & ~ZSOCK_MSG_WAITFORONE;
+		ssize_t ret;
+
+		/* Once a message has been received, only take what is
+		 * already queued.
+		 */
+		if (count > 0 && (flags & ZSOCK_MSG_WAITFORONE)) {
+			msg_flags |= ZSOCK_MSG_DONTWAIT;
+		}
+
+		ret = sock_recvmsg_locked(vtable, obj, &msgvec[count].msg_hdr,
+					  msg_flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+		count++;
+
+		/* The timeout is only checked between messages, so a call
+		 * can still block on the next one past it.
+		 */
+		if (timeout != NULL && sys_clock_tick_get() >= end) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(lock);
+
+	return count > 0 ? count : (vlen > 0 ? -1 : 0);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags,
+					struct timespec *timeout)
+{
+	struct mmsghdr *msgvec_copy;
+	struct timespec timeout_copy;
+	unsigned int i, copied = 0;
+	int ret = -1;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX);
+	if (vlen == 0) {
+		return 0;
+	}
+
+	if (timeout) {
+		Z_OOPS(z_user_from_copy(&timeout_copy, timeout,
+					sizeof(timeout_copy)));
+	}
+
+	msgvec_copy = z_user_alloc_from_copy(msgvec,
+					     vlen * sizeof(struct mmsghdr));
+	if (!msgvec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The data and the source addresses are written straight into the
+	 * user buffers once these are known to be writable, only the iovec
+	 * arrays need a kernel copy.
+	 */
+	for (copied = 0; copied < vlen; copied++) {
+		struct msghdr *msg = &msgvec_copy[copied].msg_hdr;
+		struct iovec *iov = msg->msg_iov;
+		size_t iov_size;
+
+		msg->msg_control = NULL;
+
+		if (size_mul_overflow(msg->msg_iovlen, sizeof(struct iovec),
+				      &iov_size)) {
+			msg->msg_iov = NULL;
+			errno = EINVAL;
+			goto out;
+		}
+
+		msg->msg_iov = z_user_alloc_from_copy(iov, iov_size);
+		if (!msg->msg_iov) {
+			errno = ENOMEM;
+			goto out;
+		}
+
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			if (Z_SYSCALL_MEMORY_WRITE(msg->msg_iov[i].iov_base,
+						   msg->msg_iov[i].iov_len)) {
+				errno = EFAULT;
+				copied++;
+				goto out;
+			}
+		}
+
+		if (msg->msg_name &&
+		    Z_SYSCALL_MEMORY_WRITE(msg->msg_name, msg->msg_namelen)) {
+			errno = EFAULT;
+			copied++;
+			goto out;
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, msgvec_copy, vlen, flags,
+				    timeout ? &timeout_copy : NULL);
+
+	for (i = 0; ret > 0 && i < ret; i++) {
+		struct mmsghdr *src = &msgvec_copy[i];
+		struct mmsghdr *dst = &msgvec[i];
+
+		Z_OOPS(z_user_to_copy(&dst->msg_len, &src->msg_len,
+				      sizeof(src->msg_len)));
+		Z_OOPS(z_user_to_copy(&dst->msg_hdr.msg_namelen,
+				      &src->msg_hdr.msg_namelen,
+				      sizeof(src->msg_hdr.msg_namelen)));
+		Z_OOPS(z_user_to_copy(&dst->msg_hdr.msg_controllen,
+				      &src->msg_hdr.msg_controllen,
+				      sizeof(src->msg_hdr.msg_controllen)));
+		Z_OOPS(z_user_to_copy(&dst->msg_hdr.msg_flags,
+				      &src->msg_hdr.msg_flags,
+				      sizeof(src->msg_hdr.msg_flags)));
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		k_free(msgvec_copy[i].msg_hdr.msg_iov);
+	}
+
+	k_free(msgvec_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -2552,6 +2923,11 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -2595,6 +2971,7 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.sendto = sock_sendto_vmeth,
 	.sendmsg = sock_sendmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 	.getpeername = sock_getpeername_vmeth,
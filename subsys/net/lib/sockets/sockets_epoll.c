@@ -0,0 +1,645 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/syscall_handler.h>
+#include <zephyr/sys/fdtable.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_epoll.h>
+
+#include "sockets_internal.h"
+#include "../../ip/tcp_internal.h"
+
+/* Each socket in an interest list has an item, which is linked both to the
+ * epoll instance and to the net_context of the socket.  The socket receive
+ * and accept callbacks put the items of their socket on the ready lists of
+ * the instances and raise their signals, so zsock_epoll_wait() only looks
+ * at the sockets that had something happen.  Level triggered items that
+ * are still ready after being reported go back to the ready list.
+ *
+ * Nothing notifies a TCP socket becoming writable, so the items waiting
+ * for ZSOCK_EPOLLOUT are on a separate list that is checked on every wait,
+ * and the wait also polls the TX semaphores of the TCP sockets on it.
+ */
+
+#define EPOLL_EVENTS_ALWAYS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+#define EPOLL_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT | EPOLL_EVENTS_ALWAYS | \
+		      ZSOCK_EPOLLET)
+
+struct epoll_instance;
+
+struct epoll_item {
+	/** Node in the list of items of the socket */
+	sys_snode_t ctx_node;
+	/** Node in the ready list of the instance */
+	sys_snode_t ready_node;
+	/** Node in the list of items waiting for ZSOCK_EPOLLOUT */
+	sys_snode_t writer_node;
+
+	/** Instance of the item, NULL if the item is free */
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	zsock_epoll_data_t data;
+	uint32_t events;
+
+	/** Wait pass in which the item was last reported */
+	uint32_t pass;
+
+	/** The item is on the ready list */
+	bool queued;
+
+	/** Edge triggered ZSOCK_EPOLLOUT can be reported */
+	bool out_armed;
+};
+
+struct epoll_instance {
+	sys_slist_t ready;
+	sys_slist_t writers;
+	struct k_poll_signal signal;
+	uint32_t pass;
+	bool in_use;
+};
+
+static struct epoll_instance epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+static struct epoll_item epoll_items[CONFIG_NET_SOCKETS_EPOLL_MAX_FDS];
+
+/* Protects the instances, the items and the item lists of the sockets */
+static struct k_spinlock epoll_lock;
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+/* Returns the TX semaphore of a TCP socket, NULL for other sockets */
+static struct k_sem *epoll_ctx_tx_sem(struct net_context *ctx)
+{
+#if defined(CONFIG_NET_NATIVE_TCP)
+	if (net_context_get_type(ctx) == SOCK_STREAM && ctx->tcp != NULL) {
+		return net_tcp_tx_sem_get(ctx);
+	}
+#endif
+
+	return NULL;
+}
+
+static uint32_t epoll_ctx_events(struct net_context *ctx)
+{
+	uint32_t events = 0;
+
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	if (net_context_get_type(ctx) == SOCK_STREAM) {
+		struct k_sem *tx_sem = epoll_ctx_tx_sem(ctx);
+
+		if (tx_sem != NULL && !sock_is_eof(ctx) &&
+		    k_sem_count_get(tx_sem) > 0) {
+			events |= ZSOCK_EPOLLOUT;
+		}
+	} else {
+		events |= ZSOCK_EPOLLOUT;
+	}
+
+	if (sock_is_error(ctx)) {
+		events |= ZSOCK_EPOLLERR;
+	}
+
+	if (sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLHUP;
+	}
+
+	return events;
+}
+
+/* Must be invoked with the epoll lock held */
+static void epoll_item_queue(struct epoll_item *item)
+{
+	if (!item->queued) {
+		sys_slist_append(&item->ep->ready, &item->ready_node);
+		item->queued = true;
+	}
+}
+
+/* Must be invoked with the epoll lock held */
+static void epoll_item_free(struct epoll_item *item)
+{
+	struct epoll_instance *ep = item->ep;
+
+	if (item->queued) {
+		sys_slist_find_and_remove(&ep->ready, &item->ready_node);
+	}
+
+	if (item->events & ZSOCK_EPOLLOUT) {
+		sys_slist_find_and_remove(&ep->writers, &item->writer_node);
+	}
+
+	item->ep = NULL;
+	item->ctx = NULL;
+	item->queued = false;
+}
+
+/* Must be invoked with the epoll lock held */
+static void epoll_item_set(struct epoll_item *item,
+			   const struct zsock_epoll_event *event)
+{
+	uint32_t events = event->events | EPOLL_EVENTS_ALWAYS;
+
+	if ((item->events & ZSOCK_EPOLLOUT) && !(events & ZSOCK_EPOLLOUT)) {
+		sys_slist_find_and_remove(&item->ep->writers,
+					  &item->writer_node);
+	} else if (!(item->events & ZSOCK_EPOLLOUT) &&
+		   (events & ZSOCK_EPOLLOUT)) {
+		sys_slist_append(&item->ep->writers, &item->writer_node);
+	}
+
+	item->events = events;
+	item->data = event->data;
+	item->out_armed = true;
+
+	/* Let the next wait report whatever is ready already */
+	epoll_item_queue(item);
+	k_poll_signal_raise(&item->ep->signal, 0);
+}
+
+/* Must be invoked with the epoll lock held */
+static struct epoll_item *epoll_item_find(struct epoll_instance *ep,
+					  struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->ep == ep) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be invoked with the epoll lock held */
+static struct epoll_item *epoll_item_alloc(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(epoll_items); i++) {
+		if (epoll_items[i].ep == NULL) {
+			return &epoll_items[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns the events of the item to report. If from_ready is false, only
+ * ZSOCK_EPOLLOUT is checked.
+ */
+static uint32_t epoll_item_revents(struct epoll_item *item, bool from_ready)
+{
+	uint32_t ready = epoll_ctx_events(item->ctx);
+	uint32_t revents = 0;
+
+	if (from_ready) {
+		revents = ready & item->events & ~ZSOCK_EPOLLOUT;
+	}
+
+	if (item->events & ZSOCK_EPOLLOUT) {
+		if (!(ready & ZSOCK_EPOLLOUT)) {
+			item->out_armed = true;
+		} else if (!(item->events & ZSOCK_EPOLLET) || item->out_armed) {
+			revents |= ZSOCK_EPOLLOUT;
+			item->out_armed = false;
+		}
+	}
+
+	return revents;
+}
+
+void zsock_epoll_notify(struct net_context *ctx)
+{
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+	struct epoll_item *item;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		epoll_item_queue(item);
+		k_poll_signal_raise(&item->ep->signal, 0);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+void zsock_epoll_remove_ctx(struct net_context *ctx)
+{
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&ctx->epoll_items)) != NULL) {
+		epoll_item_free(CONTAINER_OF(node, struct epoll_item,
+					     ctx_node));
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	k_spinlock_key_t key = k_spin_lock(&epoll_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(epoll_items); i++) {
+		struct epoll_item *item = &epoll_items[i];
+
+		if (item->ep == ep) {
+			sys_slist_find_and_remove(&item->ctx->epoll_items,
+						  &item->ctx_node);
+			epoll_item_free(item);
+		}
+	}
+
+	ep->in_use = false;
+
+	k_spin_unlock(&epoll_lock, key);
+
+	return 0;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
+
+int z_impl_zsock_epoll_create(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	k_spinlock_key_t key;
+	int fd;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].in_use) {
+			ep = &epolls[i];
+			break;
+		}
+	}
+
+	if (ep != NULL) {
+		sys_slist_init(&ep->ready);
+		sys_slist_init(&ep->writers);
+		k_poll_signal_init(&ep->signal);
+		ep->in_use = true;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	NET_DBG("epoll %p created, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create(int flags)
+{
+	return z_impl_zsock_epoll_create(flags);
+}
+#include <syscalls/zsock_epoll_create_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL &&
+	    (event == NULL || (event->events & ~EPOLL_EVENTS))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Only native sockets report their events */
+	if (vtable != &sock_fd_op_vtable.fd_vtable) {
+		errno = EPERM;
+		return -1;
+	}
+
+	/* Keep the socket from being closed meanwhile */
+	(void)k_mutex_lock(lock, K_FOREVER);
+	key = k_spin_lock(&epoll_lock);
+
+	item = epoll_item_find(ep, ctx);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		item = epoll_item_alloc();
+		if (item == NULL) {
+			ret = -ENOMEM;
+			break;
+		}
+
+		item->ep = ep;
+		item->ctx = ctx;
+		item->events = 0;
+		item->pass = ep->pass;
+		item->queued = false;
+		sys_slist_append(&ctx->epoll_items, &item->ctx_node);
+
+		epoll_item_set(item, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_set(item, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		sys_slist_find_and_remove(&ctx->epoll_items, &item->ctx_node);
+		epoll_item_free(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+	k_mutex_unlock(lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int fd,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+	void *ctx;
+
+	ctx = z_get_fd_obj(fd, &sock_fd_op_vtable.fd_vtable, EPERM);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	Z_OOPS(Z_SYSCALL_OBJ(ctx, K_OBJ_NET_SOCKET));
+
+	if (event != NULL) {
+		Z_OOPS(z_user_from_copy(&event_copy, event,
+					sizeof(event_copy)));
+	}
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd,
+				      event != NULL ? &event_copy : NULL);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Collects the events to report, and the TX semaphores to wait for if
+ * there are none. Must be invoked with the epoll lock held.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents,
+			 struct k_poll_event *pev, int *npev, int pev_max)
+{
+	sys_slist_t ready = ep->ready;
+	struct epoll_item *item;
+	sys_snode_t *node;
+	int count = 0;
+
+	ep->pass++;
+	sys_slist_init(&ep->ready);
+
+	while (count < maxevents && (node = sys_slist_get(&ready)) != NULL) {
+		uint32_t revents;
+
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+		item->queued = false;
+
+		revents = epoll_item_revents(item, true);
+		if (revents == 0) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->data;
+		count++;
+
+		item->pass = ep->pass;
+
+		/* Until it is notified again, an edge triggered item is not
+		 * looked at, while a level triggered one is checked again.
+		 */
+		if (!(item->events & ZSOCK_EPOLLET)) {
+			epoll_item_queue(item);
+		}
+	}
+
+	/* Items that did not fit come first next time */
+	sys_slist_merge_slist(&ready, &ep->ready);
+	ep->ready = ready;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ep->writers, item, writer_node) {
+		struct k_sem *tx_sem;
+		uint32_t revents;
+
+		if (count == maxevents) {
+			break;
+		}
+
+		if (item->pass == ep->pass) {
+			continue;
+		}
+
+		revents = epoll_item_revents(item, false);
+		if (revents != 0) {
+			events[count].events = revents;
+			events[count].data = item->data;
+			count++;
+			continue;
+		}
+
+		tx_sem = epoll_ctx_tx_sem(item->ctx);
+		if (tx_sem == NULL) {
+			continue;
+		}
+
+		if (*npev == pev_max) {
+			return -ENOMEM;
+		}
+
+		k_poll_event_init(&pev[*npev], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, tx_sem);
+		(*npev)++;
+	}
+
+	return count;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	/* The signal, and the TX semaphores of the unwritable sockets */
+	struct k_poll_event pev[1 + CONFIG_NET_SOCKETS_EPOLL_WAIT_MAX];
+	struct epoll_instance *ep;
+	k_timeout_t wait;
+	uint64_t end;
+	int ret;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	wait = timeout < 0 ? K_FOREVER : K_MSEC(timeout);
+	end = sys_clock_timeout_end_calc(wait);
+
+	while (true) {
+		k_spinlock_key_t key;
+		int npev = 1;
+
+		key = k_spin_lock(&epoll_lock);
+
+		/* Anything notified from now on raises the signal again */
+		k_poll_signal_reset(&ep->signal);
+		k_poll_event_init(&pev[0], K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &ep->signal);
+
+		ret = epoll_collect(ep, events, maxevents, pev, &npev,
+				    ARRAY_SIZE(pev));
+
+		k_spin_unlock(&epoll_lock, key);
+
+		if (ret != 0 || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				break;
+			}
+
+			wait = Z_TIMEOUT_TICKS(remaining);
+		}
+
+		ret = k_poll(pev, npev, wait);
+		if (ret == -EAGAIN) {
+			/* Timed out, collect once more without waiting */
+			wait = K_NO_WAIT;
+		} else if (ret != 0) {
+			break;
+		}
+	}
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(events, maxevents,
+					    sizeof(struct zsock_epoll_event)));
+
+	return z_impl_zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
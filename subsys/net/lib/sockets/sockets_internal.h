@@ -47,6 +47,21 @@ static inline bool net_socket_is_tls(void *obj)
 }
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+void zsock_epoll_notify(struct net_context *ctx);
+void zsock_epoll_remove_ctx(struct net_context *ctx);
+#else
+static inline void zsock_epoll_notify(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void zsock_epoll_remove_ctx(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif
+
 #define sock_is_eof(ctx) sock_get_flag(ctx, SOCK_EOF)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
@@ -74,8 +89,11 @@ struct socket_op_vtable {
 			   socklen_t *addrlen);
 	int (*getsockname)(void *obj, struct sockaddr *addr,
 			   socklen_t *addrlen);
+	ssize_t (*recvmsg)(void *obj, struct msghdr *msg, int flags);
 };
 
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
 size_t msghdr_non_empty_iov_count(const struct msghdr *msg);
 
 #endif /* _SOCKETS_INTERNAL_H_ */
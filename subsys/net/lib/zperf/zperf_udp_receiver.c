@@ -38,6 +38,7 @@ static struct sockaddr_in *in4_addr_my;
 #define SOCK_ID_MAX 2
 
 #define UDP_RECEIVER_BUF_SIZE 1500
+#define UDP_RECEIVER_BATCH CONFIG_NET_ZPERF_UDP_RECV_BATCH
 #define POLL_TIMEOUT_MS 100
 
 static K_THREAD_STACK_DEFINE(udp_receiver_stack_area, UDP_RECEIVER_STACK_SIZE);
@@ -229,9 +230,57 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 	}
 }
 
+/* Reads the queued datagrams of a socket, up to UDP_RECEIVER_BATCH of
+ * them in one call.
+ */
+static int udp_receive(int sock)
+{
+	static uint8_t bufs[UDP_RECEIVER_BATCH][UDP_RECEIVER_BUF_SIZE];
+	static struct sockaddr addrs[UDP_RECEIVER_BATCH];
+	struct mmsghdr msgs[UDP_RECEIVER_BATCH];
+	struct iovec iov[UDP_RECEIVER_BATCH];
+	int ret;
+
+	if (UDP_RECEIVER_BATCH == 1) {
+		socklen_t addrlen = sizeof(addrs[0]);
+
+		ret = zsock_recvfrom(sock, bufs[0], sizeof(bufs[0]), 0,
+				     &addrs[0], &addrlen);
+		if (ret < 0) {
+			return ret;
+		}
+
+		udp_received(sock, &addrs[0], bufs[0], ret);
+
+		return 0;
+	}
+
+	for (int i = 0; i < UDP_RECEIVER_BATCH; i++) {
+		iov[i].iov_base = bufs[i];
+		iov[i].iov_len = sizeof(bufs[i]);
+
+		memset(&msgs[i], 0, sizeof(msgs[i]));
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	ret = zsock_recvmmsg(sock, msgs, UDP_RECEIVER_BATCH,
+			     ZSOCK_MSG_WAITFORONE, NULL);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		udp_received(sock, &addrs[i], bufs[i], msgs[i].msg_len);
+	}
+
+	return 0;
+}
+
 static void udp_server_session(void)
 {
-	static uint8_t buf[UDP_RECEIVER_BUF_SIZE];
 	struct zsock_pollfd fds[SOCK_ID_MAX] = { 0 };
 	int ret;
 
@@ -358,9 +407,6 @@ static void udp_server_session(void)
 		}
 
 		for (int i = 0; i < ARRAY_SIZE(fds); i++) {
-			struct sockaddr addr;
-			socklen_t addrlen = sizeof(addr);
-
 			if ((fds[i].revents & ZSOCK_POLLERR) ||
 			    (fds[i].revents & ZSOCK_POLLNVAL)) {
 				NET_ERR("UDP receiver IPv%d socket error",
@@ -372,15 +418,12 @@ static void udp_server_session(void)
 				continue;
 			}
 
-			ret = zsock_recvfrom(fds[i].fd, buf, sizeof(buf), 0,
-					     &addr, &addrlen);
+			ret = udp_receive(fds[i].fd);
 			if (ret < 0) {
 				NET_ERR("recv failed on IPv%d socket (%d)",
 					(i == SOCK_ID_IPV4) ? 4 : 6, errno);
 				goto error;
 			}
-
-			udp_received(fds[i].fd, &addr, buf, ret);
 		}
 	}
 
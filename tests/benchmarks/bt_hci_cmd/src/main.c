@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/buf.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/drivers/bluetooth/hci_driver.h>
+
+/* This measures how long the Host takes to bring up the Controller and to
+ * get through a burst of HCI commands, when each command takes
+ * CMD_LATENCY_US to reach the Controller and have its Command Complete come
+ * back. The Controller is simulated: it takes up to CTLR_CMD_COUNT commands
+ * at a time, and completes each one CMD_LATENCY_US after it was sent. The
+ * time is the simulated one, so only the waits on the Controller count.
+ */
+
+#define CTLR_CMD_COUNT 4
+#define CMD_LATENCY_US 500
+#define N_CMDS 64
+
+#define CTLR_STACK_SIZE 1024
+#define CTLR_PRIO K_PRIO_COOP(6)
+
+static K_FIFO_DEFINE(cmd_fifo);
+static int64_t cmd_sent[CONFIG_BT_BUF_CMD_TX_COUNT];
+static atomic_t cmd_in_flight;
+static atomic_t cmd_cnt;
+static atomic_t cmd_unknown;
+
+static K_SEM_DEFINE(burst_sem, 0, 1);
+static uint32_t burst_done;
+static uint32_t burst_failed;
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+};
+
+/* Commands needed for bt_enable, and the one used for the burst */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info) },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands) },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features) },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr) },
+	{ BT_HCI_OP_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status) },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status) },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features) },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states) },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand) },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS,
+	  sizeof(struct bt_hci_evt_cc_status) },
+};
+
+/* Answer a command with a Command Complete, all features and commands
+ * being reported as supported.
+ */
+static void cmd_handle(struct net_buf *cmd, uint8_t ncmd)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+	struct bt_hci_cmd_hdr *chdr;
+	struct bt_hci_evt_hdr *hdr;
+	struct net_buf *evt;
+	uint16_t opcode;
+	uint8_t *rp;
+	uint8_t len = sizeof(struct bt_hci_evt_cc_status);
+	uint8_t status = BT_HCI_ERR_UNKNOWN_CMD;
+
+	chdr = net_buf_pull_mem(cmd, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			len = cmds[i].len;
+			status = BT_HCI_ERR_SUCCESS;
+			break;
+		}
+	}
+
+	if (status) {
+		atomic_inc(&cmd_unknown);
+	}
+
+	/* The command buffer may be reused for the event, the OpCode must be
+	 * read before.
+	 */
+	evt = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+
+	hdr = net_buf_add(evt, sizeof(*hdr));
+	hdr->evt = BT_HCI_EVT_CMD_COMPLETE;
+	hdr->len = sizeof(*cc) + len;
+
+	cc = net_buf_add(evt, sizeof(*cc));
+	cc->ncmd = ncmd;
+	cc->opcode = sys_cpu_to_le16(opcode);
+
+	rp = net_buf_add(evt, len);
+	(void)memset(rp, 0xFF, len);
+	rp[0] = status;
+
+	bt_recv_prio(evt);
+}
+
+static void ctlr_thread(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		struct net_buf *buf;
+		atomic_val_t in_flight;
+
+		buf = net_buf_get(&cmd_fifo, K_FOREVER);
+
+		k_sleep(K_TIMEOUT_ABS_TICKS(cmd_sent[net_buf_id(buf)] +
+					    k_us_to_ticks_ceil64(CMD_LATENCY_US)));
+
+		in_flight = atomic_dec(&cmd_in_flight) - 1;
+		cmd_handle(buf, MAX(CTLR_CMD_COUNT - in_flight, 0));
+
+		net_buf_unref(buf);
+	}
+}
+
+K_THREAD_DEFINE(ctlr_tid, CTLR_STACK_SIZE, ctlr_thread, NULL, NULL, NULL,
+		CTLR_PRIO, 0, 0);
+
+static int driver_open(void)
+{
+	return 0;
+}
+
+static int driver_send(struct net_buf *buf)
+{
+	cmd_sent[net_buf_id(buf)] = k_uptime_ticks();
+	atomic_inc(&cmd_in_flight);
+	atomic_inc(&cmd_cnt);
+
+	net_buf_put(&cmd_fifo, buf);
+
+	return 0;
+}
+
+static const struct bt_hci_driver drv = {
+	.name         = "bench",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+static void burst_cb(uint16_t opcode, uint8_t status, struct net_buf *rsp,
+		     void *user_data)
+{
+	if (status) {
+		burst_failed++;
+	}
+
+	if (++burst_done == N_CMDS) {
+		k_sem_give(&burst_sem);
+	}
+}
+
+int main(void)
+{
+	int64_t start;
+	int err;
+
+	bt_hci_driver_register(&drv);
+
+	printk("HCI command benchmark, %d credits, %d us per command\n",
+	       CONFIG_BT_HCI_CMD_CREDITS_MAX, CMD_LATENCY_US);
+
+	start = k_uptime_ticks();
+
+	err = bt_enable(NULL);
+	if (err) {
+		printk("cannot enable Bluetooth (%d)\n", err);
+		return 0;
+	}
+
+	printk("bt_enable: %u commands in %u us\n", (uint32_t)atomic_get(&cmd_cnt),
+	       (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() - start));
+
+	start = k_uptime_ticks();
+
+	for (int i = 0; i < N_CMDS; i++) {
+		err = bt_hci_cmd_send_cb(BT_HCI_OP_LE_RAND, NULL, burst_cb, NULL);
+		if (err) {
+			printk("cannot send command (%d)\n", err);
+			return 0;
+		}
+	}
+
+	k_sem_take(&burst_sem, K_FOREVER);
+
+	if (burst_failed || atomic_get(&cmd_unknown)) {
+		printk("%u commands failed, %u unknown\n", burst_failed,
+		       (uint32_t)atomic_get(&cmd_unknown));
+		return 0;
+	}
+
+	printk("burst: %u us per command\n",
+	       (uint32_t)(k_ticks_to_us_floor64(k_uptime_ticks() - start) / N_CMDS));
+
+	printk("fin\n");
+
+	return 0;
+}
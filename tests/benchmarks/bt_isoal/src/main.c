@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <time.h>
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/hci.h>
+
+#include "util/memq.h"
+
+#include "pdu_df.h"
+#include "lll/pdu_vendor.h"
+#include "pdu.h"
+
+#include "lll.h"
+#include "lll_iso_tx.h"
+#include "isoal.h"
+
+/* This measures the time the ISO-AL takes to turn SDUs into PDUs and back,
+ * as on a central with N LE Audio streams of SDU_LEN octet SDUs every
+ * 7.5 ms. Each interval, an SDU is given to the source of every stream, and
+ * the PDUs that come out are given in turn to the sink of the same stream,
+ * which must rebuild the SDU. The SDUs span BN PDUs, so that they are
+ * fragmented (unframed) or segmented (framed). The average time per SDU is
+ * reported for each direction.
+ */
+
+#define N_ROUNDS 2000
+#define MAX_STREAMS 8
+#define SDU_INTERVAL_US 7500
+#define ISO_INTERVAL 6 /* 7.5 ms, in units of 1.25 ms */
+#define SDU_LEN 90
+#define BN 2
+#define MAX_PDU_UNFRAMED (SDU_LEN / BN)
+#define MAX_PDU_FRAMED (SDU_LEN / BN + PDU_ISO_SEG_HDR_SIZE + \
+			PDU_ISO_SEG_TIMEOFFSET_SIZE)
+
+#define PDU_PAYLOAD_MAX 251
+#define PDU_BUF_SIZE (sizeof(struct node_tx_iso) + \
+		      offsetof(struct pdu_iso, payload) + PDU_PAYLOAD_MAX)
+/* PDUs of one interval, plus framed PDUs held until the next one */
+#define N_PDUS (MAX_STREAMS * BN * 2)
+
+static const uint8_t levels[] = { 4, MAX_STREAMS };
+
+static uint8_t pdu_bufs[N_PDUS][PDU_BUF_SIZE] __aligned(8);
+static struct node_tx_iso *pdu_free[N_PDUS];
+static uint8_t pdu_free_cnt;
+
+static struct {
+	struct node_tx_iso *node;
+	uint16_t handle;
+} emitted[N_PDUS];
+static uint8_t emitted_cnt;
+
+static struct stream {
+	isoal_source_handle_t source;
+	isoal_sink_handle_t sink;
+	uint8_t sdu[SDU_LEN];
+	uint8_t rx_sdu[SDU_LEN];
+	uint16_t rx_len;
+	uint32_t rx_cnt;
+	bool rx_err;
+} streams[MAX_STREAMS];
+
+static isoal_status_t pdu_alloc(struct isoal_pdu_buffer *pdu_buffer)
+{
+	struct node_tx_iso *node_tx;
+
+	if (!pdu_free_cnt) {
+		return ISOAL_STATUS_ERR_PDU_ALLOC;
+	}
+
+	node_tx = pdu_free[--pdu_free_cnt];
+
+	pdu_buffer->handle = node_tx;
+	pdu_buffer->pdu = (void *)node_tx->pdu;
+	pdu_buffer->size = PDU_PAYLOAD_MAX;
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t pdu_write(struct isoal_pdu_buffer *pdu_buffer,
+				const size_t offset, const uint8_t *sdu_payload,
+				const size_t consume_len)
+{
+	if ((offset + consume_len) > pdu_buffer->size) {
+		return ISOAL_STATUS_ERR_UNSPECIFIED;
+	}
+
+	memcpy(&pdu_buffer->pdu->payload[offset], sdu_payload, consume_len);
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t pdu_emit(struct node_tx_iso *node_tx,
+			       const uint16_t handle)
+{
+	emitted[emitted_cnt].node = node_tx;
+	emitted[emitted_cnt].handle = handle;
+	emitted_cnt++;
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t pdu_release(struct node_tx_iso *node_tx,
+				  const uint16_t handle,
+				  const isoal_status_t status)
+{
+	pdu_free[pdu_free_cnt++] = node_tx;
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t sdu_alloc(const struct isoal_sink *sink_ctx,
+				const struct isoal_pdu_rx *valid_pdu,
+				struct isoal_sdu_buffer *sdu_buffer)
+{
+	uint16_t handle = sink_ctx->session.handle;
+
+	streams[handle].rx_len = 0U;
+
+	sdu_buffer->dbuf = &streams[handle];
+	sdu_buffer->size = SDU_LEN;
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t sdu_write(void *dbuf, const uint8_t *pdu_payload,
+				const size_t consume_len)
+{
+	struct stream *stream = dbuf;
+
+	memcpy(&stream->rx_sdu[stream->rx_len], pdu_payload, consume_len);
+	stream->rx_len += consume_len;
+
+	return ISOAL_STATUS_OK;
+}
+
+static isoal_status_t sdu_emit(const struct isoal_sink *sink_ctx,
+			       const struct isoal_emitted_sdu_frag *sdu_frag,
+			       const struct isoal_emitted_sdu *sdu)
+{
+	struct stream *stream = &streams[sink_ctx->session.handle];
+
+	if ((sdu_frag->sdu.status != ISOAL_SDU_STATUS_VALID) ||
+	    (sdu_frag->sdu_state != BT_ISO_SINGLE) ||
+	    (sdu->total_sdu_size != SDU_LEN) ||
+	    memcmp(stream->rx_sdu, stream->sdu, SDU_LEN)) {
+		stream->rx_err = true;
+	}
+
+	stream->rx_cnt++;
+
+	return ISOAL_STATUS_OK;
+}
+
+static void streams_create(uint8_t n, bool framed)
+{
+	isoal_status_t err;
+
+	err = isoal_init();
+	zassert_equal(err, ISOAL_STATUS_OK, "cannot init ISO-AL");
+
+	pdu_free_cnt = 0U;
+	for (int i = 0; i < N_PDUS; i++) {
+		pdu_free[pdu_free_cnt++] = (void *)pdu_bufs[i];
+	}
+
+	emitted_cnt = 0U;
+	(void)memset(streams, 0, sizeof(streams));
+
+	for (uint16_t s = 0U; s < n; s++) {
+		err = isoal_source_create(s, BT_CONN_ROLE_CENTRAL, framed, BN, 1U,
+					  framed ? MAX_PDU_FRAMED : MAX_PDU_UNFRAMED,
+					  SDU_INTERVAL_US, ISO_INTERVAL, 0U, 0U,
+					  pdu_alloc, pdu_write, pdu_emit,
+					  pdu_release, &streams[s].source);
+		zassert_equal(err, ISOAL_STATUS_OK, "cannot create source %u", s);
+
+		err = isoal_sink_create(s, BT_CONN_ROLE_PERIPHERAL, framed, BN, 1U,
+					SDU_INTERVAL_US, ISO_INTERVAL, 0U, 0U,
+					sdu_alloc, sdu_emit, sdu_write,
+					&streams[s].sink);
+		zassert_equal(err, ISOAL_STATUS_OK, "cannot create sink %u", s);
+
+		isoal_source_enable(streams[s].source);
+		isoal_sink_enable(streams[s].sink);
+	}
+}
+
+static uint64_t ns_since(const struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return (end.tv_sec - start->tv_sec) * 1000000000ULL +
+	       end.tv_nsec - start->tv_nsec;
+}
+
+static void streams_run(uint8_t n, uint64_t *tx_ns, uint64_t *rx_ns)
+{
+	*tx_ns = 0U;
+	*rx_ns = 0U;
+
+	for (uint32_t round = 1U; round <= N_ROUNDS; round++) {
+		uint32_t ref_point = round * SDU_INTERVAL_US;
+		struct timespec start;
+
+		for (uint8_t s = 0U; s < n; s++) {
+			for (int i = 0; i < SDU_LEN; i++) {
+				streams[s].sdu[i] = round + s + i;
+			}
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		for (uint8_t s = 0U; s < n; s++) {
+			struct isoal_sdu_tx sdu = {
+				.dbuf = streams[s].sdu,
+				.size = SDU_LEN,
+				.sdu_state = BT_ISO_SINGLE,
+				.packet_sn = round,
+				.iso_sdu_length = SDU_LEN,
+				.time_stamp = ref_point - SDU_INTERVAL_US / 2U,
+				.grp_ref_point = ref_point,
+				.target_event = round,
+			};
+			isoal_status_t err;
+
+			err = isoal_tx_sdu_fragment(streams[s].source, &sdu);
+			zassert_equal(err, ISOAL_STATUS_OK,
+				      "cannot fragment SDU of stream %u", s);
+
+			isoal_tx_event_prepare(streams[s].source, round);
+		}
+
+		*tx_ns += ns_since(&start);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		for (uint8_t i = 0U; i < emitted_cnt; i++) {
+			struct node_tx_iso *node_tx = emitted[i].node;
+			struct node_rx_iso_meta meta = {
+				.payload_number = node_tx->payload_count,
+				.status = ISOAL_PDU_STATUS_VALID,
+				.timestamp = ref_point,
+			};
+			struct isoal_pdu_rx pdu_rx = {
+				.meta = &meta,
+				.pdu = (void *)node_tx->pdu,
+			};
+			isoal_status_t err;
+
+			err = isoal_rx_pdu_recombine(streams[emitted[i].handle].sink,
+						     &pdu_rx);
+			zassert_equal(err, ISOAL_STATUS_OK,
+				      "cannot recombine PDU of stream %u",
+				      emitted[i].handle);
+
+			isoal_tx_pdu_release(streams[emitted[i].handle].source,
+					     node_tx);
+		}
+
+		*rx_ns += ns_since(&start);
+
+		emitted_cnt = 0U;
+	}
+}
+
+static void streams_measure(bool framed)
+{
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		uint8_t n = levels[i];
+		uint64_t tx_ns, rx_ns;
+
+		streams_create(n, framed);
+		streams_run(n, &tx_ns, &rx_ns);
+
+		for (uint8_t s = 0U; s < n; s++) {
+			zassert_equal(streams[s].rx_cnt, N_ROUNDS,
+				      "stream %u received %u SDUs", s,
+				      streams[s].rx_cnt);
+			zassert_false(streams[s].rx_err,
+				      "stream %u received bad SDUs", s);
+		}
+
+		printk("%s streams %u: %u ns per SDU tx, %u ns per SDU rx\n",
+		       framed ? "framed" : "unframed", n,
+		       (uint32_t)(tx_ns / (N_ROUNDS * n)),
+		       (uint32_t)(rx_ns / (N_ROUNDS * n)));
+	}
+}
+
+ZTEST(bt_isoal, test_unframed)
+{
+	streams_measure(false);
+}
+
+ZTEST(bt_isoal, test_framed)
+{
+	streams_measure(true);
+}
+
+ZTEST_SUITE(bt_isoal, NULL, NULL, NULL, NULL, NULL);
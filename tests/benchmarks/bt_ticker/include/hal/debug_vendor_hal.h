@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* No debug pins on the host */
+#define DEBUG_TICKER_ISR(flag)
+#define DEBUG_TICKER_TASK(flag)
+#define DEBUG_TICKER_JOB(flag)
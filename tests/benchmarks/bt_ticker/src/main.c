@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <time.h>
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+
+#include "hal/cntr.h"
+#include "hal/ticker.h"
+
+#include "ticker/ticker.h"
+
+/* This measures how the cost of running the ticker grows with the number of
+ * ticker nodes, as on a central with many connections. N tickers share the
+ * same interval and each reserves a slot, the slots following one another
+ * without overlap. The counter is simulated: it jumps to each compare value
+ * the ticker sets, and the ticker worker and job are run in turn until none
+ * is pending. At each level the average time spent per expiry is reported,
+ * and every ticker is checked to have expired once per interval, in order.
+ */
+
+#define N_ROUNDS 20
+#define MAX_TICKERS 240
+#define TICKS_SPACING 32
+#define TICKS_SLOT 16
+#define TICKS_PERIODIC (MAX_TICKERS * TICKS_SPACING)
+
+#define INSTANCE_INDEX 0
+#define USER_ID 0
+#define USER_OPS 4
+
+static const uint8_t levels[] = { 8, 64, MAX_TICKERS };
+
+static uint8_t ticker_nodes[MAX_TICKERS][TICKER_NODE_T_SIZE] __aligned(4);
+static uint8_t ticker_users[1][TICKER_USER_T_SIZE] __aligned(4);
+static uint8_t ticker_user_ops[USER_OPS][TICKER_USER_OP_T_SIZE] __aligned(4);
+
+static void *ticker_instance;
+static bool worker_pending;
+static bool job_pending;
+
+static uint32_t cntr;
+static uint32_t cntr_cmp;
+
+static uint32_t expire_cnt[MAX_TICKERS];
+static uint32_t expire_total;
+static uint32_t ticks_last;
+static bool out_of_order;
+
+uint32_t cntr_start(void)
+{
+	return 0;
+}
+
+uint32_t cntr_stop(void)
+{
+	return 0;
+}
+
+uint32_t cntr_cnt_get(void)
+{
+	return cntr;
+}
+
+static uint8_t caller_id_get(uint8_t user_id)
+{
+	return TICKER_CALL_ID_PROGRAM;
+}
+
+static void sched(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
+		  void *instance)
+{
+	ticker_instance = instance;
+
+	if (callee_id == TICKER_CALL_ID_WORKER) {
+		worker_pending = true;
+	} else if (callee_id == TICKER_CALL_ID_JOB) {
+		job_pending = true;
+	}
+}
+
+static void trigger_set(uint32_t value)
+{
+	cntr_cmp = value;
+}
+
+static void run_pending(void)
+{
+	while (worker_pending || job_pending) {
+		if (worker_pending) {
+			worker_pending = false;
+			ticker_worker(ticker_instance);
+		} else {
+			job_pending = false;
+			ticker_job(ticker_instance);
+		}
+	}
+}
+
+static void ticker_cb(uint32_t ticks_at_expire, uint32_t ticks_drift,
+		      uint32_t remainder, uint16_t lazy, uint8_t force,
+		      void *context)
+{
+	uint8_t id = (uintptr_t)context;
+
+	if (expire_total && ((ticker_ticks_diff_get(ticks_at_expire, ticks_last) &
+			      BIT(HAL_TICKER_CNTR_MSBIT)) || lazy)) {
+		out_of_order = true;
+	}
+
+	ticks_last = ticks_at_expire;
+	expire_cnt[id]++;
+	expire_total++;
+}
+
+static void op_cb(uint32_t status, void *op_context)
+{
+	*(uint32_t *)op_context = status;
+}
+
+static void tickers_start(uint8_t n)
+{
+	int err;
+
+	cntr = 0U;
+	cntr_cmp = 0U;
+	expire_total = 0U;
+	out_of_order = false;
+	(void)memset(expire_cnt, 0, sizeof(expire_cnt));
+
+	/* Drop the tickers of the previous level */
+	(void)memset(ticker_nodes, 0, sizeof(ticker_nodes));
+	(void)memset(ticker_users, 0, sizeof(ticker_users));
+
+	ticker_users[0][0] = USER_OPS;
+	err = ticker_init(INSTANCE_INDEX, MAX_TICKERS, ticker_nodes,
+			  ARRAY_SIZE(ticker_users), ticker_users, USER_OPS,
+			  ticker_user_ops, caller_id_get, sched, trigger_set);
+	zassert_equal(err, TICKER_STATUS_SUCCESS, "cannot init ticker");
+
+	for (uint8_t id = 0U; id < n; id++) {
+		uint32_t status = TICKER_STATUS_BUSY;
+
+		err = ticker_start(INSTANCE_INDEX, USER_ID, id, cntr,
+				   (id + 1U) * TICKS_SPACING, TICKS_PERIODIC,
+				   0U, TICKER_NULL_LAZY, TICKS_SLOT, ticker_cb,
+				   (void *)(uintptr_t)id, op_cb, &status);
+		zassert_not_equal(err, TICKER_STATUS_FAILURE,
+				  "cannot start ticker %u", id);
+
+		run_pending();
+		zassert_equal(status, TICKER_STATUS_SUCCESS,
+			      "ticker %u not started", id);
+	}
+}
+
+static uint64_t tickers_run(void)
+{
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	while (cntr_cmp <= N_ROUNDS * TICKS_PERIODIC) {
+		cntr = cntr_cmp;
+		ticker_trigger(INSTANCE_INDEX);
+		run_pending();
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return (end.tv_sec - start.tv_sec) * 1000000000ULL +
+	       end.tv_nsec - start.tv_nsec;
+}
+
+ZTEST(bt_ticker, test_dense_central)
+{
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		uint8_t n = levels[i];
+		uint64_t ns;
+
+		tickers_start(n);
+		ns = tickers_run();
+
+		for (uint8_t id = 0U; id < n; id++) {
+			zassert_equal(expire_cnt[id], N_ROUNDS,
+				      "ticker %u expired %u times", id,
+				      expire_cnt[id]);
+		}
+
+		zassert_false(out_of_order, "tickers expired out of order");
+
+		printk("tickers %3u: %u ns per expiry\n", n,
+		       (uint32_t)(ns / expire_total));
+	}
+}
+
+ZTEST_SUITE(bt_ticker, NULL, NULL, NULL, NULL, NULL);
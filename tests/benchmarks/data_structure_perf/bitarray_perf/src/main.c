@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/bitarray.h>
+
+#define NUM_ALLOCS 32
+
+SYS_BITARRAY_DEFINE_STATIC(ba_1k, 1024);
+SYS_BITARRAY_DEFINE_STATIC(ba_16k, 16384);
+
+/*
+ * Fragment the array by allocating everything and then freeing every
+ * other run of @p run_len bits, leaving only holes smaller than the
+ * region requested in the measurement.
+ */
+static void fragment(sys_bitarray_t *ba, size_t run_len)
+{
+	size_t offset;
+	int ret;
+
+	ret = sys_bitarray_set_region(ba, ba->num_bits, 0);
+	zassert_equal(ret, 0, "sys_bitarray_set_region() failed: %d", ret);
+
+	for (offset = 0; offset + run_len <= ba->num_bits; offset += 2 * run_len) {
+		ret = sys_bitarray_free(ba, run_len, offset);
+		zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+	}
+}
+
+static void measure_alloc(sys_bitarray_t *ba, size_t num_bits)
+{
+	uint32_t start, cycles = 0U;
+	size_t offset;
+	int i, ret;
+
+	for (i = 0; i < NUM_ALLOCS; i++) {
+		fragment(ba, num_bits - 1);
+
+		/* Open a hole big enough for the request at the very end */
+		ret = sys_bitarray_clear_region(ba, num_bits, ba->num_bits - num_bits);
+		zassert_equal(ret, 0, "sys_bitarray_clear_region() failed: %d", ret);
+
+		start = k_cycle_get_32();
+		ret = sys_bitarray_alloc(ba, num_bits, &offset);
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(ret, 0, "sys_bitarray_alloc() failed: %d", ret);
+	}
+
+	TC_PRINT("%u bits, alloc of %zu bits in fragmented array: %u cycles\n",
+		 ba->num_bits, num_bits, cycles / NUM_ALLOCS);
+}
+
+/**
+ * @brief Measure contiguous allocation in a fragmented 1k bits array
+ */
+ZTEST(bitarray_perf, test_bitarray_alloc_1k)
+{
+	measure_alloc(&ba_1k, 2);
+	measure_alloc(&ba_1k, 8);
+	measure_alloc(&ba_1k, 64);
+}
+
+/**
+ * @brief Measure contiguous allocation in a fragmented 16k bits array
+ */
+ZTEST(bitarray_perf, test_bitarray_alloc_16k)
+{
+	measure_alloc(&ba_16k, 2);
+	measure_alloc(&ba_16k, 8);
+	measure_alloc(&ba_16k, 64);
+}
+
+ZTEST_SUITE(bitarray_perf, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/random/rand32.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/socket.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+
+/* This measures how the cost of reassembling a fragmented datagram grows
+ * with its number of fragments, and how it depends on the order in which
+ * they arrive. For each fragment count and order, a UDP datagram is cut
+ * into FRAG_LEN byte fragments that are fed to the loopback interface,
+ * N_RUNS times, and the average cycles from the first fragment until the
+ * datagram comes out of the socket are reported.
+ */
+
+#define N_RUNS 100
+#define N_SETTLE 5
+#define FRAG_LEN 128
+#define MAX_FRAGS CONFIG_NET_IPV4_FRAGMENT_MAX_PKT
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+
+enum order {
+	ORDERED,
+	REVERSE,
+	RANDOM,
+};
+
+static const int levels[] = { 2, 8, MAX_FRAGS };
+
+static struct net_if *iface;
+static struct net_pkt *frags[MAX_FRAGS];
+static uint8_t payload[FRAG_LEN];
+static uint8_t datagram[MAX_FRAGS * FRAG_LEN];
+static uint16_t ip_id;
+
+static struct net_pkt *make_fragment(int n_frags, int index)
+{
+	struct in_addr addr = INADDR_LOOPBACK_INIT;
+	uint16_t offset = index * FRAG_LEN / 8;
+	struct net_ipv4_hdr hdr = {
+		.vhl = 0x45,
+		.len = htons(sizeof(hdr) + FRAG_LEN),
+		.ttl = 64,
+		.proto = IPPROTO_UDP,
+	};
+	struct net_pkt *pkt;
+
+	UNALIGNED_PUT(htons(ip_id), (uint16_t *)&hdr.id);
+
+	if (index < n_frags - 1) {
+		offset |= NET_IPV4_MORE_FRAG_MASK;
+	}
+
+	UNALIGNED_PUT(htons(offset), (uint16_t *)&hdr.offset);
+
+	net_ipv4_addr_copy_raw(hdr.src, (uint8_t *)&addr);
+	net_ipv4_addr_copy_raw(hdr.dst, (uint8_t *)&addr);
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(hdr) + FRAG_LEN,
+					   AF_INET, IPPROTO_UDP, K_MSEC(100));
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (index == 0) {
+		/* The UDP header is at the start of the first fragment */
+		struct net_udp_hdr *udp = (struct net_udp_hdr *)payload;
+
+		udp->src_port = htons(CLIENT_PORT);
+		udp->dst_port = htons(SERVER_PORT);
+		udp->len = htons(n_frags * FRAG_LEN);
+		udp->chksum = 0;
+	} else {
+		memset(payload, index, sizeof(payload));
+	}
+
+	if (net_pkt_write(pkt, &hdr, sizeof(hdr)) ||
+	    net_pkt_write(pkt, payload, sizeof(payload))) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(hdr));
+	net_pkt_cursor_init(pkt);
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static int make_fragments(int n_frags, enum order order)
+{
+	ip_id++;
+
+	for (int i = 0; i < n_frags; i++) {
+		frags[i] = make_fragment(n_frags, i);
+		if (!frags[i]) {
+			while (i-- > 0) {
+				net_pkt_unref(frags[i]);
+			}
+
+			return -ENOMEM;
+		}
+	}
+
+	for (int i = 0; i < n_frags; i++) {
+		struct net_pkt *tmp;
+		int j;
+
+		if (order == REVERSE && i < n_frags / 2) {
+			j = n_frags - 1 - i;
+		} else if (order == RANDOM) {
+			j = i + sys_rand32_get() % (n_frags - i);
+		} else {
+			break;
+		}
+
+		tmp = frags[i];
+		frags[i] = frags[j];
+		frags[j] = tmp;
+	}
+
+	return 0;
+}
+
+static int reassemble(int sock, int n_frags)
+{
+	ssize_t len;
+
+	for (int i = 0; i < n_frags; i++) {
+		if (net_recv_data(iface, frags[i]) < 0) {
+			while (i < n_frags) {
+				net_pkt_unref(frags[i++]);
+			}
+
+			return -EIO;
+		}
+	}
+
+	len = recv(sock, datagram, sizeof(datagram), 0);
+	if (len != n_frags * FRAG_LEN - sizeof(struct net_udp_hdr)) {
+		printk("received %d bytes instead of %d\n", (int)len,
+		       n_frags * FRAG_LEN - (int)sizeof(struct net_udp_hdr));
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int measure(int sock, int n_frags, enum order order, uint32_t *cycles)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_SETTLE + N_RUNS; i++) {
+		uint32_t start;
+
+		if (make_fragments(n_frags, order) < 0) {
+			printk("cannot allocate fragments\n");
+			return -ENOMEM;
+		}
+
+		start = k_cycle_get_32();
+
+		if (reassemble(sock, n_frags) < 0) {
+			printk("reassembly failed\n");
+			return -EIO;
+		}
+
+		if (i >= N_SETTLE) {
+			total += k_cycle_get_32() - start;
+		}
+	}
+
+	*cycles = total / N_RUNS;
+
+	return 0;
+}
+
+int main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct timeval timeout = { .tv_sec = 1 };
+	int sock;
+
+	iface = net_if_get_default();
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 ||
+	    bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+		       sizeof(timeout)) < 0) {
+		printk("cannot set up socket (%d)\n", errno);
+		return 0;
+	}
+
+	printk("IPv4 fragment reassembly benchmark, %d byte fragments\n",
+	       FRAG_LEN);
+
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		uint32_t cycles[RANDOM + 1];
+
+		for (enum order order = ORDERED; order <= RANDOM; order++) {
+			if (measure(sock, levels[i], order, &cycles[order]) < 0) {
+				return 0;
+			}
+		}
+
+		printk("frags %2d: %u ordered, %u reverse, %u random\n", levels[i],
+		       cycles[ORDERED], cycles[REVERSE], cycles[RANDOM]);
+	}
+
+	return 0;
+}
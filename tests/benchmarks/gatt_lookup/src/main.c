@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+
+/* This measures the attribute lookups done when serving ATT requests: by
+ * handle, as for Read and Write Requests, and by type within the range of
+ * a service, as for Read By Type Requests.  N_SERVICES copies of the same
+ * service are registered, and the average cycles per lookup over N_RUNS
+ * rounds is reported.
+ */
+
+#define N_RUNS 100
+#define N_SERVICES 40
+
+#define SVC_UUID BT_UUID_DECLARE_16(0xfff0)
+#define CHRC1_UUID BT_UUID_DECLARE_16(0xfff1)
+#define CHRC2_UUID BT_UUID_DECLARE_16(0xfff2)
+#define CHRC3_UUID BT_UUID_DECLARE_16(0xfff3)
+
+static uint8_t value;
+
+static ssize_t read_value(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+			  void *buf, uint16_t len, uint16_t offset)
+{
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, attr->user_data,
+				 sizeof(value));
+}
+
+static const struct bt_gatt_attr svc_template[] = {
+	BT_GATT_PRIMARY_SERVICE(SVC_UUID),
+	BT_GATT_CHARACTERISTIC(CHRC1_UUID, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, read_value, NULL,
+			       &value),
+	BT_GATT_CHARACTERISTIC(CHRC2_UUID, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, read_value, NULL,
+			       &value),
+	BT_GATT_CHARACTERISTIC(CHRC3_UUID, BT_GATT_CHRC_READ,
+			       BT_GATT_PERM_READ, read_value, NULL,
+			       &value),
+	BT_GATT_CUD("Benchmark", BT_GATT_PERM_READ),
+};
+
+static struct bt_gatt_attr svc_attrs[N_SERVICES][ARRAY_SIZE(svc_template)];
+static struct bt_gatt_service services[N_SERVICES];
+
+static uint8_t found_attr(const struct bt_gatt_attr *attr, uint16_t handle,
+			  void *user_data)
+{
+	const struct bt_gatt_attr **found = user_data;
+
+	*found = attr;
+
+	return BT_GATT_ITER_STOP;
+}
+
+static uint8_t count_attr(const struct bt_gatt_attr *attr, uint16_t handle,
+			  void *user_data)
+{
+	uint16_t *count = user_data;
+
+	(*count)++;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static int register_services(void)
+{
+	for (int i = 0; i < N_SERVICES; i++) {
+		int err;
+
+		memcpy(svc_attrs[i], svc_template, sizeof(svc_template));
+		services[i].attrs = svc_attrs[i];
+		services[i].attr_count = ARRAY_SIZE(svc_template);
+
+		err = bt_gatt_service_register(&services[i]);
+		if (err) {
+			printk("cannot register service %d (%d)\n", i, err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int measure_handle(uint16_t last_handle, uint32_t *cycles)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		for (uint16_t handle = 1; handle <= last_handle; handle++) {
+			const struct bt_gatt_attr *attr = NULL;
+			uint32_t start = k_cycle_get_32();
+
+			bt_gatt_foreach_attr(handle, handle, found_attr, &attr);
+
+			total += k_cycle_get_32() - start;
+
+			if (!attr) {
+				printk("handle 0x%04x not found\n", handle);
+				return -ENOENT;
+			}
+		}
+	}
+
+	*cycles = total / ((uint64_t)N_RUNS * last_handle);
+
+	return 0;
+}
+
+static int measure_type(uint32_t *cycles)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		for (int j = 0; j < N_SERVICES; j++) {
+			const struct bt_gatt_attr *attrs = services[j].attrs;
+			uint16_t count = 0;
+			uint32_t start = k_cycle_get_32();
+
+			bt_gatt_foreach_attr_type(attrs[0].handle,
+						  attrs[ARRAY_SIZE(svc_template) - 1].handle,
+						  CHRC2_UUID, NULL, 0, count_attr,
+						  &count);
+
+			total += k_cycle_get_32() - start;
+
+			if (count != 1) {
+				printk("service %d: %u attributes found\n", j,
+				       count);
+				return -ENOENT;
+			}
+		}
+	}
+
+	*cycles = total / ((uint64_t)N_RUNS * N_SERVICES);
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t handle_cycles, type_cycles;
+	uint16_t last_handle;
+
+	if (register_services() < 0) {
+		return 0;
+	}
+
+	last_handle = svc_attrs[N_SERVICES - 1][ARRAY_SIZE(svc_template) - 1].handle;
+
+	printk("GATT lookup benchmark, %u attributes, index %s\n", last_handle,
+	       IS_ENABLED(CONFIG_BT_GATT_HANDLE_INDEX) ? "enabled" : "disabled");
+
+	if (measure_handle(last_handle, &handle_cycles) < 0 ||
+	    measure_type(&type_cycles) < 0) {
+		return 0;
+	}
+
+	printk("handle lookup: %u cycles, type lookup: %u cycles\n",
+	       handle_cycles, type_cycles);
+
+	return 0;
+}
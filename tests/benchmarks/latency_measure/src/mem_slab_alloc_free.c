@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+#include "utils.h"
+
+#define TEST_COUNT 100
+#define TEST_BLOCK_SIZE 16
+#define TEST_NUM_BLOCKS 4
+
+K_MEM_SLAB_DEFINE_STATIC(bench_slab, TEST_BLOCK_SIZE, TEST_NUM_BLOCKS, 4);
+
+void mem_slab_alloc_free(void)
+{
+	timing_t alloc_start_time = 0U;
+	timing_t alloc_end_time = 0U;
+
+	timing_t free_start_time = 0U;
+	timing_t free_end_time = 0U;
+
+	uint32_t count = 0U;
+	uint32_t sum_alloc = 0U;
+	uint32_t sum_free = 0U;
+	void *block;
+
+	timing_start();
+
+	while (count != TEST_COUNT) {
+		alloc_start_time = timing_counter_get();
+		if (k_mem_slab_alloc(&bench_slab, &block, K_NO_WAIT) != 0) {
+			printk("Failed to alloc memory slab block "
+					"at count %d\n", count);
+			break;
+		}
+		alloc_end_time = timing_counter_get();
+
+		free_start_time = timing_counter_get();
+		k_mem_slab_free(&bench_slab, &block);
+		free_end_time = timing_counter_get();
+
+		sum_alloc += timing_cycles_get(&alloc_start_time,
+				&alloc_end_time);
+		sum_free += timing_cycles_get(&free_start_time,
+				&free_end_time);
+		count++;
+	}
+
+	if (count == 0) {
+		error_count++;
+	} else {
+		PRINT_STATS_AVG("Average time for memory slab alloc", sum_alloc, count);
+		PRINT_STATS_AVG("Average time for memory slab free", sum_free, count);
+	}
+
+	timing_stop();
+}
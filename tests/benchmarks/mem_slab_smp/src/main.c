@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+/* This measures memory slab alloc/free under contention.  For 1 up to
+ * the number of CPUs, that many cooperative threads are started, one
+ * per CPU as they never yield, and wait for each other before all
+ * allocating and freeing a block N_RUNS times from the same slab.  The
+ * average cycles per alloc/free pair over all threads is reported.
+ * No thread holds more than one block, so the slab never runs out.
+ */
+
+#define N_RUNS 10000
+#define MAX_THREADS CONFIG_MP_MAX_NUM_CPUS
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+K_MEM_SLAB_DEFINE_STATIC(bench_slab, 16, MAX_THREADS, 4);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+static uint32_t cycles[MAX_THREADS];
+static atomic_t n_ready;
+static int n_threads;
+static bool failed;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	uint32_t start;
+	void *block;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* Start together once every thread has a CPU */
+	atomic_inc(&n_ready);
+	while (atomic_get(&n_ready) < n_threads) {
+	}
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < N_RUNS; i++) {
+		if (k_mem_slab_alloc(&bench_slab, &block, K_NO_WAIT) != 0) {
+			printk("alloc failed in thread %d, run %d\n", id, i);
+			failed = true;
+			break;
+		}
+
+		k_mem_slab_free(&bench_slab, &block);
+	}
+
+	cycles[id] = k_cycle_get_32() - start;
+}
+
+static uint32_t run(int n)
+{
+	uint64_t total = 0;
+
+	n_threads = n;
+	atomic_clear(&n_ready);
+
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, worker,
+				INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_COOP(1), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+		total += cycles[i];
+	}
+
+	return (uint32_t)(total / ((uint64_t)n * N_RUNS));
+}
+
+void main(void)
+{
+	printk("Memory slab SMP benchmark, %s\n",
+	       IS_ENABLED(CONFIG_MEM_SLAB_LOCKLESS) ? "lockless" : "locked");
+
+	for (int n = 1; n <= MIN(arch_num_cpus(), MAX_THREADS); n++) {
+		uint32_t avg = run(n);
+
+		if (failed) {
+			return;
+		}
+
+		printk("cpus %d: %u cycles per alloc/free\n", n, avg);
+	}
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "mesh/net.h"
+#include "mesh/access.h"
+
+/* This measures how many cycles the access layer takes to hand a message
+ * to the model that has its OpCode, on a node with N_ELEMS elements that
+ * each have N_MODELS models with N_OPS OpCodes.  Every OpCode is sent in
+ * turn to every element, so that models at the end of the element are hit
+ * as often as the ones at the start.
+ */
+
+#define N_RUNS 20
+#define N_ELEMS 8
+#define N_MODELS 8
+#define N_OPS 4
+#define OWN_ADDR 0x0001
+
+static const uint8_t net_key[16] = { 0x01 };
+static const uint8_t dev_key[16] = { 0x02 };
+static const uint8_t dev_uuid[16] = { 0x03 };
+
+static uint32_t handled;
+
+static int handler(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		   struct net_buf_simple *buf)
+{
+	handled++;
+
+	return 0;
+}
+
+#define TEST_OP(k, j) \
+	{ BT_MESH_MODEL_OP_2(0x82, (j) * N_OPS + (k)), BT_MESH_LEN_MIN(0), handler }
+
+#define OPS_DEFINE(j) \
+	static const struct bt_mesh_model_op ops_##j[] = { \
+		LISTIFY(N_OPS, TEST_OP, (,), j), \
+		BT_MESH_MODEL_OP_END, \
+	}
+
+OPS_DEFINE(0);
+OPS_DEFINE(1);
+OPS_DEFINE(2);
+OPS_DEFINE(3);
+OPS_DEFINE(4);
+OPS_DEFINE(5);
+OPS_DEFINE(6);
+OPS_DEFINE(7);
+
+/* BT_MESH_MODEL() uses LISTIFY() itself, so the models are listed with
+ * FOR_EACH() rather than LISTIFY().
+ */
+#define TEST_MODEL(j) BT_MESH_MODEL(0x1000 + (j), ops_##j, NULL, NULL)
+
+#define MODELS_DEFINE(e, ...) \
+	static struct bt_mesh_model models_##e[] = { \
+		__VA_ARGS__ \
+		FOR_EACH(TEST_MODEL, (,), 0, 1, 2, 3, 4, 5, 6, 7), \
+	}
+
+MODELS_DEFINE(0, BT_MESH_MODEL_CFG_SRV,);
+MODELS_DEFINE(1);
+MODELS_DEFINE(2);
+MODELS_DEFINE(3);
+MODELS_DEFINE(4);
+MODELS_DEFINE(5);
+MODELS_DEFINE(6);
+MODELS_DEFINE(7);
+
+#define TEST_ELEM(e, _) BT_MESH_ELEM(0, models_##e, BT_MESH_MODEL_NONE)
+
+static struct bt_mesh_elem elems[] = {
+	LISTIFY(N_ELEMS, TEST_ELEM, (,)),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+static const struct bt_mesh_prov prov = {
+	.uuid = dev_uuid,
+};
+
+static void bind_key(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+		     bool vnd, bool primary, void *user_data)
+{
+	if (mod->id != BT_MESH_MODEL_ID_CFG_SRV) {
+		mod->keys[0] = 0;
+	}
+}
+
+static void recv_round(void)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx = {
+			.net_idx = 0,
+			.app_idx = 0,
+			.addr = 0x0100,
+		},
+	};
+
+	for (int e = 0; e < N_ELEMS; e++) {
+		rx.ctx.recv_dst = OWN_ADDR + e;
+
+		for (int n = 0; n < N_MODELS * N_OPS; n++) {
+			uint8_t data[2] = { 0x82, n };
+			struct net_buf_simple buf;
+
+			net_buf_simple_init_with_data(&buf, data, sizeof(data));
+			bt_mesh_model_recv(&rx, &buf);
+		}
+	}
+}
+
+int main(void)
+{
+	uint64_t total = 0;
+	int err;
+
+	err = bt_mesh_init(&prov, &comp);
+	if (!err) {
+		err = bt_mesh_provision(net_key, 0, 0, 0, OWN_ADDR, dev_key);
+	}
+
+	if (err) {
+		printk("cannot set up mesh (%d)\n", err);
+		return 0;
+	}
+
+	bt_mesh_model_foreach(bind_key, NULL);
+
+	printk("Mesh access dispatch benchmark, %d elements, %d OpCodes each\n",
+	       N_ELEMS, N_MODELS * N_OPS);
+
+	for (int i = 0; i < N_RUNS; i++) {
+		uint32_t start = k_cycle_get_32();
+
+		recv_round();
+		total += k_cycle_get_32() - start;
+	}
+
+	if (handled != N_RUNS * N_ELEMS * N_MODELS * N_OPS) {
+		printk("%u messages handled, expected %u\n", handled,
+		       N_RUNS * N_ELEMS * N_MODELS * N_OPS);
+		return 0;
+	}
+
+	printk("dispatch: %u cycles per message\n",
+	       (uint32_t)(total / (N_RUNS * N_ELEMS * N_MODELS * N_OPS)));
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include "mesh/net.h"
+#include "mesh/subnet.h"
+
+/* This measures how many network PDUs per second the node takes in when
+ * it hears N_NODES other nodes, each message arriving N_COPIES times as
+ * it is relayed with a different TTL.  Each round every node sends one
+ * message, and the copies come after the messages of all the other nodes,
+ * so the Network Message Cache must hold N_NODES messages to catch them.
+ * The PDUs are encrypted before each round, only their reception is
+ * measured.
+ */
+
+#define N_ROUNDS 20
+#define N_NODES 128
+#define N_COPIES 3
+#define NODE_ADDR 0x0100
+#define OWN_ADDR 0x0001
+/* Not a local element, and relaying is disabled */
+#define DST_ADDR 0x7000
+#define PAYLOAD_LEN 8
+
+static const uint8_t net_key[16] = { 0x01 };
+static const uint8_t dev_key[16] = { 0x02 };
+static const uint8_t dev_uuid[16] = { 0x03 };
+
+static struct bt_mesh_model models[] = {
+	BT_MESH_MODEL_CFG_SRV,
+};
+
+static struct bt_mesh_elem elems[] = {
+	BT_MESH_ELEM(0, models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+static const struct bt_mesh_prov prov = {
+	.uuid = dev_uuid,
+};
+
+static struct {
+	uint8_t len;
+	uint8_t data[BT_MESH_NET_MAX_PDU_LEN];
+} pdus[N_COPIES][N_NODES];
+
+static int encode_round(void)
+{
+	uint32_t seq = bt_mesh.seq;
+
+	for (int c = 0; c < N_COPIES; c++) {
+		/* The copies of a message share its SeqNum */
+		bt_mesh.seq = seq;
+
+		for (int n = 0; n < N_NODES; n++) {
+			NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_NET_MAX_PDU_LEN);
+			struct bt_mesh_msg_ctx ctx = {
+				.net_idx = 0,
+				.app_idx = 0,
+				.addr = DST_ADDR,
+				.send_ttl = 5 - c,
+			};
+			struct bt_mesh_net_tx tx = {
+				.sub = bt_mesh_subnet_get(0),
+				.ctx = &ctx,
+				.src = NODE_ADDR + n,
+			};
+			int err;
+
+			net_buf_simple_reserve(&buf, BT_MESH_NET_HDR_LEN);
+			(void)memset(net_buf_simple_add(&buf, PAYLOAD_LEN), n,
+				     PAYLOAD_LEN);
+
+			err = bt_mesh_net_encode(&tx, &buf, false);
+			if (err) {
+				printk("cannot encode PDU (%d)\n", err);
+				return err;
+			}
+
+			pdus[c][n].len = buf.len;
+			memcpy(pdus[c][n].data, buf.data, buf.len);
+		}
+	}
+
+	return 0;
+}
+
+static void recv_round(void)
+{
+	for (int c = 0; c < N_COPIES; c++) {
+		for (int n = 0; n < N_NODES; n++) {
+			struct net_buf_simple buf;
+
+			net_buf_simple_init_with_data(&buf, pdus[c][n].data,
+						      pdus[c][n].len);
+			bt_mesh_net_recv(&buf, 0, BT_MESH_NET_IF_ADV);
+		}
+	}
+}
+
+int main(void)
+{
+	uint64_t total = 0;
+	int err;
+
+	err = bt_mesh_init(&prov, &comp);
+	if (!err) {
+		err = bt_mesh_provision(net_key, 0, 0, 0, OWN_ADDR, dev_key);
+	}
+
+	if (err) {
+		printk("cannot set up mesh (%d)\n", err);
+		return 0;
+	}
+
+	printk("Mesh network cache benchmark, %d nodes, cache size %d\n",
+	       N_NODES, CONFIG_BT_MESH_MSG_CACHE_SIZE);
+
+	for (int i = 0; i < N_ROUNDS; i++) {
+		uint32_t start;
+
+		if (encode_round()) {
+			return 0;
+		}
+
+		start = k_cycle_get_32();
+		recv_round();
+		total += k_cycle_get_32() - start;
+	}
+
+	if (total == 0) {
+		printk("no cycles counted\n");
+		return 0;
+	}
+
+	printk("%u PDUs per second\n",
+	       (uint32_t)((uint64_t)N_ROUNDS * N_NODES * N_COPIES *
+			  sys_clock_hw_cycles_per_sec() / total));
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/random/rand32.h>
+#include <zephyr/net/net_if.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+/* This measures how the cost of a route lookup grows with the number of
+ * routes. Routes to 2001:db8:0:<i>::/64 are added, with a host route in
+ * every tenth of them and a 2001:db8::/32 route covering them all, and
+ * at 10, 100 and 1000 routes N_RUNS lookups are done for addresses in
+ * the /64 prefixes added so far, reporting the average cycles each.
+ */
+
+#define N_RUNS 10000
+#define MAX_ROUTES CONFIG_NET_MAX_ROUTES
+#define N_NEXTHOPS CONFIG_NET_IPV6_MAX_NEIGHBORS
+
+static const int levels[] = { 10, 100, MAX_ROUTES };
+
+static struct net_if *iface;
+static struct in6_addr nexthops[N_NEXTHOPS];
+static int n_routes;
+static int n_prefixes;
+
+static void make_addr(struct in6_addr *addr, uint16_t subnet, uint16_t host)
+{
+	memset(addr, 0, sizeof(*addr));
+
+	addr->s6_addr16[0] = htons(0x2001);
+	addr->s6_addr16[1] = htons(0x0db8);
+	addr->s6_addr16[3] = htons(subnet);
+	addr->s6_addr16[7] = htons(host);
+}
+
+static int add_route(struct in6_addr *addr, uint8_t prefix_len)
+{
+	struct in6_addr *nexthop = &nexthops[n_routes % N_NEXTHOPS];
+
+	if (!net_route_add(iface, addr, prefix_len, nexthop,
+			   NET_IPV6_ND_INFINITE_LIFETIME,
+			   NET_ROUTE_PREFERENCE_MEDIUM)) {
+		printk("cannot add route %d\n", n_routes);
+		return -ENOMEM;
+	}
+
+	n_routes++;
+
+	return 0;
+}
+
+static int add_nexthops(void)
+{
+	struct net_linkaddr lladdr = {
+		.len = 6,
+		.type = NET_LINK_ETHERNET,
+	};
+	uint8_t mac[6] = { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x00 };
+
+	lladdr.addr = mac;
+
+	for (int i = 0; i < N_NEXTHOPS; i++) {
+		make_addr(&nexthops[i], 0xffff, i + 1);
+		mac[5] = i + 1;
+
+		if (!net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, true,
+				      NET_IPV6_NBR_STATE_REACHABLE)) {
+			printk("cannot add neighbor %d\n", i);
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+static int grow(int count)
+{
+	struct in6_addr addr;
+
+	while (n_routes < count) {
+		make_addr(&addr, n_prefixes, 0);
+
+		if (n_prefixes % 10 == 9 && n_routes + 1 < count) {
+			addr.s6_addr16[7] = htons(1);
+
+			if (add_route(&addr, 128) < 0) {
+				return -ENOMEM;
+			}
+
+			addr.s6_addr16[7] = 0;
+		}
+
+		if (add_route(&addr, 64) < 0) {
+			return -ENOMEM;
+		}
+
+		n_prefixes++;
+	}
+
+	return 0;
+}
+
+static int measure(void)
+{
+	struct in6_addr dst;
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		uint32_t start;
+
+		make_addr(&dst, sys_rand32_get() % n_prefixes,
+			  1 + sys_rand32_get() % 2);
+
+		start = k_cycle_get_32();
+
+		if (!net_route_lookup(iface, &dst)) {
+			printk("no route found\n");
+			return -ENOENT;
+		}
+
+		total += k_cycle_get_32() - start;
+	}
+
+	printk("routes %5d: %u cycles per lookup\n", n_routes,
+	       (uint32_t)(total / N_RUNS));
+
+	return 0;
+}
+
+int main(void)
+{
+	struct in6_addr addr;
+
+	iface = net_if_get_default();
+
+	printk("IPv6 route lookup benchmark, %s\n",
+	       IS_ENABLED(CONFIG_NET_ROUTE_TRIE) ? "prefix trie" : "linear scan");
+
+	if (add_nexthops() < 0) {
+		return 0;
+	}
+
+	make_addr(&addr, 0, 0);
+	if (add_route(&addr, 32) < 0) {
+		return 0;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		if (grow(levels[i]) < 0 || measure() < 0) {
+			return 0;
+		}
+	}
+
+	return 0;
+}
@@ -27,15 +27,31 @@
  * It then iterates this many times, reporting timestamp latencies
  * between each numbered step and for the whole cycle, and a running
  * average for all cycles run.
+ *
+ * A second pass fills the run queue: N_DL_THREADS threads of equal
+ * priority, pended on another wait queue, are given staggered
+ * deadlines (in deadline enabled builds), readied together, and run
+ * in turn when the main thread yields.  The average cost of readying
+ * and of switching through them is reported per thread.
  */
 
 #define N_RUNS 1000
 #define N_SETTLE 10
 
+#define N_DL_THREADS 16
+#define N_DL_RUNS 100
+#define DL_STEP 10000
+
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
 
+static K_THREAD_STACK_ARRAY_DEFINE(dl_stacks, N_DL_THREADS, 1024);
+static struct k_thread dl_threads[N_DL_THREADS];
+static _wait_q_t dl_waitq;
+static int dl_order[N_DL_THREADS];
+static int dl_ran;
+
 _wait_q_t waitq;
 
 enum {
@@ -49,7 +65,7 @@ enum {
 
 uint32_t stamps[NUM_STAMP_STATES];
 
-static inline int _stamp(int state)
+static inline uint32_t cycles_now(void)
 {
 	uint32_t t;
 
@@ -63,6 +79,13 @@ static inline int _stamp(int state)
 	t = k_cycle_get_32();
 #endif
 
+	return t;
+}
+
+static inline int _stamp(int state)
+{
+	uint32_t t = cycles_now();
+
 	stamps[state] = t;
 	return t;
 }
@@ -86,6 +109,80 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
+static void dl_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		unsigned int key = irq_lock();
+
+		z_pend_curr_irqlock(key, &dl_waitq, K_FOREVER);
+		dl_order[dl_ran++] = POINTER_TO_INT(arg1);
+	}
+}
+
+static void run_deadline_threads(int prio)
+{
+	uint64_t ready_tot = 0U, switch_tot = 0U;
+
+	z_waitq_init(&dl_waitq);
+
+	for (int i = 0; i < N_DL_THREADS; i++) {
+		k_thread_create(&dl_threads[i], dl_stacks[i],
+				K_THREAD_STACK_SIZEOF(dl_stacks[i]),
+				dl_fn, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	/* Let them start running and pend */
+	k_sleep(K_MSEC(100));
+
+	for (int r = 0; r < N_DL_RUNS; r++) {
+		uint32_t t0, t1, t2;
+
+#ifdef CONFIG_SCHED_DEADLINE
+		/* Later threads get earlier deadlines, so they are
+		 * readied in the reverse of the order they must run in.
+		 */
+		for (int i = 0; i < N_DL_THREADS; i++) {
+			k_thread_deadline_set(&dl_threads[i],
+					      (N_DL_THREADS - i) * DL_STEP);
+		}
+#endif
+		dl_ran = 0;
+
+		t0 = cycles_now();
+		for (int i = 0; i < N_DL_THREADS; i++) {
+			z_ready_thread(z_unpend_first_thread(&dl_waitq));
+		}
+		t1 = cycles_now();
+		k_yield();
+		t2 = cycles_now();
+
+		if (dl_ran != N_DL_THREADS) {
+			printk("only %d of %d threads ran\n", dl_ran, N_DL_THREADS);
+			return;
+		}
+#ifdef CONFIG_SCHED_DEADLINE
+		for (int i = 0; i < N_DL_THREADS; i++) {
+			if (dl_order[i] != N_DL_THREADS - 1 - i) {
+				printk("thread %d ran out of deadline order\n",
+				       dl_order[i]);
+				return;
+			}
+		}
+#endif
+		ready_tot += t1 - t0;
+		switch_tot += t2 - t1;
+	}
+
+	printk("%d equal priority threads: ready %u switch %u per thread\n",
+	       N_DL_THREADS,
+	       (uint32_t)(ready_tot / (N_DL_RUNS * N_DL_THREADS)),
+	       (uint32_t)(switch_tot / (N_DL_RUNS * N_DL_THREADS)));
+}
+
 void main(void)
 {
 	z_waitq_init(&waitq);
@@ -98,6 +195,14 @@ void main(void)
 				     partner_fn, NULL, NULL, NULL,
 				     partner_prio, 0, K_NO_WAIT);
 
+#ifdef CONFIG_SCHED_DEADLINE
+	/* Give the partner a deadline so that the deadline ordered
+	 * path of the run queue (the heap, for SCHED_HYBRID) is the
+	 * one being measured.
+	 */
+	k_thread_deadline_set(th, INT_MAX / 2);
+#endif
+
 	/* Let it start running and pend */
 	k_sleep(K_MSEC(100));
 
@@ -148,5 +253,8 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+	run_deadline_threads(partner_prio);
+
 	printk("fin\n");
 }
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_epoll.h>
+
+/* This measures how the cost of waiting for a socket grows with the number
+ * of sockets waited for, with poll() and with epoll_wait().  UDP sockets
+ * are bound on the loopback interface, and at 1, 16 and 256 sockets a
+ * datagram is sent in turn to each of them and waited for N_RUNS times,
+ * reporting the average cycles per datagram.
+ */
+
+#define N_RUNS 1000
+#define N_SETTLE 10
+#define MAX_SOCKS 256
+#define BASE_PORT 5000
+
+static const int levels[] = { 1, 16, MAX_SOCKS };
+
+static int socks[MAX_SOCKS];
+static struct pollfd pollfds[MAX_SOCKS];
+static int n_socks;
+static int sender;
+static int epfd;
+
+static int open_sock(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(BASE_PORT + n_socks),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct epoll_event event = {
+		.events = EPOLLIN,
+		.data.u32 = n_socks,
+	};
+	int s;
+
+	s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (s < 0 || bind(s, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    epoll_ctl(epfd, EPOLL_CTL_ADD, s, &event) < 0) {
+		printk("cannot set up socket %d (%d)\n", n_socks, errno);
+		return -errno;
+	}
+
+	socks[n_socks] = s;
+	pollfds[n_socks].fd = s;
+	pollfds[n_socks].events = POLLIN;
+	n_socks++;
+
+	return 0;
+}
+
+static int send_to(int idx)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(BASE_PORT + idx),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	char byte = 'x';
+
+	if (sendto(sender, &byte, 1, 0, (struct sockaddr *)&addr,
+		   sizeof(addr)) != 1) {
+		printk("send failed (%d)\n", errno);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int wait_poll(int idx)
+{
+	char byte;
+
+	if (poll(pollfds, n_socks, -1) != 1 ||
+	    !(pollfds[idx].revents & POLLIN)) {
+		printk("poll failed (%d)\n", errno);
+		return -EIO;
+	}
+
+	return recv(socks[idx], &byte, 1, 0) == 1 ? 0 : -EIO;
+}
+
+static int wait_epoll(int idx)
+{
+	struct epoll_event event;
+	char byte;
+
+	if (epoll_wait(epfd, &event, 1, -1) != 1 || event.data.u32 != idx) {
+		printk("epoll_wait failed (%d)\n", errno);
+		return -EIO;
+	}
+
+	return recv(socks[idx], &byte, 1, 0) == 1 ? 0 : -EIO;
+}
+
+static int measure(int (*wait)(int idx), uint32_t *cycles)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_SETTLE + N_RUNS; i++) {
+		int idx = i % n_socks;
+		uint32_t start = k_cycle_get_32();
+
+		if (send_to(idx) < 0 || wait(idx) < 0) {
+			return -EIO;
+		}
+
+		if (i >= N_SETTLE) {
+			total += k_cycle_get_32() - start;
+		}
+	}
+
+	*cycles = total / N_RUNS;
+
+	return 0;
+}
+
+int main(void)
+{
+	uint32_t poll_cycles, epoll_cycles;
+
+	sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	epfd = epoll_create1(0);
+	if (sender < 0 || epfd < 0) {
+		printk("cannot set up sender (%d)\n", errno);
+		return 0;
+	}
+
+	printk("Socket epoll benchmark\n");
+
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		while (n_socks < levels[i]) {
+			if (open_sock() < 0) {
+				return 0;
+			}
+		}
+
+		if (measure(wait_poll, &poll_cycles) < 0 ||
+		    measure(wait_epoll, &epoll_cycles) < 0) {
+			return 0;
+		}
+
+		printk("socks %3d: poll %u cycles, epoll %u cycles\n", n_socks,
+		       poll_cycles, epoll_cycles);
+	}
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+
+/* This measures how the cost of delivering a TCP segment grows with the
+ * number of established connections.  Pairs of connected sockets are
+ * opened over the loopback interface, and at 1, 100 and 1000 pairs a
+ * byte is bounced back and forth N_RUNS times, on each open pair in turn,
+ * reporting the average cycles per round trip.  Each round
+ * trip is two segments through the TCP connection lookup (plus the
+ * ACKs, as the delayed ACK timer is not given time to run).
+ */
+
+#define N_RUNS 1000
+#define N_SETTLE 10
+#define MAX_PAIRS 1000
+#define SERVER_PORT 4242
+
+static const int levels[] = { 1, 100, MAX_PAIRS };
+
+static int clients[MAX_PAIRS];
+static int servers[MAX_PAIRS];
+static int n_pairs;
+
+static int open_pair(int listener, const struct sockaddr_in *addr)
+{
+	int c, s;
+
+	c = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (c < 0) {
+		printk("socket failed (%d)\n", errno);
+		return -errno;
+	}
+
+	if (connect(c, (const struct sockaddr *)addr, sizeof(*addr)) < 0) {
+		printk("connect failed (%d)\n", errno);
+		close(c);
+		return -errno;
+	}
+
+	s = accept(listener, NULL, NULL);
+	if (s < 0) {
+		printk("accept failed (%d)\n", errno);
+		close(c);
+		return -errno;
+	}
+
+	clients[n_pairs] = c;
+	servers[n_pairs] = s;
+	n_pairs++;
+
+	return 0;
+}
+
+static int round_trip(int c, int s)
+{
+	char byte = 'x';
+
+	if (send(c, &byte, 1, 0) != 1 || recv(s, &byte, 1, 0) != 1 ||
+	    send(s, &byte, 1, 0) != 1 || recv(c, &byte, 1, 0) != 1) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int measure(void)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_SETTLE + N_RUNS; i++) {
+		int pair = i % n_pairs;
+		uint32_t start = k_cycle_get_32();
+
+		if (round_trip(clients[pair], servers[pair]) < 0) {
+			printk("round trip failed (%d)\n", errno);
+			return -EIO;
+		}
+
+		if (i >= N_SETTLE) {
+			total += k_cycle_get_32() - start;
+		}
+	}
+
+	printk("conns %5d: %u cycles per round trip\n", n_pairs,
+	       (uint32_t)(total / N_RUNS));
+
+	return 0;
+}
+
+int main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int listener;
+
+	inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0) {
+		printk("cannot set up listener (%d)\n", errno);
+		return 0;
+	}
+
+	printk("TCP connection lookup benchmark, %lu hash buckets\n",
+	       BIT(CONFIG_NET_TCP_CONN_HASH_BITS));
+
+	for (int i = 0; i < ARRAY_SIZE(levels); i++) {
+		while (n_pairs < levels[i]) {
+			if (open_pair(listener, &addr) < 0) {
+				return 0;
+			}
+		}
+
+		if (measure() < 0) {
+			return 0;
+		}
+	}
+
+	return 0;
+}
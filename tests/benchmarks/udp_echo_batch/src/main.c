@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+
+/* This measures how many datagrams per second a UDP echo server handles
+ * when it reads and writes one datagram per socket call, and when it uses
+ * recvmmsg() and sendmmsg() for up to BATCH_MAX datagrams per call.  The
+ * client sends WINDOW datagrams over the loopback interface and then waits
+ * for their echoes, N_ROUNDS times.  Each server has its own port and
+ * thread, which is a user thread when userspace is enabled.
+ */
+
+#define N_ROUNDS 1000
+#define N_SETTLE 10
+#define WINDOW 8
+#define BATCH_MAX 8
+#define DATA_LEN 64
+#define SERVER_PORT 4242
+#define SERVER_STACK_SIZE 2048
+#define RECV_TIMEOUT_MS 1000
+
+static const int batches[] = { 1, BATCH_MAX };
+
+static K_THREAD_STACK_ARRAY_DEFINE(server_stacks, ARRAY_SIZE(batches),
+				   SERVER_STACK_SIZE);
+static struct k_thread server_threads[ARRAY_SIZE(batches)];
+static K_SEM_DEFINE(server_ready, 0, 1);
+
+/* recvmmsg() and sendmmsg() copy the message headers to the kernel with
+ * the thread's resource pool.
+ */
+K_HEAP_DEFINE(server_heap, 2048);
+
+static void echo_single(int sock)
+{
+	uint8_t buf[DATA_LEN];
+
+	while (1) {
+		struct sockaddr addr;
+		socklen_t addrlen = sizeof(addr);
+		int len;
+
+		len = recvfrom(sock, buf, sizeof(buf), 0, &addr, &addrlen);
+		if (len < 0) {
+			continue;
+		}
+
+		(void)sendto(sock, buf, len, 0, &addr, addrlen);
+	}
+}
+
+static void echo_batch(int sock, int batch)
+{
+	uint8_t bufs[BATCH_MAX][DATA_LEN];
+	struct sockaddr addrs[BATCH_MAX];
+	struct iovec iov[BATCH_MAX];
+	struct mmsghdr msgs[BATCH_MAX];
+
+	memset(msgs, 0, sizeof(msgs));
+
+	while (1) {
+		int n;
+
+		for (int i = 0; i < batch; i++) {
+			iov[i].iov_base = bufs[i];
+			iov[i].iov_len = sizeof(bufs[i]);
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		n = recvmmsg(sock, msgs, batch, MSG_WAITFORONE, NULL);
+		if (n < 0) {
+			continue;
+		}
+
+		/* Echo each datagram back to where it came from */
+		for (int i = 0; i < n; i++) {
+			iov[i].iov_len = msgs[i].msg_len;
+		}
+
+		(void)sendmmsg(sock, msgs, n, 0);
+	}
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	int batch = POINTER_TO_INT(p1);
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT + batch),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 ||
+	    bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("cannot set up server (%d)\n", errno);
+		return;
+	}
+
+	k_sem_give(&server_ready);
+
+	if (batch == 1) {
+		echo_single(sock);
+	} else {
+		echo_batch(sock, batch);
+	}
+}
+
+static int start_server(int idx)
+{
+	k_tid_t tid;
+
+	tid = k_thread_create(&server_threads[idx], server_stacks[idx],
+			      K_THREAD_STACK_SIZEOF(server_stacks[idx]), server,
+			      INT_TO_POINTER(batches[idx]), NULL, NULL,
+			      K_PRIO_PREEMPT(8),
+			      IS_ENABLED(CONFIG_USERSPACE) ? K_USER : 0,
+			      K_FOREVER);
+
+	k_thread_heap_assign(tid, &server_heap);
+
+#if defined(CONFIG_USERSPACE)
+	k_object_access_grant(&server_ready, tid);
+#endif
+
+	k_thread_start(tid);
+
+	if (k_sem_take(&server_ready, K_MSEC(RECV_TIMEOUT_MS)) < 0) {
+		printk("server %d did not start\n", batches[idx]);
+		return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+static int measure(int sock, int batch)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT + batch),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	uint8_t buf[DATA_LEN] = { 0 };
+	uint64_t total = 0;
+
+	for (int i = 0; i < N_SETTLE + N_ROUNDS; i++) {
+		uint32_t start = k_cycle_get_32();
+
+		for (int j = 0; j < WINDOW; j++) {
+			if (sendto(sock, buf, sizeof(buf), 0,
+				   (struct sockaddr *)&addr,
+				   sizeof(addr)) != sizeof(buf)) {
+				printk("send failed (%d)\n", errno);
+				return -EIO;
+			}
+		}
+
+		for (int j = 0; j < WINDOW; j++) {
+			if (recv(sock, buf, sizeof(buf), 0) != sizeof(buf)) {
+				printk("recv failed (%d)\n", errno);
+				return -EIO;
+			}
+		}
+
+		if (i >= N_SETTLE) {
+			total += k_cycle_get_32() - start;
+		}
+	}
+
+	if (total == 0) {
+		printk("no cycles counted\n");
+		return -EIO;
+	}
+
+	printk("batch %d: %u datagrams per second\n", batch,
+	       (uint32_t)((uint64_t)N_ROUNDS * WINDOW *
+			  sys_clock_hw_cycles_per_sec() / total));
+
+	return 0;
+}
+
+int main(void)
+{
+	struct timeval tv = {
+		.tv_sec = RECV_TIMEOUT_MS / MSEC_PER_SEC,
+	};
+	int sock;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 ||
+	    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+		printk("cannot set up client (%d)\n", errno);
+		return 0;
+	}
+
+	printk("UDP echo batching benchmark, %s mode server\n",
+	       IS_ENABLED(CONFIG_USERSPACE) ? "user" : "kernel");
+
+	for (int i = 0; i < ARRAY_SIZE(batches); i++) {
+		if (start_server(i) < 0 || measure(sock, batches[i]) < 0) {
+			return 0;
+		}
+	}
+
+	return 0;
+}
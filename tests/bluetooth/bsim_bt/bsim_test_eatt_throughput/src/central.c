@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * GATT throughput test, central side:
+ * The central connects to the peripheral, subscribes to its N_CHRC notified
+ * characteristics and reports the notification throughput, then writes its
+ * N_CHRC other characteristics without response in turn for TEST_TIME_MS.
+ * With EATT, the bearers are connected automatically once the link is
+ * encrypted.
+ */
+
+#include "common.h"
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/sys/byteorder.h>
+
+CREATE_FLAG(flag_is_connected);
+CREATE_FLAG(flag_is_encrypted);
+CREATE_FLAG(flag_mtu_exchanged);
+CREATE_FLAG(flag_discover_complete);
+
+static atomic_t subscribed;
+
+static struct bt_conn *g_conn;
+
+static uint16_t notify_handles[N_CHRC];
+static uint16_t write_handles[N_CHRC];
+static int n_notify;
+static int n_write;
+
+static struct bt_gatt_subscribe_params subscribe_params[N_CHRC];
+static uint32_t notify_seq[N_CHRC];
+static uint32_t notify_bytes;
+static int64_t notify_first;
+static int64_t notify_last;
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+	if (err != 0) {
+		FAIL("Failed to connect to %s (%u)\n", addr, err);
+		return;
+	}
+
+	printk("Connected to %s\n", addr);
+	SET_FLAG(flag_is_connected);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	if (conn != g_conn) {
+		return;
+	}
+
+	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+	printk("Disconnected: %s (reason 0x%02x)\n", addr, reason);
+
+	bt_conn_unref(g_conn);
+
+	g_conn = NULL;
+	UNSET_FLAG(flag_is_connected);
+}
+
+static void security_changed(struct bt_conn *conn, bt_security_t level,
+			     enum bt_security_err security_err)
+{
+	if (security_err == BT_SECURITY_ERR_SUCCESS && level > BT_SECURITY_L1) {
+		SET_FLAG(flag_is_encrypted);
+	}
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+	.security_changed = security_changed,
+};
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+			 struct net_buf_simple *ad)
+{
+	char addr_str[BT_ADDR_LE_STR_LEN];
+	int err;
+
+	if (g_conn != NULL) {
+		return;
+	}
+
+	/* We're only interested in connectable events */
+	if (type != BT_HCI_ADV_IND && type != BT_HCI_ADV_DIRECT_IND) {
+		return;
+	}
+
+	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+	printk("Device found: %s (RSSI %d)\n", addr_str, rssi);
+
+	printk("Stopping scan\n");
+	err = bt_le_scan_stop();
+	if (err != 0) {
+		FAIL("Could not stop scan: %d", err);
+		return;
+	}
+
+	err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN,
+				BT_LE_CONN_PARAM_DEFAULT, &g_conn);
+	if (err != 0) {
+		FAIL("Could not connect to peer: %d", err);
+	}
+}
+
+static void mtu_exchanged(struct bt_conn *conn, uint8_t err,
+			  struct bt_gatt_exchange_params *params)
+{
+	if (err) {
+		FAIL("MTU exchange failed (err %u)\n", err);
+		return;
+	}
+
+	printk("MTU exchanged, ATT MTU %u\n", bt_gatt_get_mtu(conn));
+	SET_FLAG(flag_mtu_exchanged);
+}
+
+static void exchange_mtu(void)
+{
+	static struct bt_gatt_exchange_params exchange_params = {
+		.func = mtu_exchanged,
+	};
+	int err;
+
+	err = bt_gatt_exchange_mtu(g_conn, &exchange_params);
+	if (err) {
+		FAIL("MTU exchange failed (err %d)\n", err);
+	}
+
+	WAIT_FOR_FLAG(flag_mtu_exchanged);
+}
+
+static uint8_t discover_func(struct bt_conn *conn,
+			     const struct bt_gatt_attr *attr,
+			     struct bt_gatt_discover_params *params)
+{
+	const struct bt_gatt_chrc *chrc;
+
+	if (attr == NULL) {
+		SET_FLAG(flag_discover_complete);
+		return BT_GATT_ITER_STOP;
+	}
+
+	chrc = attr->user_data;
+
+	if (!bt_uuid_cmp(chrc->uuid, TEST_NOTIFY_UUID) && n_notify < N_CHRC) {
+		notify_handles[n_notify++] = chrc->value_handle;
+	} else if (!bt_uuid_cmp(chrc->uuid, TEST_WRITE_UUID) &&
+		   n_write < N_CHRC) {
+		write_handles[n_write++] = chrc->value_handle;
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static void gatt_discover(void)
+{
+	static struct bt_gatt_discover_params discover_params;
+	int err;
+
+	printk("Discovering characteristics\n");
+
+	discover_params.uuid = NULL;
+	discover_params.func = discover_func;
+	discover_params.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	discover_params.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
+	discover_params.chan_opt = BT_ATT_CHAN_OPT_NONE;
+
+	err = bt_gatt_discover(g_conn, &discover_params);
+	if (err != 0) {
+		FAIL("Discover failed (err %d)\n", err);
+	}
+
+	WAIT_FOR_FLAG(flag_discover_complete);
+
+	if (n_notify != N_CHRC || n_write != N_CHRC) {
+		FAIL("Found %d notified and %d written chrcs\n", n_notify,
+		     n_write);
+	}
+}
+
+static uint8_t notify_cb(struct bt_conn *conn,
+			 struct bt_gatt_subscribe_params *params,
+			 const void *data, uint16_t length)
+{
+	int idx = params - subscribe_params;
+	uint32_t seq;
+
+	if (!data) {
+		params->value_handle = 0U;
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (length != DATA_LEN) {
+		FAIL("Unexpected notification of %u bytes\n", length);
+		return BT_GATT_ITER_STOP;
+	}
+
+	seq = sys_get_le32(data);
+	if (seq != notify_seq[idx]) {
+		FAIL("Notification %u on chrc %d out of order, expected %u\n",
+		     seq, idx, notify_seq[idx]);
+	}
+
+	notify_seq[idx] = seq + 1;
+
+	if (!notify_bytes) {
+		notify_first = k_uptime_get();
+	}
+
+	notify_bytes += length;
+	notify_last = k_uptime_get();
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static void subscribed_cb(struct bt_conn *conn, uint8_t err,
+			  struct bt_gatt_subscribe_params *params)
+{
+	if (err) {
+		FAIL("Subscription to %x failed (err %u)\n",
+		     params->value_handle, err);
+		return;
+	}
+
+	atomic_inc(&subscribed);
+}
+
+static void gatt_subscribe(void)
+{
+	int err;
+
+	for (int idx = 0; idx < N_CHRC; idx++) {
+		struct bt_gatt_subscribe_params *params = &subscribe_params[idx];
+
+		params->value_handle = notify_handles[idx];
+		/* The CCC follows the value */
+		params->ccc_handle = notify_handles[idx] + 1;
+		params->value = BT_GATT_CCC_NOTIFY;
+		params->notify = notify_cb;
+		params->subscribe = subscribed_cb;
+		params->chan_opt = BT_ATT_CHAN_OPT_NONE;
+
+		err = bt_gatt_subscribe(g_conn, params);
+		if (err != 0) {
+			FAIL("Subscription failed (err %d)\n", err);
+			return;
+		}
+	}
+
+	while (atomic_get(&subscribed) < N_CHRC) {
+		k_sleep(K_MSEC(1));
+	}
+}
+
+static void write_chrcs(void)
+{
+	uint32_t seq[N_CHRC] = { 0 };
+	uint8_t data[DATA_LEN] = { 0 };
+	int64_t end = k_uptime_get() + TEST_TIME_MS;
+	int idx = 0;
+
+	while (k_uptime_get() < end) {
+		int err;
+
+		sys_put_le32(seq[idx], data);
+
+		err = bt_gatt_write_without_response(g_conn, write_handles[idx],
+						     data, sizeof(data), false);
+		if (err == -ENOMEM || err == -ENOBUFS) {
+			k_sleep(K_TICKS(1));
+			continue;
+		} else if (err) {
+			FAIL("Write failed (err %d)\n", err);
+			return;
+		}
+
+		seq[idx]++;
+		idx = (idx + 1) % N_CHRC;
+	}
+
+	for (idx = 0; idx < N_CHRC; idx++) {
+		printk("chrc %d: %u writes\n", idx, seq[idx]);
+	}
+}
+
+static void test_main(void)
+{
+	int err;
+
+	device_sync_init(CENTRAL_ID);
+
+	err = bt_enable(NULL);
+	if (err != 0) {
+		FAIL("Bluetooth enable failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+	if (err != 0) {
+		FAIL("Scanning failed to start (err %d)\n", err);
+		return;
+	}
+
+	printk("Scanning successfully started\n");
+
+	WAIT_FOR_FLAG(flag_is_connected);
+
+	err = bt_conn_set_security(g_conn, BT_SECURITY_L2);
+	if (err) {
+		FAIL("Failed to start encryption procedure\n");
+		return;
+	}
+
+	WAIT_FOR_FLAG(flag_is_encrypted);
+
+	exchange_mtu();
+
+#if defined(CONFIG_BT_EATT)
+	/* Wait for the channels to be connected */
+	while (bt_eatt_count(g_conn) < CONFIG_BT_EATT_MAX) {
+		k_sleep(K_TICKS(1));
+	}
+#endif /* CONFIG_BT_EATT */
+
+	gatt_discover();
+	gatt_subscribe();
+
+	printk("############# Notification test\n");
+	device_sync_send();
+	device_sync_wait();
+	k_sleep(DRAIN_TIME);
+
+	print_rate("notifications", notify_bytes, notify_first, notify_last);
+
+	for (int idx = 0; idx < N_CHRC; idx++) {
+		if (!notify_seq[idx]) {
+			FAIL("No notifications on chrc %d\n", idx);
+		}
+	}
+
+	printk("############# Write test\n");
+	write_chrcs();
+	device_sync_send();
+
+	printk("Waiting for final sync\n");
+	device_sync_wait();
+
+	if (bst_result != Failed) {
+		PASS("Central Passed\n");
+	}
+}
+
+static const struct bst_test_instance test_central[] = {
+	{
+		.test_id = "central",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_main
+	},
+	BSTEST_END_MARKER
+};
+
+struct bst_test_list *test_central_install(struct bst_test_list *tests)
+{
+	return bst_add_tests(tests, test_central);
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "bstests.h"
+
+extern struct bst_test_list *test_peripheral_install(struct bst_test_list *tests);
+extern struct bst_test_list *test_central_install(struct bst_test_list *tests);
+
+bst_test_install_t test_installers[] = {
+	test_peripheral_install,
+	test_central_install,
+	NULL
+};
+
+void main(void)
+{
+	bst_main();
+}
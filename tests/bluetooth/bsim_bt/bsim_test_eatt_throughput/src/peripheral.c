@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * GATT throughput test, peripheral side:
+ * The peripheral acts as a GATT server with N_CHRC characteristics that it
+ * notifies in turn for TEST_TIME_MS, and N_CHRC characteristics that the
+ * central writes without response in turn. Each PDU carries a sequence
+ * number per characteristic, so the receiver checks that the PDUs about
+ * each characteristic arrive in order whatever bearer they went over.
+ */
+
+#include "common.h"
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/sys/byteorder.h>
+
+CREATE_FLAG(flag_is_connected);
+CREATE_FLAG(flag_is_encrypted);
+
+static struct bt_conn *g_conn;
+
+static uint32_t write_seq[N_CHRC];
+static uint32_t write_bytes;
+static int64_t write_first;
+static int64_t write_last;
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+	if (err != 0) {
+		FAIL("Failed to connect to %s (%u)\n", addr, err);
+		return;
+	}
+
+	printk("Connected to %s\n", addr);
+	g_conn = bt_conn_ref(conn);
+	SET_FLAG(flag_is_connected);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	if (conn != g_conn) {
+		return;
+	}
+
+	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+
+	printk("Disconnected: %s (reason 0x%02x)\n", addr, reason);
+
+	bt_conn_unref(g_conn);
+
+	g_conn = NULL;
+	UNSET_FLAG(flag_is_connected);
+}
+
+static void security_changed(struct bt_conn *conn, bt_security_t level,
+			     enum bt_security_err security_err)
+{
+	if (security_err == BT_SECURITY_ERR_SUCCESS && level > BT_SECURITY_L1) {
+		SET_FLAG(flag_is_encrypted);
+	}
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+	.security_changed = security_changed,
+};
+
+static ssize_t write_chrc(struct bt_conn *conn,
+			  const struct bt_gatt_attr *attr, const void *buf,
+			  uint16_t len, uint16_t offset, uint8_t flags)
+{
+	int idx = POINTER_TO_INT(attr->user_data);
+	uint32_t seq;
+
+	if (len != DATA_LEN || offset != 0) {
+		FAIL("Unexpected write of %u bytes at %u\n", len, offset);
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	seq = sys_get_le32(buf);
+	if (seq != write_seq[idx]) {
+		FAIL("Write %u on chrc %d out of order, expected %u\n", seq,
+		     idx, write_seq[idx]);
+	}
+
+	write_seq[idx] = seq + 1;
+
+	if (!write_bytes) {
+		write_first = k_uptime_get();
+	}
+
+	write_bytes += len;
+	write_last = k_uptime_get();
+
+	return len;
+}
+
+#define NOTIFY_CHRC(_idx)						\
+	BT_GATT_CHARACTERISTIC(TEST_NOTIFY_UUID, BT_GATT_CHRC_NOTIFY,	\
+			       BT_GATT_PERM_NONE, NULL, NULL,		\
+			       INT_TO_POINTER(_idx)),			\
+	BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)
+
+#define WRITE_CHRC(_idx)						\
+	BT_GATT_CHARACTERISTIC(TEST_WRITE_UUID,				\
+			       BT_GATT_CHRC_WRITE_WITHOUT_RESP,		\
+			       BT_GATT_PERM_WRITE, NULL, write_chrc,	\
+			       INT_TO_POINTER(_idx))
+
+/* Attributes of each pair of characteristics, the notified value being
+ * the second one
+ */
+#define CHRC_ATTRS 5
+
+BT_GATT_SERVICE_DEFINE(g_svc,
+	BT_GATT_PRIMARY_SERVICE(TEST_SERVICE_UUID),
+	NOTIFY_CHRC(0), WRITE_CHRC(0),
+	NOTIFY_CHRC(1), WRITE_CHRC(1),
+	NOTIFY_CHRC(2), WRITE_CHRC(2),
+	NOTIFY_CHRC(3), WRITE_CHRC(3));
+
+BUILD_ASSERT(ARRAY_SIZE(attr_g_svc) == 1 + N_CHRC * CHRC_ATTRS);
+
+static void notify_chrcs(void)
+{
+	uint32_t seq[N_CHRC] = { 0 };
+	uint8_t data[DATA_LEN] = { 0 };
+	int64_t end = k_uptime_get() + TEST_TIME_MS;
+	int idx = 0;
+
+	while (k_uptime_get() < end) {
+		const struct bt_gatt_attr *attr = &g_svc.attrs[1 + idx * CHRC_ATTRS + 1];
+		int err;
+
+		sys_put_le32(seq[idx], data);
+
+		err = bt_gatt_notify(g_conn, attr, data, sizeof(data));
+		if (err == -ENOMEM) {
+			k_sleep(K_TICKS(1));
+			continue;
+		} else if (err) {
+			FAIL("Notify failed (err %d)\n", err);
+			return;
+		}
+
+		seq[idx]++;
+		idx = (idx + 1) % N_CHRC;
+	}
+
+	for (idx = 0; idx < N_CHRC; idx++) {
+		printk("chrc %d: %u notifications\n", idx, seq[idx]);
+	}
+}
+
+static void test_main(void)
+{
+	int err;
+	const struct bt_data ad[] = {
+		BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR))
+	};
+
+	device_sync_init(PERIPHERAL_ID);
+
+	err = bt_enable(NULL);
+	if (err != 0) {
+		FAIL("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	printk("Bluetooth initialized\n");
+
+	err = bt_le_adv_start(BT_LE_ADV_CONN_NAME, ad, ARRAY_SIZE(ad), NULL, 0);
+	if (err != 0) {
+		FAIL("Advertising failed to start (err %d)\n", err);
+		return;
+	}
+
+	printk("Advertising successfully started\n");
+
+	WAIT_FOR_FLAG(flag_is_connected);
+	WAIT_FOR_FLAG(flag_is_encrypted);
+
+#if defined(CONFIG_BT_EATT)
+	/* Wait for the channels to be connected */
+	while (bt_eatt_count(g_conn) < CONFIG_BT_EATT_MAX) {
+		k_sleep(K_TICKS(1));
+	}
+#endif /* CONFIG_BT_EATT */
+
+	printk("Waiting for the central to subscribe\n");
+	device_sync_wait();
+
+	printk("############# Notification test\n");
+	notify_chrcs();
+	device_sync_send();
+
+	printk("Waiting for the central to write\n");
+	device_sync_wait();
+	k_sleep(DRAIN_TIME);
+
+	print_rate("writes", write_bytes, write_first, write_last);
+
+	for (int idx = 0; idx < N_CHRC; idx++) {
+		if (!write_seq[idx]) {
+			FAIL("No writes on chrc %d\n", idx);
+		}
+	}
+
+	device_sync_send();
+
+	if (bst_result != Failed) {
+		PASS("Peripheral Passed\n");
+	}
+}
+
+static const struct bst_test_instance test_peripheral[] = {
+	{
+		.test_id = "peripheral",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_main
+	},
+	BSTEST_END_MARKER
+};
+
+struct bst_test_list *test_peripheral_install(struct bst_test_list *tests)
+{
+	return bst_add_tests(tests, test_peripheral);
+}
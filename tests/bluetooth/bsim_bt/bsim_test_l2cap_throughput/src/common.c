@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common.h"
+
+extern enum bst_result_t bst_result;
+
+void test_init(void)
+{
+	bst_ticker_set_next_tick_absolute(WAIT_TIME);
+	bst_result = In_progress;
+}
+
+void test_tick(bs_time_t HW_device_time)
+{
+	if (bst_result != Passed) {
+		FAIL("test failed (not passed after %i seconds)\n", WAIT_SECONDS);
+	}
+}
+
+void print_rate(const char *what, uint32_t bytes, int64_t first, int64_t last)
+{
+	if (last <= first) {
+		FAIL("No %s\n", what);
+		return;
+	}
+
+	printk("%s: %u bytes in %lld ms, %u bytes/s\n", what, bytes,
+	       last - first, (uint32_t)((uint64_t)bytes * MSEC_PER_SEC / (last - first)));
+}
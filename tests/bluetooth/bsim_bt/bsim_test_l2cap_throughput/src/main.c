@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "bstests.h"
+#include "common.h"
+
+#define LOG_MODULE_NAME main
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME, LOG_LEVEL_INF);
+
+/* The central sends SDU_NUM SDUs over an L2CAP channel as fast as the
+ * credits allow, each one going as a single L2CAP PDU that is split into
+ * several ACL fragments. The peripheral checks the content of each SDU, so
+ * that fragments sent out of order or with corrupted data are caught.
+ */
+
+#define PSM		0x0080
+#define INIT_CREDITS	10
+#define SDU_NUM		200
+#define SDU_LEN		(CONFIG_BT_L2CAP_TX_MTU - BT_L2CAP_SDU_HDR_SIZE)
+#define SDU_BUFS	2
+
+CREATE_FLAG(is_connected);
+CREATE_FLAG(flag_l2cap_connected);
+
+/* SDU_BUFS are kept in flight, plus one sent but not yet freed */
+NET_BUF_POOL_DEFINE(sdu_tx_pool, SDU_BUFS + 1, BT_L2CAP_SDU_BUF_SIZE(SDU_LEN),
+		    8, NULL);
+
+NET_BUF_POOL_DEFINE(sdu_rx_pool, SDU_BUFS, BT_L2CAP_SDU_BUF_SIZE(SDU_LEN),
+		    8, NULL);
+
+static struct bt_l2cap_le_chan le_chan;
+static uint16_t tx_cnt;
+static uint16_t sent_cnt;
+static uint16_t rx_cnt;
+static int64_t first_time;
+static int64_t last_time;
+
+static uint8_t sdu_byte(uint16_t sdu, size_t i)
+{
+	return (uint8_t)(sdu + i);
+}
+
+static void sdu_send(struct bt_l2cap_chan *chan)
+{
+	struct net_buf *buf;
+	int err;
+
+	buf = net_buf_alloc(&sdu_tx_pool, K_NO_WAIT);
+	if (!buf) {
+		FAIL("No more memory\n");
+		return;
+	}
+
+	net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+	for (size_t i = 0; i < SDU_LEN; i++) {
+		net_buf_add_u8(buf, sdu_byte(tx_cnt, i));
+	}
+
+	err = bt_l2cap_chan_send(chan, buf);
+	if (err < 0) {
+		FAIL("L2CAP error %d\n", err);
+		net_buf_unref(buf);
+		return;
+	}
+
+	tx_cnt++;
+}
+
+static void sent_cb(struct bt_l2cap_chan *chan)
+{
+	sent_cnt++;
+	last_time = k_uptime_get();
+
+	if (tx_cnt < SDU_NUM) {
+		sdu_send(chan);
+	}
+}
+
+static struct net_buf *alloc_buf_cb(struct bt_l2cap_chan *chan)
+{
+	return net_buf_alloc(&sdu_rx_pool, K_NO_WAIT);
+}
+
+static int recv_cb(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+	if (rx_cnt == 0U) {
+		first_time = k_uptime_get();
+	}
+
+	last_time = k_uptime_get();
+
+	ASSERT(buf->len == SDU_LEN, "SDU %u has length %u\n", rx_cnt, buf->len);
+
+	for (size_t i = 0; i < buf->len; i++) {
+		if (buf->data[i] != sdu_byte(rx_cnt, i)) {
+			FAIL("SDU %u differs at byte %zu\n", rx_cnt, i);
+			break;
+		}
+	}
+
+	rx_cnt++;
+
+	return 0;
+}
+
+static void l2cap_chan_connected_cb(struct bt_l2cap_chan *chan)
+{
+	LOG_DBG("%p (tx mtu %d mps %d)", chan, le_chan.tx.mtu, le_chan.tx.mps);
+
+	SET_FLAG(flag_l2cap_connected);
+}
+
+static void l2cap_chan_disconnected_cb(struct bt_l2cap_chan *chan)
+{
+	UNSET_FLAG(flag_l2cap_connected);
+}
+
+static struct bt_l2cap_chan_ops ops = {
+	.connected = l2cap_chan_connected_cb,
+	.disconnected = l2cap_chan_disconnected_cb,
+	.alloc_buf = alloc_buf_cb,
+	.recv = recv_cb,
+	.sent = sent_cb,
+};
+
+static void le_chan_init(void)
+{
+	memset(&le_chan, 0, sizeof(le_chan));
+	le_chan.chan.ops = &ops;
+	le_chan.rx.mtu = SDU_LEN;
+	le_chan.rx.init_credits = INIT_CREDITS;
+	le_chan.tx.init_credits = INIT_CREDITS;
+}
+
+static int server_accept_cb(struct bt_conn *conn, struct bt_l2cap_chan **chan)
+{
+	le_chan_init();
+	*chan = &le_chan.chan;
+
+	return 0;
+}
+
+static struct bt_l2cap_server test_l2cap_server = {
+	.psm = PSM,
+	.accept = server_accept_cb,
+};
+
+static void connected(struct bt_conn *conn, uint8_t conn_err)
+{
+	if (conn_err) {
+		FAIL("Failed to connect (%u)\n", conn_err);
+		return;
+	}
+
+	SET_FLAG(is_connected);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	UNSET_FLAG(is_connected);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+};
+
+static void test_peripheral_main(void)
+{
+	const struct bt_data ad[] = {
+		BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	};
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Can't enable Bluetooth (err %d)\n", err);
+		return;
+	}
+
+	err = bt_l2cap_server_register(&test_l2cap_server);
+	if (err) {
+		FAIL("Failed to register L2CAP server (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_adv_start(BT_LE_ADV_CONN_NAME, ad, ARRAY_SIZE(ad), NULL, 0);
+	if (err) {
+		FAIL("Advertising failed to start (err %d)\n", err);
+		return;
+	}
+
+	WAIT_FOR_FLAG_SET(is_connected);
+
+	while (rx_cnt < SDU_NUM) {
+		k_msleep(100);
+	}
+
+	print_rate("L2CAP received", SDU_NUM * SDU_LEN, first_time, last_time);
+
+	if (bst_result != Failed) {
+		PASS("L2CAP throughput peripheral passed\n");
+	}
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+			 struct net_buf_simple *ad)
+{
+	struct bt_conn *conn;
+	int err;
+
+	err = bt_le_scan_stop();
+	if (err) {
+		FAIL("Stop LE scan failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN,
+				BT_LE_CONN_PARAM_DEFAULT, &conn);
+	if (err) {
+		FAIL("Create conn failed (err %d)\n", err);
+		return;
+	}
+
+	bt_conn_unref(conn);
+}
+
+static void connect_l2cap_channel(struct bt_conn *conn, void *data)
+{
+	int err;
+
+	le_chan_init();
+
+	err = bt_l2cap_chan_connect(conn, &le_chan.chan, PSM);
+	ASSERT(!err, "Error connecting L2CAP channel (err %d)\n", err);
+}
+
+static void test_central_main(void)
+{
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Can't enable Bluetooth (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+	if (err) {
+		FAIL("Scanning failed to start (err %d)\n", err);
+		return;
+	}
+
+	WAIT_FOR_FLAG_SET(is_connected);
+
+	bt_conn_foreach(BT_CONN_TYPE_LE, connect_l2cap_channel, NULL);
+	WAIT_FOR_FLAG_SET(flag_l2cap_connected);
+
+	first_time = k_uptime_get();
+	for (int i = 0; i < SDU_BUFS; i++) {
+		sdu_send(&le_chan.chan);
+	}
+
+	while (sent_cnt < SDU_NUM) {
+		k_msleep(100);
+	}
+
+	print_rate("L2CAP sent", SDU_NUM * SDU_LEN, first_time, last_time);
+
+	if (bst_result != Failed) {
+		PASS("L2CAP throughput central passed\n");
+	}
+}
+
+static const struct bst_test_instance test_def[] = {
+	{
+		.test_id = "peripheral",
+		.test_descr = "Peripheral receiving L2CAP SDUs",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_peripheral_main
+	},
+	{
+		.test_id = "central",
+		.test_descr = "Central sending L2CAP SDUs",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_central_main
+	},
+	BSTEST_END_MARKER
+};
+
+struct bst_test_list *test_main_l2cap_throughput_install(struct bst_test_list *tests)
+{
+	return bst_add_tests(tests, test_def);
+}
+
+bst_test_install_t test_installers[] = {
+	test_main_l2cap_throughput_install,
+	NULL
+};
+
+void main(void)
+{
+	bst_main();
+}
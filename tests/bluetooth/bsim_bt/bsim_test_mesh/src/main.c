@@ -12,6 +12,8 @@ extern struct bst_test_list *test_persistence_install(struct bst_test_list *test
 extern struct bst_test_list *test_rpc_install(struct bst_test_list *tests);
 #elif defined(CONFIG_BT_MESH_GATT_PROXY)
 extern struct bst_test_list *test_adv_install(struct bst_test_list *test);
+#elif defined(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO)
+extern struct bst_test_list *test_adv_install(struct bst_test_list *test);
 #elif defined(CONFIG_BT_CTLR_LOW_LAT)
 extern struct bst_test_list *test_transport_install(struct bst_test_list *tests);
 extern struct bst_test_list *test_friendship_install(struct bst_test_list *tests);
@@ -33,6 +35,8 @@ bst_test_install_t test_installers[] = {
 	test_rpc_install,
 #elif defined(CONFIG_BT_MESH_GATT_PROXY)
 	test_adv_install,
+#elif defined(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO)
+	test_adv_install,
 #elif defined(CONFIG_BT_CTLR_LOW_LAT)
 	test_transport_install,
 	test_friendship_install,
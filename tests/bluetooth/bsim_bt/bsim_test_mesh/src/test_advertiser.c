@@ -6,7 +6,9 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/hci.h>
+#include <zephyr/sys/byteorder.h>
 #include "mesh_test.h"
+#include "argparse.h"
 #include "mesh/adv.h"
 #include "mesh/net.h"
 #include "mesh/mesh.h"
@@ -19,6 +21,24 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME, LOG_LEVEL_INF);
 
 #define WAIT_TIME 60 /*seconds*/
 
+/* Number of local advs queued before the relayed one in the relay priority test */
+#define PRIO_LOCAL_COUNT 8
+#define PRIO_RELAY_ID 0xff
+
+/* Relay chain test: device 0 sends to device RELAY_CHAIN_DEVS - 1 through the
+ * devices in between, which relay while sending segmented messages of their
+ * own. The test script places the devices so that each one only hears its
+ * neighbours.
+ */
+#define RELAY_CHAIN_DEVS 4
+#define RELAY_CHAIN_ADDR_START 0x0001
+#define RELAY_CHAIN_DST_ADDR (RELAY_CHAIN_ADDR_START + RELAY_CHAIN_DEVS - 1)
+#define RELAY_CHAIN_MSG_COUNT 20
+#define RELAY_CHAIN_MSG_PERIOD_MS 300
+#define RELAY_CHAIN_START_MS 2000
+#define RELAY_CHAIN_LOCAL_ADDR 0xc0ff
+#define RELAY_CHAIN_LOCAL_LEN 60
+
 enum bt_mesh_gatt_service {
 	MESH_SERVICE_PROVISIONING,
 	MESH_SERVICE_PROXY,
@@ -53,6 +73,14 @@ static int seq_checker;
 static struct bt_mesh_test_gatt gatt_param;
 static int num_adv_sent;
 static uint8_t previous_checker = 0xff;
+static int prio_local_ended;
+static int prio_rx_count;
+static int prio_relay_pos = -1;
+static uint32_t prio_rx_mask;
+static struct bt_mesh_test_cfg relay_chain_cfg;
+static uint32_t relay_chain_rx_mask;
+static int relay_chain_rx_count;
+static uint32_t relay_chain_latency[RELAY_CHAIN_MSG_COUNT];
 
 static K_SEM_DEFINE(observer_sem, 0, 1);
 
@@ -66,6 +94,13 @@ static void test_rx_init(void)
 	bt_mesh_test_cfg_set(NULL, WAIT_TIME);
 }
 
+static void test_relay_chain_init(void)
+{
+	relay_chain_cfg.addr = RELAY_CHAIN_ADDR_START + get_device_nbr();
+	relay_chain_cfg.dev_key[0] = get_device_nbr() + 1;
+	bt_mesh_test_cfg_set(&relay_chain_cfg, WAIT_TIME);
+}
+
 static void bt_init(void)
 {
 	ASSERT_OK_MSG(bt_enable(NULL), "Bluetooth init failed");
@@ -379,6 +414,77 @@ static void receive_order(int expect_adv)
 	ASSERT_FALSE(err && err != -EALREADY, "stopping scan failed (err %d)", err);
 }
 
+static void prio_local_end_cb(int err, void *cb_data)
+{
+	ASSERT_EQUAL(0, err);
+	prio_local_ended++;
+
+	if (prio_local_ended == PRIO_LOCAL_COUNT) {
+		k_sem_give(&observer_sem);
+	}
+}
+
+static void prio_relay_start_cb(uint16_t duration, int err, void *cb_data)
+{
+	LOG_INF("relay tx start: +%d ms, after %d local advs",
+		k_uptime_delta(&tx_timestamp), prio_local_ended);
+	ASSERT_EQUAL(0, err);
+	/* At most the local adv that was already being sent goes first */
+	ASSERT_TRUE(prio_local_ended <= 1);
+}
+
+static const struct bt_mesh_send_cb prio_local_cb = {
+	.end = prio_local_end_cb,
+};
+
+static const struct bt_mesh_send_cb prio_relay_cb = {
+	.start = prio_relay_start_cb,
+};
+
+static void relay_prio_scan_cb(const bt_addr_le_t *addr, int8_t rssi, uint8_t adv_type,
+			       struct net_buf_simple *buf)
+{
+	uint8_t length;
+	uint8_t id;
+	int bit;
+
+	if (adv_type != BT_GAP_ADV_TYPE_ADV_NONCONN_IND) {
+		return;
+	}
+
+	length = net_buf_simple_pull_u8(buf);
+	ASSERT_EQUAL(buf->len, length);
+	ASSERT_EQUAL(BT_DATA_MESH_MESSAGE, net_buf_simple_pull_u8(buf));
+	id = net_buf_simple_pull_u8(buf);
+
+	if (id == PRIO_RELAY_ID) {
+		bit = PRIO_LOCAL_COUNT;
+	} else if (id < PRIO_LOCAL_COUNT) {
+		bit = id;
+	} else {
+		FAIL("Unexpected adv %u", id);
+		return;
+	}
+
+	/* Only the first transmission of each adv counts */
+	if (prio_rx_mask & BIT(bit)) {
+		return;
+	}
+
+	prio_rx_mask |= BIT(bit);
+	LOG_INF("rx: %u", id);
+
+	if (id == PRIO_RELAY_ID) {
+		prio_relay_pos = prio_rx_count;
+	}
+
+	prio_rx_count++;
+
+	if (prio_rx_count == PRIO_LOCAL_COUNT + 1) {
+		k_sem_give(&observer_sem);
+	}
+}
+
 static void send_adv_buf(struct net_buf *buf, uint8_t curr, uint8_t prev)
 {
 	send_cb.start = send_order_start_cb;
@@ -659,6 +765,182 @@ static void test_tx_random_order(void)
 	PASS();
 }
 
+static void test_tx_relay_prio(void)
+{
+	struct net_buf *buf[PRIO_LOCAL_COUNT];
+	struct net_buf *relay_buf;
+	int err;
+
+	bt_init();
+	adv_init();
+
+	/* Queue a burst of local advs, like the segments of a segmented
+	 * message, and a relayed adv after them. The relayed adv should not
+	 * wait for the burst to be sent.
+	 */
+	allocate_all_array(buf, ARRAY_SIZE(buf), BT_MESH_TRANSMIT(2, 20));
+
+	for (int i = 0; i < ARRAY_SIZE(buf); i++) {
+		net_buf_add_u8(buf[i], i);
+		bt_mesh_adv_send(buf[i], &prio_local_cb, NULL);
+		net_buf_unref(buf[i]);
+	}
+
+	relay_buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, BT_MESH_RELAY_ADV,
+				       BT_MESH_TRANSMIT(2, 20), K_NO_WAIT);
+	ASSERT_FALSE(!relay_buf, "Out of relay buffers");
+
+	net_buf_add_u8(relay_buf, PRIO_RELAY_ID);
+	tx_timestamp = k_uptime_get();
+	bt_mesh_adv_send(relay_buf, &prio_relay_cb, NULL);
+	net_buf_unref(relay_buf);
+
+	err = k_sem_take(&observer_sem, K_SECONDS(10));
+	ASSERT_OK_MSG(err, "Didn't call the last end tx cb.");
+
+	PASS();
+}
+
+static void test_rx_relay_prio(void)
+{
+	struct bt_le_scan_param scan_param = {
+		.type       = BT_HCI_LE_SCAN_PASSIVE,
+		.options    = BT_LE_SCAN_OPT_NONE,
+		.interval   = BT_MESH_ADV_SCAN_UNIT(1000),
+		.window     = BT_MESH_ADV_SCAN_UNIT(1000)
+	};
+	int err;
+
+	bt_init();
+
+	err = bt_le_scan_start(&scan_param, relay_prio_scan_cb);
+	ASSERT_FALSE(err && err != -EALREADY, "starting scan failed (err %d)", err);
+
+	err = k_sem_take(&observer_sem, K_SECONDS(10));
+	ASSERT_OK_MSG(err, "Didn't receive all advs in time");
+
+	err = bt_le_scan_stop();
+	ASSERT_FALSE(err && err != -EALREADY, "stopping scan failed (err %d)", err);
+
+	LOG_INF("relayed adv received in position %d", prio_relay_pos);
+	ASSERT_TRUE(prio_relay_pos >= 0 && prio_relay_pos <= 1);
+
+	PASS();
+}
+
+static void relay_chain_local_end_cb(int err, void *cb_data)
+{
+	k_sem_give(&observer_sem);
+}
+
+static const struct bt_mesh_send_cb relay_chain_local_cb = {
+	.end = relay_chain_local_end_cb,
+};
+
+static void relay_chain_rx_cb(uint8_t *data, size_t len)
+{
+	uint32_t now = k_uptime_get_32();
+	uint8_t idx;
+
+	ASSERT_EQUAL(5, len);
+	idx = data[0];
+
+	if (idx >= RELAY_CHAIN_MSG_COUNT || (relay_chain_rx_mask & BIT(idx))) {
+		FAIL("Unexpected message %u", idx);
+		return;
+	}
+
+	/* The devices share the simulated time, so the uptime of the sender
+	 * can be compared with the one of the receiver.
+	 */
+	relay_chain_latency[idx] = now - sys_get_le32(&data[1]);
+	relay_chain_rx_mask |= BIT(idx);
+	relay_chain_rx_count++;
+
+	if (relay_chain_rx_count == RELAY_CHAIN_MSG_COUNT) {
+		k_sem_give(&observer_sem);
+	}
+}
+
+static void test_relay_chain_src(void)
+{
+	uint8_t data[5];
+
+	bt_mesh_test_setup();
+
+	for (int i = 0; i < RELAY_CHAIN_MSG_COUNT; i++) {
+		k_sleep(K_TIMEOUT_ABS_MS(RELAY_CHAIN_START_MS + i * RELAY_CHAIN_MSG_PERIOD_MS));
+
+		data[0] = i;
+		sys_put_le32(k_uptime_get_32(), &data[1]);
+		ASSERT_OK(bt_mesh_test_send_ra(RELAY_CHAIN_DST_ADDR, data, sizeof(data), NULL,
+					       NULL));
+	}
+
+	PASS();
+}
+
+static void test_relay_chain_relay(void)
+{
+	int64_t end = RELAY_CHAIN_START_MS +
+		      RELAY_CHAIN_MSG_COUNT * RELAY_CHAIN_MSG_PERIOD_MS + 1000;
+	int count = 0;
+
+	bt_mesh_test_setup();
+
+	/* Keep local segmented messages queued, like a node that reports
+	 * a lot of data, while the messages of the chain go through.
+	 */
+	k_sleep(K_TIMEOUT_ABS_MS(RELAY_CHAIN_START_MS - 500));
+
+	while (k_uptime_get() < end) {
+		ASSERT_OK(bt_mesh_test_send_async(RELAY_CHAIN_LOCAL_ADDR, RELAY_CHAIN_LOCAL_LEN,
+						  FORCE_SEGMENTATION, &relay_chain_local_cb, NULL));
+		ASSERT_OK_MSG(k_sem_take(&observer_sem, K_SECONDS(10)),
+			      "Local message not sent");
+		count++;
+	}
+
+	LOG_INF("relay chain: %d local messages sent", count);
+
+	PASS();
+}
+
+static void test_relay_chain_dst(void)
+{
+	uint32_t sum = 0;
+	uint32_t min = UINT32_MAX;
+	uint32_t max = 0;
+	int err;
+
+	bt_mesh_test_setup();
+	bt_mesh_test_ra_cb_setup(relay_chain_rx_cb);
+
+	err = k_sem_take(&observer_sem,
+			 K_TIMEOUT_ABS_MS(RELAY_CHAIN_START_MS +
+					  RELAY_CHAIN_MSG_COUNT * RELAY_CHAIN_MSG_PERIOD_MS +
+					  5000));
+
+	for (int i = 0; i < RELAY_CHAIN_MSG_COUNT; i++) {
+		if (!(relay_chain_rx_mask & BIT(i))) {
+			continue;
+		}
+
+		sum += relay_chain_latency[i];
+		min = MIN(min, relay_chain_latency[i]);
+		max = MAX(max, relay_chain_latency[i]);
+	}
+
+	LOG_INF("relay chain (%s): %d of %d messages, latency min %u avg %u max %u ms",
+		IS_ENABLED(CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO) ? "relay prio" : "no relay prio",
+		relay_chain_rx_count, RELAY_CHAIN_MSG_COUNT, min,
+		sum / MAX(relay_chain_rx_count, 1), max);
+
+	ASSERT_OK_MSG(err, "Not all messages received through the chain");
+
+	PASS();
+}
+
 static void test_rx_receive_order(void)
 {
 	bt_init();
@@ -692,6 +974,15 @@ static void test_rx_random_order(void)
 		.test_main_f = test_##role##_##name,           \
 	}
 
+#define RELAY_CHAIN_CASE(role, description)                     \
+	{                                                      \
+		.test_id = "adv_relay_chain_" #role,           \
+		.test_descr = description,                     \
+		.test_pre_init_f = test_relay_chain_init,      \
+		.test_tick_f = bt_mesh_test_timeout,           \
+		.test_main_f = test_relay_chain_##role,        \
+	}
+
 static const struct bst_test_instance test_adv[] = {
 	TEST_CASE(tx, cb_single,     "ADV: tx cb parameter checker"),
 	TEST_CASE(tx, cb_multi,      "ADV: tx cb sequence checker"),
@@ -699,11 +990,17 @@ static const struct bst_test_instance test_adv[] = {
 	TEST_CASE(tx, send_order,    "ADV: tx send order"),
 	TEST_CASE(tx, reverse_order, "ADV: tx reversed order"),
 	TEST_CASE(tx, random_order,  "ADV: tx random order"),
+	TEST_CASE(tx, relay_prio,    "ADV: tx relayed adv before local burst"),
 
 	TEST_CASE(rx, xmit,          "ADV: xmit checker"),
 	TEST_CASE(rx, proxy_mixin,   "ADV: proxy mix-in scanner"),
 	TEST_CASE(rx, receive_order, "ADV: rx receive order"),
 	TEST_CASE(rx, random_order,  "ADV: rx random order"),
+	TEST_CASE(rx, relay_prio,    "ADV: rx relayed adv before local burst"),
+
+	RELAY_CHAIN_CASE(src,   "ADV: relay chain sender"),
+	RELAY_CHAIN_CASE(relay, "ADV: relay chain relay with local traffic"),
+	RELAY_CHAIN_CASE(dst,   "ADV: relay chain receiver"),
 
 	BSTEST_END_MARKER
 };
@@ -0,0 +1,19 @@
+#!/usr/bin/env bash
+# Copyright 2023 Nordic Semiconductor
+# SPDX-License-Identifier: Apache-2.0
+
+source $(dirname "${BASH_SOURCE[0]}")/../../_mesh_test.sh
+
+# Test scenario:
+# Four nodes in a chain, each one only hearing its neighbours. The first node
+# sends 20 messages to the last one, which get there through the two nodes in
+# between. These relay them while sending segmented messages of their own.
+# The last node checks that all messages arrive and logs their latency.
+# Built without CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO, see relay_chain_prio.sh.
+phy_args="-channel=multiatt -argschannel -at=120 \
+-file=$(cd $(dirname "${BASH_SOURCE[0]}") && pwd)/relay_chain_att.txt"
+RunTest mesh_adv_relay_chain \
+	adv_relay_chain_src \
+	adv_relay_chain_relay \
+	adv_relay_chain_relay \
+	adv_relay_chain_dst
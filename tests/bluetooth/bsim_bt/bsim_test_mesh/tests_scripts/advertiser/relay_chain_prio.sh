@@ -0,0 +1,18 @@
+#!/usr/bin/env bash
+# Copyright 2023 Nordic Semiconductor
+# SPDX-License-Identifier: Apache-2.0
+
+source $(dirname "${BASH_SOURCE[0]}")/../../_mesh_test.sh
+
+# Test scenario:
+# Same as relay_chain.sh, built with CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO, so that
+# the relaying nodes send the relayed messages before their own segments.
+# Compare the latency logged by the last node with the one of relay_chain.sh.
+overlay=overlay_ext_adv_conf
+phy_args="-channel=multiatt -argschannel -at=120 \
+-file=$(cd $(dirname "${BASH_SOURCE[0]}") && pwd)/relay_chain_att.txt"
+RunTest mesh_adv_relay_chain_prio \
+	adv_relay_chain_src \
+	adv_relay_chain_relay \
+	adv_relay_chain_relay \
+	adv_relay_chain_dst
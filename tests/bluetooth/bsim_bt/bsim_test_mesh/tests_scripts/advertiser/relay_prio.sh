@@ -0,0 +1,14 @@
+#!/usr/bin/env bash
+# Copyright 2023 Nordic Semiconductor
+# SPDX-License-Identifier: Apache-2.0
+
+source $(dirname "${BASH_SOURCE[0]}")/../../_mesh_test.sh
+
+# Test scenario:
+# Queue a burst of 8 local advs on the extended advertiser, then one relayed
+# adv. With CONFIG_BT_MESH_ADV_EXT_RELAY_PRIO, the relayed adv is sent right
+# after the local adv that is already being sent, instead of after the
+# whole burst. A scanner checks that all advs are received, and that the
+# relayed adv is among the first two.
+overlay=overlay_ext_adv_conf
+RunTest mesh_adv_relay_prio adv_tx_relay_prio adv_rx_relay_prio
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "bstests.h"
+#include "common.h"
+
+#define LOG_MODULE_NAME main
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME, LOG_LEVEL_INF);
+
+/* A central is connected to N_PERIPHERALS peripherals, which all send it
+ * SDU_NUM SDUs over an L2CAP channel, one every SDU_INTERVAL_MS. Each SDU
+ * carries the uptime of the peripheral when it was sent, and the central
+ * reports per connection how long it took for the SDU to reach the
+ * application. The devices all start at the same simulated time, so their
+ * uptimes can be compared.
+ */
+
+#define N_PERIPHERALS	CONFIG_BT_MAX_CONN
+#define PSM		0x0080
+#define INIT_CREDITS	10
+#define SDU_NUM		50
+#define SDU_LEN		64
+#define SDU_INTERVAL_MS	100
+#define SDU_BUFS	4
+
+CREATE_FLAG(is_connected);
+CREATE_FLAG(flag_l2cap_connected);
+
+NET_BUF_POOL_DEFINE(sdu_tx_pool, SDU_BUFS, BT_L2CAP_SDU_BUF_SIZE(SDU_LEN),
+		    8, NULL);
+
+NET_BUF_POOL_DEFINE(sdu_rx_pool, N_PERIPHERALS, BT_L2CAP_SDU_BUF_SIZE(SDU_LEN),
+		    8, NULL);
+
+static struct bt_l2cap_le_chan le_chans[N_PERIPHERALS];
+static atomic_t conn_cnt;
+static atomic_t chan_cnt;
+static uint16_t sent_cnt;
+
+static struct {
+	uint16_t rx_cnt;
+	uint64_t sum_us;
+	uint32_t max_us;
+} latency[N_PERIPHERALS];
+
+static void sdu_send(struct bt_l2cap_chan *chan, uint16_t sdu)
+{
+	struct net_buf *buf;
+	int err;
+
+	buf = net_buf_alloc(&sdu_tx_pool, K_NO_WAIT);
+	if (!buf) {
+		FAIL("No more memory\n");
+		return;
+	}
+
+	net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+	net_buf_add_le64(buf, k_uptime_ticks());
+	net_buf_add_le16(buf, sdu);
+	while (buf->len < SDU_LEN) {
+		net_buf_add_u8(buf, (uint8_t)sdu);
+	}
+
+	err = bt_l2cap_chan_send(chan, buf);
+	if (err < 0) {
+		FAIL("L2CAP error %d\n", err);
+		net_buf_unref(buf);
+	}
+}
+
+static void sent_cb(struct bt_l2cap_chan *chan)
+{
+	sent_cnt++;
+}
+
+static struct net_buf *alloc_buf_cb(struct bt_l2cap_chan *chan)
+{
+	return net_buf_alloc(&sdu_rx_pool, K_NO_WAIT);
+}
+
+static int recv_cb(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+	uint8_t index = bt_conn_index(chan->conn);
+	int64_t sent_ticks;
+	uint32_t us;
+	uint16_t sdu;
+
+	ASSERT(buf->len == SDU_LEN, "SDU has length %u\n", buf->len);
+
+	sent_ticks = net_buf_pull_le64(buf);
+	sdu = net_buf_pull_le16(buf);
+
+	ASSERT(sdu == latency[index].rx_cnt, "Connection %u: SDU %u, expected %u\n",
+	       index, sdu, latency[index].rx_cnt);
+
+	us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() - sent_ticks);
+
+	latency[index].sum_us += us;
+	latency[index].max_us = MAX(latency[index].max_us, us);
+	latency[index].rx_cnt++;
+
+	return 0;
+}
+
+static void l2cap_chan_connected_cb(struct bt_l2cap_chan *chan)
+{
+	atomic_inc(&chan_cnt);
+	SET_FLAG(flag_l2cap_connected);
+}
+
+static void l2cap_chan_disconnected_cb(struct bt_l2cap_chan *chan)
+{
+	atomic_dec(&chan_cnt);
+	UNSET_FLAG(flag_l2cap_connected);
+}
+
+static struct bt_l2cap_chan_ops ops = {
+	.connected = l2cap_chan_connected_cb,
+	.disconnected = l2cap_chan_disconnected_cb,
+	.alloc_buf = alloc_buf_cb,
+	.recv = recv_cb,
+	.sent = sent_cb,
+};
+
+static struct bt_l2cap_le_chan *le_chan_init(struct bt_conn *conn)
+{
+	struct bt_l2cap_le_chan *le_chan = &le_chans[bt_conn_index(conn)];
+
+	memset(le_chan, 0, sizeof(*le_chan));
+	le_chan->chan.ops = &ops;
+	le_chan->rx.mtu = SDU_LEN;
+	le_chan->rx.init_credits = INIT_CREDITS;
+	le_chan->tx.init_credits = INIT_CREDITS;
+
+	return le_chan;
+}
+
+static int server_accept_cb(struct bt_conn *conn, struct bt_l2cap_chan **chan)
+{
+	*chan = &le_chan_init(conn)->chan;
+
+	return 0;
+}
+
+static struct bt_l2cap_server test_l2cap_server = {
+	.psm = PSM,
+	.accept = server_accept_cb,
+};
+
+static void connected(struct bt_conn *conn, uint8_t conn_err)
+{
+	if (conn_err) {
+		FAIL("Failed to connect (%u)\n", conn_err);
+		return;
+	}
+
+	atomic_inc(&conn_cnt);
+	SET_FLAG(is_connected);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	atomic_dec(&conn_cnt);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+};
+
+static void test_peripheral_main(void)
+{
+	const struct bt_data ad[] = {
+		BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	};
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Can't enable Bluetooth (err %d)\n", err);
+		return;
+	}
+
+	err = bt_l2cap_server_register(&test_l2cap_server);
+	if (err) {
+		FAIL("Failed to register L2CAP server (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_adv_start(BT_LE_ADV_CONN_NAME, ad, ARRAY_SIZE(ad), NULL, 0);
+	if (err) {
+		FAIL("Advertising failed to start (err %d)\n", err);
+		return;
+	}
+
+	WAIT_FOR_FLAG_SET(flag_l2cap_connected);
+
+	/* The only connection of the peripheral has index 0 */
+	for (uint16_t sdu = 0U; sdu < SDU_NUM; sdu++) {
+		sdu_send(&le_chans[0].chan, sdu);
+		k_msleep(SDU_INTERVAL_MS);
+	}
+
+	while (sent_cnt < SDU_NUM) {
+		k_msleep(100);
+	}
+
+	if (bst_result != Failed) {
+		PASS("RX latency peripheral passed\n");
+	}
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+			 struct net_buf_simple *ad)
+{
+	struct bt_conn *conn;
+	int err;
+
+	if (type != BT_GAP_ADV_TYPE_ADV_IND) {
+		return;
+	}
+
+	/* Skip the reports still coming from peripherals already connected */
+	conn = bt_conn_lookup_addr_le(BT_ID_DEFAULT, addr);
+	if (conn) {
+		bt_conn_unref(conn);
+		return;
+	}
+
+	err = bt_le_scan_stop();
+	if (err) {
+		FAIL("Stop LE scan failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN,
+				BT_LE_CONN_PARAM_DEFAULT, &conn);
+	if (err) {
+		FAIL("Create conn failed (err %d)\n", err);
+		return;
+	}
+
+	bt_conn_unref(conn);
+}
+
+static void connect_l2cap_channel(struct bt_conn *conn, void *data)
+{
+	int err;
+
+	err = bt_l2cap_chan_connect(conn, &le_chan_init(conn)->chan, PSM);
+	ASSERT(!err, "Error connecting L2CAP channel (err %d)\n", err);
+}
+
+static bool all_received(void)
+{
+	for (int i = 0; i < N_PERIPHERALS; i++) {
+		if (latency[i].rx_cnt < SDU_NUM) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void test_central_main(void)
+{
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Can't enable Bluetooth (err %d)\n", err);
+		return;
+	}
+
+	while (atomic_get(&conn_cnt) < N_PERIPHERALS) {
+		UNSET_FLAG(is_connected);
+
+		err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+		if (err) {
+			FAIL("Scanning failed to start (err %d)\n", err);
+			return;
+		}
+
+		WAIT_FOR_FLAG_SET(is_connected);
+	}
+
+	bt_conn_foreach(BT_CONN_TYPE_LE, connect_l2cap_channel, NULL);
+
+	while (atomic_get(&chan_cnt) < N_PERIPHERALS) {
+		k_msleep(10);
+	}
+
+	while (!all_received()) {
+		k_msleep(100);
+	}
+
+	for (int i = 0; i < N_PERIPHERALS; i++) {
+		printk("Connection %d: %u SDUs, latency avg %u us, max %u us\n", i,
+		       latency[i].rx_cnt, (uint32_t)(latency[i].sum_us / SDU_NUM),
+		       latency[i].max_us);
+	}
+
+	if (bst_result != Failed) {
+		PASS("RX latency central passed\n");
+	}
+}
+
+static const struct bst_test_instance test_def[] = {
+	{
+		.test_id = "peripheral",
+		.test_descr = "Peripheral sending timestamped L2CAP SDUs",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_peripheral_main
+	},
+	{
+		.test_id = "central",
+		.test_descr = "Central receiving L2CAP SDUs from all peripherals",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_central_main
+	},
+	BSTEST_END_MARKER
+};
+
+struct bst_test_list *test_main_rx_latency_install(struct bst_test_list *tests)
+{
+	return bst_add_tests(tests, test_def);
+}
+
+bst_test_install_t test_installers[] = {
+	test_main_rx_latency_install,
+	NULL
+};
+
+void main(void)
+{
+	bst_main();
+}
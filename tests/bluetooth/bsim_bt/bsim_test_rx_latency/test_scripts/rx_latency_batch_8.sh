@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+# Copyright 2023 Nordic Semiconductor ASA
+# SPDX-License-Identifier: Apache-2.0
+
+# Latency of L2CAP SDUs received by a central from 8 peripherals at once,
+# with up to 8 received packets processed per run of the RX work
+
+simulation_id="rx_latency_batch_8"
+verbosity_level=2
+process_ids=""; exit_code=0
+
+function Execute(){
+  if [ ! -f $1 ]; then
+    echo -e "  \e[91m`pwd`/`basename $1` cannot be found (did you forget to\
+ compile it?)\e[39m"
+    exit 1
+  fi
+  timeout 120 $@ & process_ids="$process_ids $!"
+}
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must be defined}"
+
+#Give a default value to BOARD if it does not have one yet:
+BOARD="${BOARD:-nrf52_bsim}"
+
+cd ${BSIM_OUT_PATH}/bin
+
+Execute ./bs_${BOARD}_tests_bluetooth_bsim_bt_bsim_test_rx_latency_prj_conf_overlay_batch_8_conf \
+  -v=${verbosity_level} -s=${simulation_id} -d=0 -testid=central
+
+for device in $(seq 1 8); do
+  Execute ./bs_${BOARD}_tests_bluetooth_bsim_bt_bsim_test_rx_latency_prj_conf_overlay_batch_8_conf \
+    -v=${verbosity_level} -s=${simulation_id} -d=${device} -testid=peripheral
+done
+
+Execute ./bs_2G4_phy_v1 -v=${verbosity_level} -s=${simulation_id} \
+  -D=9 -sim_length=60e6 $@
+
+for process_id in $process_ids; do
+  wait $process_id || let "exit_code=$?"
+done
+exit $exit_code #the last exit code != 0
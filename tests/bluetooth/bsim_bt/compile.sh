@@ -27,6 +27,9 @@ app=tests/bluetooth/bsim_bt/bsim_test_bond_overwrite_denied compile &
 app=tests/bluetooth/bsim_bt/bsim_test_notify compile &
 app=tests/bluetooth/bsim_bt/bsim_test_notify_multiple compile &
 app=tests/bluetooth/bsim_bt/bsim_test_eatt_notif conf_file=prj.conf compile &
+app=tests/bluetooth/bsim_bt/bsim_test_eatt_throughput conf_file=prj.conf compile &
+app=tests/bluetooth/bsim_bt/bsim_test_eatt_throughput conf_file=prj_att.conf \
+  compile &
 app=tests/bluetooth/bsim_bt/bsim_test_gatt_caching compile &
 app=tests/bluetooth/bsim_bt/bsim_test_eatt conf_file=prj_collision.conf compile &
 app=tests/bluetooth/bsim_bt/bsim_test_eatt conf_file=prj_multiple_conn.conf compile &
@@ -46,6 +49,13 @@ app=tests/bluetooth/bsim_bt/bsim_test_gatt_write compile &
 app=tests/bluetooth/bsim_bt/bsim_test_l2cap compile &
 app=tests/bluetooth/bsim_bt/bsim_test_l2cap_userdata compile &
 app=tests/bluetooth/bsim_bt/bsim_test_l2cap_stress compile &
+app=tests/bluetooth/bsim_bt/bsim_test_l2cap_throughput compile &
+app=tests/bluetooth/bsim_bt/bsim_test_l2cap_throughput conf_file=prj_copy.conf \
+  compile &
+app=tests/bluetooth/bsim_bt/bsim_test_rx_latency \
+  conf_overlay=overlay_batch_1.conf compile &
+app=tests/bluetooth/bsim_bt/bsim_test_rx_latency \
+  conf_overlay=overlay_batch_8.conf compile &
 app=tests/bluetooth/bsim_bt/bsim_test_iso compile &
 app=tests/bluetooth/bsim_bt/bsim_test_iso conf_file=prj_vs_dp.conf \
   compile &
@@ -66,6 +76,7 @@ app=tests/bluetooth/bsim_bt/bsim_test_mesh compile &
 app=tests/bluetooth/bsim_bt/bsim_test_mesh conf_overlay=overlay_low_lat.conf compile &
 app=tests/bluetooth/bsim_bt/bsim_test_mesh conf_overlay=overlay_pst.conf compile &
 app=tests/bluetooth/bsim_bt/bsim_test_mesh conf_overlay=overlay_gatt.conf compile &
+app=tests/bluetooth/bsim_bt/bsim_test_mesh conf_overlay=overlay_ext_adv.conf compile &
 app=tests/bluetooth/bsim_bt/bsim_test_disable compile &
 app=tests/bluetooth/bsim_bt/bsim_test_per_adv compile &
 app=tests/bluetooth/bsim_bt/bsim_test_per_adv conf_file=prj_long_data.conf compile &
@@ -230,6 +230,52 @@ ZTEST(test_gatt, test_gatt_foreach)
 	}
 }
 
+ZTEST(test_gatt, test_gatt_foreach_handle)
+{
+	/* Characteristic declaration UUID in its 128-bit form */
+	static const struct bt_uuid_128 chrc_uuid128 = BT_UUID_INIT_128(
+		BT_UUID_128_ENCODE(0x00002803, 0x0000, 0x1000, 0x8000,
+				   0x00805f9b34fb));
+	const struct bt_gatt_attr *attr;
+	uint16_t num;
+
+	if (!bt_gatt_service_is_registered(&test_svc)) {
+		zassert_false(bt_gatt_service_register(&test_svc),
+			      "Test service registration failed");
+	}
+
+	if (!bt_gatt_service_is_registered(&test1_svc)) {
+		zassert_false(bt_gatt_service_register(&test1_svc),
+			      "Test service1 registration failed");
+	}
+
+	/* Look up each attribute by its handle */
+	for (size_t i = 0; i < ARRAY_SIZE(test1_attrs); i++) {
+		attr = NULL;
+		bt_gatt_foreach_attr(test1_attrs[i].handle,
+				     test1_attrs[i].handle, find_attr, &attr);
+		zassert_equal_ptr(attr, &test1_attrs[i],
+				  "Attribute don't match");
+	}
+
+	zassert_equal_ptr(bt_gatt_attr_next(&test1_attrs[0]), &test1_attrs[1],
+			  "Next attribute don't match");
+
+	/* Find the characteristic of one service only */
+	num = 0;
+	bt_gatt_foreach_attr_type(test1_attrs[0].handle,
+				  test1_attrs[ARRAY_SIZE(test1_attrs) - 1].handle,
+				  BT_UUID_GATT_CHRC, NULL, 0, count_attr, &num);
+	zassert_equal(num, 1, "Number of attributes don't match");
+
+	/* UUIDs of different form match */
+	num = 0;
+	bt_gatt_foreach_attr_type(test_attrs[0].handle, 0xffff,
+				  &chrc_uuid128.uuid, NULL, 0, count_attr,
+				  &num);
+	zassert_equal(num, 2, "Number of attributes don't match");
+}
+
 ZTEST(test_gatt, test_gatt_read)
 {
 	const struct bt_gatt_attr *attr;
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/buf.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/drivers/bluetooth/hci_driver.h>
+
+/* The Controller is simulated by the HCI driver. It holds up to
+ * CTLR_CMD_COUNT commands, completes each one a tick after it was sent and
+ * reports in Num_HCI_Command_Packets how many more commands it can take.
+ * Its events reach the Host from another thread, which lets the Host send
+ * commands in between, so events may be generated before the Host acted on
+ * the previous ones, as over a real transport. The Controller counts the
+ * commands it gets against what it last reported.
+ */
+
+#define CTLR_CMD_COUNT 4
+#define N_CMDS 32
+#define N_SYNC_THREADS 3
+
+#define THREAD_STACK_SIZE 1024
+#define CTLR_PRIO K_PRIO_COOP(6)
+#define EVT_PRIO K_PRIO_COOP(CONFIG_BT_HCI_TX_PRIO + 1)
+#define SYNC_PRIO K_PRIO_PREEMPT(1)
+
+static K_FIFO_DEFINE(cmd_fifo);
+static K_FIFO_DEFINE(evt_fifo);
+static K_FIFO_DEFINE(rx_held);
+static int64_t cmd_sent[CONFIG_BT_BUF_CMD_TX_COUNT];
+
+/* Commands the Controller still takes since its last event */
+static atomic_t ctlr_credits = ATOMIC_INIT(1);
+static atomic_t ctlr_held;
+static atomic_t ctlr_held_max;
+static atomic_t ctlr_overrun;
+
+static K_SEM_DEFINE(burst_sem, 0, 1);
+static uint32_t burst_done;
+static uint32_t burst_failed;
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+};
+
+/* Commands needed for bt_enable, and the one used by the tests */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info) },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands) },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features) },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr) },
+	{ BT_HCI_OP_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status) },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status) },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features) },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states) },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand) },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS,
+	  sizeof(struct bt_hci_evt_cc_status) },
+};
+
+/* Answer a command with a Command Complete, all features and commands
+ * being reported as supported.
+ */
+static struct net_buf *cmd_handle(struct net_buf *cmd, uint8_t ncmd)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+	struct bt_hci_cmd_hdr *chdr;
+	struct bt_hci_evt_hdr *hdr;
+	struct net_buf *evt;
+	uint16_t opcode;
+	uint8_t *rp;
+	uint8_t len = sizeof(struct bt_hci_evt_cc_status);
+	uint8_t status = BT_HCI_ERR_UNKNOWN_CMD;
+
+	chdr = net_buf_pull_mem(cmd, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			len = cmds[i].len;
+			status = BT_HCI_ERR_SUCCESS;
+			break;
+		}
+	}
+
+	/* The command buffer may be reused for the event, the OpCode must be
+	 * read before.
+	 */
+	evt = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+
+	hdr = net_buf_add(evt, sizeof(*hdr));
+	hdr->evt = BT_HCI_EVT_CMD_COMPLETE;
+	hdr->len = sizeof(*cc) + len;
+
+	cc = net_buf_add(evt, sizeof(*cc));
+	cc->ncmd = ncmd;
+	cc->opcode = sys_cpu_to_le16(opcode);
+
+	rp = net_buf_add(evt, len);
+	(void)memset(rp, 0xFF, len);
+	rp[0] = status;
+
+	return evt;
+}
+
+static void ctlr_thread(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		struct net_buf *buf;
+		struct net_buf *evt;
+		uint8_t ncmd;
+
+		buf = net_buf_get(&cmd_fifo, K_FOREVER);
+
+		k_sleep(K_TIMEOUT_ABS_TICKS(cmd_sent[net_buf_id(buf)] + 1));
+
+		ncmd = CTLR_CMD_COUNT - (atomic_dec(&ctlr_held) - 1);
+		atomic_set(&ctlr_credits, ncmd);
+
+		evt = cmd_handle(buf, ncmd);
+		net_buf_unref(buf);
+
+		net_buf_put(&evt_fifo, evt);
+	}
+}
+
+static void evt_thread(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		bt_recv_prio(net_buf_get(&evt_fifo, K_FOREVER));
+
+		/* Let the Host send commands before the next event */
+		k_yield();
+	}
+}
+
+K_THREAD_DEFINE(ctlr_tid, THREAD_STACK_SIZE, ctlr_thread, NULL, NULL, NULL,
+		CTLR_PRIO, 0, 0);
+K_THREAD_DEFINE(evt_tid, THREAD_STACK_SIZE, evt_thread, NULL, NULL, NULL,
+		EVT_PRIO, 0, 0);
+
+static int driver_open(void)
+{
+	return 0;
+}
+
+static int driver_send(struct net_buf *buf)
+{
+	atomic_val_t held;
+
+	if (atomic_dec(&ctlr_credits) <= 0) {
+		atomic_inc(&ctlr_overrun);
+	}
+
+	held = atomic_inc(&ctlr_held) + 1;
+	if (held > atomic_get(&ctlr_held_max)) {
+		atomic_set(&ctlr_held_max, held);
+	}
+
+	cmd_sent[net_buf_id(buf)] = k_uptime_ticks();
+	net_buf_put(&cmd_fifo, buf);
+
+	return 0;
+}
+
+static const struct bt_hci_driver drv = {
+	.name         = "test",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+static void *hci_cmd_credits_setup(void)
+{
+	zassert_ok(bt_hci_driver_register(&drv), "registering the driver failed");
+	zassert_ok(bt_enable(NULL), "bt_enable failed");
+
+	return NULL;
+}
+
+static void hci_cmd_credits_before(void *f)
+{
+	atomic_set(&ctlr_held_max, 0);
+	atomic_set(&ctlr_overrun, 0);
+}
+
+static void hci_cmd_credits_after(void *f)
+{
+	struct net_buf *buf;
+
+	while ((buf = net_buf_get(&rx_held, K_NO_WAIT))) {
+		net_buf_unref(buf);
+	}
+}
+
+ZTEST_SUITE(hci_cmd_credits, NULL, hci_cmd_credits_setup,
+	    hci_cmd_credits_before, hci_cmd_credits_after, NULL);
+
+static void burst_cb(uint16_t opcode, uint8_t status, struct net_buf *rsp,
+		     void *user_data)
+{
+	if (status || rsp->len != sizeof(struct bt_hci_rp_le_rand)) {
+		burst_failed++;
+	}
+
+	if (++burst_done == N_CMDS) {
+		k_sem_give(&burst_sem);
+	}
+}
+
+static void burst_send(void)
+{
+	burst_done = 0U;
+	burst_failed = 0U;
+
+	for (int i = 0; i < N_CMDS; i++) {
+		zassert_ok(bt_hci_cmd_send_cb(BT_HCI_OP_LE_RAND, NULL, burst_cb, NULL),
+			   "sending command %d failed", i);
+	}
+
+	zassert_ok(k_sem_take(&burst_sem, K_SECONDS(10)), "%u of %d commands completed",
+		   burst_done, N_CMDS);
+	zassert_equal(burst_failed, 0, "%u commands failed", burst_failed);
+
+	zassert_equal(atomic_get(&ctlr_overrun), 0,
+		      "%d commands sent over the Num_HCI_Command_Packets",
+		      (int)atomic_get(&ctlr_overrun));
+	zassert_true(atomic_get(&ctlr_held_max) <= MIN(CTLR_CMD_COUNT,
+						       CONFIG_BT_HCI_CMD_CREDITS_MAX),
+		     "%d commands in flight", (int)atomic_get(&ctlr_held_max));
+
+	if (CONFIG_BT_HCI_CMD_CREDITS_MAX > 1) {
+		zassert_true(atomic_get(&ctlr_held_max) > 1, "commands sent one by one");
+	}
+}
+
+ZTEST(hci_cmd_credits, test_burst)
+{
+	burst_send();
+}
+
+/* The events waiting in the RX pool may only be processed once a command
+ * completed, so the Command Complete events must not need an RX buffer.
+ */
+ZTEST(hci_cmd_credits, test_burst_rx_pool_exhausted)
+{
+	struct net_buf *buf;
+
+	while ((buf = bt_buf_get_rx(BT_BUF_EVT, K_NO_WAIT))) {
+		net_buf_put(&rx_held, buf);
+	}
+
+	burst_send();
+}
+
+static K_THREAD_STACK_ARRAY_DEFINE(sync_stacks, N_SYNC_THREADS, THREAD_STACK_SIZE);
+static struct k_thread sync_threads[N_SYNC_THREADS];
+static atomic_t sync_failed;
+
+static void sync_thread(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < N_CMDS / N_SYNC_THREADS; i++) {
+		struct net_buf *rsp;
+		int err;
+
+		err = bt_hci_cmd_send_sync(BT_HCI_OP_LE_RAND, NULL, &rsp);
+		if (err) {
+			atomic_inc(&sync_failed);
+			continue;
+		}
+
+		if (rsp->len != sizeof(struct bt_hci_rp_le_rand) || rsp->data[0]) {
+			atomic_inc(&sync_failed);
+		}
+
+		net_buf_unref(rsp);
+	}
+}
+
+ZTEST(hci_cmd_credits, test_send_sync_concurrent)
+{
+	for (int i = 0; i < N_SYNC_THREADS; i++) {
+		k_thread_create(&sync_threads[i], sync_stacks[i],
+				K_THREAD_STACK_SIZEOF(sync_stacks[i]), sync_thread,
+				NULL, NULL, NULL, SYNC_PRIO, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < N_SYNC_THREADS; i++) {
+		zassert_ok(k_thread_join(&sync_threads[i], K_SECONDS(10)),
+			   "thread %d did not finish", i);
+	}
+
+	zassert_equal(atomic_get(&sync_failed), 0, "%d commands failed",
+		      (int)atomic_get(&sync_failed));
+	zassert_equal(atomic_get(&ctlr_overrun), 0,
+		      "%d commands sent over the Num_HCI_Command_Packets",
+		      (int)atomic_get(&ctlr_overrun));
+}
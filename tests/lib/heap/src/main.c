@@ -45,11 +45,21 @@
  * will increase 16 bytes on 64 bit CPU.
  */
 #ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
-#define SOLO_FREE_HEADER_HEAP_SZ (80)
+#define SOLO_FREE_HEADER_STATS_SZ (16)
 #else
-#define SOLO_FREE_HEADER_HEAP_SZ (64)
+#define SOLO_FREE_HEADER_STATS_SZ (0)
 #endif
 
+/* Likewise for the root of the large chunk tree */
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+#define SOLO_FREE_HEADER_TREE_SZ ROUND_UP(sizeof(struct rbtree), 8)
+#else
+#define SOLO_FREE_HEADER_TREE_SZ (0)
+#endif
+
+#define SOLO_FREE_HEADER_HEAP_SZ \
+	(64 + SOLO_FREE_HEADER_STATS_SZ + SOLO_FREE_HEADER_TREE_SZ)
+
 #define SCRATCH_SZ (sizeof(heapmem) / 2)
 
 /* The test memory.  Make them pointer arrays for robust alignment
@@ -64,6 +74,18 @@ void *scratchmem[SCRATCH_SZ / sizeof(void *)];
  */
 #define ITERATION_COUNT (2 * SMALL_HEAP_SZ)
 
+/* The large_chunk_tree variant runs the stress tests on heaps using
+ * the tree
+ */
+static void test_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
+{
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	sys_heap_init_large_chunk_tree(heap, mem, bytes);
+#else
+	sys_heap_init(heap, mem, bytes);
+#endif
+}
+
 /* Simple dumb hash function of the size and address */
 static size_t fill_token(void *p, size_t sz)
 {
@@ -172,7 +194,7 @@ ZTEST(lib_heap, test_small_heap)
 
 	TC_PRINT("Testing small (%d byte) heap\n", (int) SMALL_HEAP_SZ);
 
-	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+	test_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
 	zassert_true(sys_heap_validate(&heap), "");
 	sys_heap_stress(testalloc, testfree, &heap,
 			SMALL_HEAP_SZ, ITERATION_COUNT,
@@ -201,7 +223,7 @@ ZTEST(lib_heap, test_fragmentation)
 	TC_PRINT("Testing maximally fragmented (%d byte) heap\n",
 		 (int) SMALL_HEAP_SZ);
 
-	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+	test_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
 	zassert_true(sys_heap_validate(&heap), "");
 	sys_heap_stress(testalloc, testfree, &heap,
 			SMALL_HEAP_SZ, ITERATION_COUNT,
@@ -228,7 +250,7 @@ ZTEST(lib_heap, test_big_heap)
 
 	TC_PRINT("Testing big (%d byte) heap\n", (int) BIG_HEAP_SZ);
 
-	sys_heap_init(&heap, heapmem, BIG_HEAP_SZ);
+	test_heap_init(&heap, heapmem, BIG_HEAP_SZ);
 	zassert_true(sys_heap_validate(&heap), "");
 	sys_heap_stress(testalloc, testfree, &heap,
 			BIG_HEAP_SZ, ITERATION_COUNT,
@@ -238,6 +260,138 @@ ZTEST(lib_heap, test_big_heap)
 	log_result(BIG_HEAP_SZ, &result);
 }
 
+/* Mix small allocations with big page aligned ones, as used for frame
+ * buffers, and report how long the aligned allocations take and how
+ * fragmented the heap is afterwards.
+ */
+#define LARGE_ALIGN 4096
+#define LARGE_COUNT 6
+
+/* Size of the biggest block the heap can hand out right now */
+static size_t largest_free_block(struct sys_heap *heap)
+{
+	size_t lo = 0, hi = BIG_HEAP_SZ;
+
+	while (lo + 1 < hi) {
+		size_t mid = (lo + hi) / 2;
+		void *p = sys_heap_alloc(heap, mid);
+
+		if (p != NULL) {
+			sys_heap_free(heap, p);
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* Allocates LARGE_COUNT aligned blocks with small ones in between, then
+ * frees and allocates every other large block again. Returns the share
+ * of the free bytes, in percent, that is not in the largest free block.
+ */
+static uint32_t large_aligned_run(struct sys_heap *heap, size_t large_sz,
+				  bool reuse_holes)
+{
+	void *large[LARGE_COUNT], *small[LARGE_COUNT], *freed[LARGE_COUNT];
+	struct sys_memory_stats stats;
+	uint32_t start, cycles = 0U, frag;
+	size_t largest;
+	int count = 0;
+
+	/* Interleave small blocks so large frees leave holes */
+	for (int i = 0; i < LARGE_COUNT; i++) {
+		start = k_cycle_get_32();
+		large[i] = sys_heap_aligned_alloc(heap, LARGE_ALIGN, large_sz);
+		cycles += k_cycle_get_32() - start;
+		zassert_not_null(large[i], "large allocation %d failed", i);
+		zassert_true(((uintptr_t)large[i] & (LARGE_ALIGN - 1)) == 0,
+			     "large block %d not aligned", i);
+		small[i] = sys_heap_alloc(heap, 24 + 8 * i);
+		zassert_not_null(small[i], "small allocation %d failed", i);
+		count++;
+	}
+	zassert_true(sys_heap_validate(heap), "");
+
+	for (int i = 0; i < LARGE_COUNT; i += 2) {
+		freed[i] = large[i];
+		sys_heap_free(heap, large[i]);
+	}
+	for (int i = 0; i < LARGE_COUNT; i += 2) {
+		start = k_cycle_get_32();
+		large[i] = sys_heap_aligned_alloc(heap, LARGE_ALIGN, large_sz);
+		cycles += k_cycle_get_32() - start;
+		zassert_not_null(large[i], "large reallocation %d failed", i);
+		zassert_true(((uintptr_t)large[i] & (LARGE_ALIGN - 1)) == 0,
+			     "large block %d not aligned", i);
+		count++;
+	}
+	zassert_true(sys_heap_validate(heap), "");
+
+	/* With the large chunk tree every reallocated block must sit in
+	 * one of the holes, so no padding was needed for its alignment.
+	 */
+	for (int i = 0; reuse_holes && i < LARGE_COUNT; i += 2) {
+		bool found = false;
+
+		for (int j = 0; j < LARGE_COUNT; j += 2) {
+			found = found || (large[i] == freed[j]);
+		}
+		zassert_true(found, "large block %d not put back in a hole", i);
+	}
+
+	largest = largest_free_block(heap);
+	sys_heap_runtime_stats_get(heap, &stats);
+	frag = 100U - (uint32_t)((100ULL * largest) / stats.free_bytes);
+
+	TC_PRINT("%d aligned allocs of %zu bytes: %u cycles on average\n",
+		 count, large_sz, cycles / count);
+	TC_PRINT("largest free block %zu of %zu free bytes, %u%% fragmented\n",
+		 largest, stats.free_bytes, frag);
+
+	for (int i = 0; i < LARGE_COUNT; i++) {
+		sys_heap_free(heap, large[i]);
+		sys_heap_free(heap, small[i]);
+	}
+	zassert_true(sys_heap_validate(heap), "");
+
+	return frag;
+}
+
+ZTEST(lib_heap, test_large_aligned_alloc)
+{
+	struct sys_heap heap;
+	uint32_t frag;
+	/* Whole pages less the chunk header, so blocks can sit back to
+	 * back and a freed one leaves a hole without any slack.
+	 */
+	size_t large_sz = ROUND_DOWN(BIG_HEAP_SZ / (2 * LARGE_COUNT),
+				     LARGE_ALIGN) - 8;
+
+	if (BIG_HEAP_SZ / (2 * LARGE_COUNT) < 2 * LARGE_ALIGN) {
+		TC_PRINT("heap too small for large allocations\n");
+		ztest_test_skip();
+	}
+
+	TC_PRINT("Testing large aligned allocations, bucket lists only\n");
+	sys_heap_init(&heap, heapmem, BIG_HEAP_SZ);
+	large_aligned_run(&heap, large_sz, false);
+
+#ifdef CONFIG_SYS_HEAP_LARGE_CHUNK_TREE
+	TC_PRINT("Testing large aligned allocations, large chunk tree\n");
+	sys_heap_init_large_chunk_tree(&heap, heapmem, BIG_HEAP_SZ);
+	frag = large_aligned_run(&heap, large_sz, true);
+
+	/* The holes were filled again, what is left over is the end of
+	 * the heap and the small padding in front of the first blocks.
+	 */
+	zassert_true(frag <= 5U, "large chunk tree heap %u%% fragmented", frag);
+#else
+	ARG_UNUSED(frag);
+#endif
+}
+
 /* Test a heap with a solo free header.  A solo free header can exist
  * only on a heap with 64 bit CPU (or chunk_header_bytes() == 8).
  * With 64 bytes heap and 1 byte allocation on a big heap, we get:
@@ -268,6 +422,27 @@ ZTEST(lib_heap, test_solo_free_header)
 	}
 }
 
+/* Z_HEAP_MIN_SIZE, which k_heap definitions are padded to, must be
+ * enough for a 1-byte allocation with the struct z_heap of this build.
+ */
+ZTEST(lib_heap, test_min_size)
+{
+	struct sys_heap heap;
+	void *p;
+
+	TC_PRINT("Testing minimal (%d byte) heap\n", (int)Z_HEAP_MIN_SIZE);
+
+	test_heap_init(&heap, heapmem, Z_HEAP_MIN_SIZE);
+	zassert_true(sys_heap_validate(&heap), "");
+
+	p = sys_heap_alloc(&heap, 1);
+	zassert_not_null(p, "1-byte allocation failed");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_free(&heap, p);
+	zassert_true(sys_heap_validate(&heap), "");
+}
+
 /* Simple clobber detection */
 void realloc_fill_block(uint8_t *p, size_t sz)
 {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/heap_profiler.h>
+
+#define NUM_BLOCKS 4
+
+K_HEAP_DEFINE(test_k_heap, 1024);
+
+static struct sys_heap test_sys_heap;
+static uint8_t __aligned(8) test_sys_heap_mem[1024];
+
+struct site_totals {
+	size_t live_bytes;
+	uint32_t allocs;
+	uint32_t frees;
+	int count;
+};
+
+static void sum_site(const struct heap_profiler_site *site, void *user_data)
+{
+	struct site_totals *totals = user_data;
+
+	totals->live_bytes += site->live_bytes;
+	totals->allocs += site->allocs;
+	totals->frees += site->frees;
+	totals->count++;
+}
+
+static struct site_totals get_totals(void)
+{
+	struct site_totals totals = {};
+
+	heap_profiler_foreach_site(sum_site, &totals);
+
+	return totals;
+}
+
+static void *find_site_ret;
+
+static void find_site(const struct heap_profiler_site *site, void *user_data)
+{
+	/* The site of interest is the only one with live bytes */
+	if (site->live_bytes != 0U) {
+		zassert_is_null(find_site_ret, "more than one live site");
+		find_site_ret = site->site;
+	}
+}
+
+/* Each allocating function must be a distinct call site. The barrier
+ * keeps the allocation from becoming a tail call, which would leave the
+ * return address in the caller.
+ */
+static __attribute__((noinline)) void *alloc_a(void)
+{
+	void *mem = k_malloc(16);
+
+	compiler_barrier();
+
+	return mem;
+}
+
+static __attribute__((noinline)) void *alloc_b(void)
+{
+	void *mem = k_heap_alloc(&test_k_heap, 32, K_NO_WAIT);
+
+	compiler_barrier();
+
+	return mem;
+}
+
+static __attribute__((noinline)) void *alloc_c(void)
+{
+	void *mem = sys_heap_alloc(&test_sys_heap, 48);
+
+	compiler_barrier();
+
+	return mem;
+}
+
+static void check_attribution(void *(*alloc_fn)(void), void (*free_fn)(void *),
+			      const char *name)
+{
+	struct site_totals before = get_totals(), after;
+	void *blocks[NUM_BLOCKS];
+	uintptr_t site;
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		blocks[i] = alloc_fn();
+		zassert_not_null(blocks[i], "%s allocation failed", name);
+	}
+
+	/* All blocks are attributed to a single new site in alloc_fn() */
+	after = get_totals();
+	zassert_equal(after.count, before.count + 1, "%s: wrong site count", name);
+	zassert_equal(after.allocs, before.allocs + NUM_BLOCKS,
+		      "%s: wrong alloc count", name);
+
+	find_site_ret = NULL;
+	heap_profiler_foreach_site(find_site, NULL);
+	site = (uintptr_t)find_site_ret;
+	zassert_true(site > (uintptr_t)alloc_fn && site < (uintptr_t)alloc_fn + 64,
+		     "%s: site %p not within the caller", name, find_site_ret);
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		free_fn(blocks[i]);
+	}
+
+	after = get_totals();
+	zassert_equal(after.live_bytes, 0, "%s: live bytes left", name);
+	zassert_equal(after.frees, before.frees + NUM_BLOCKS,
+		      "%s: wrong free count", name);
+}
+
+static void free_a(void *mem)
+{
+	k_free(mem);
+}
+
+static void free_b(void *mem)
+{
+	k_heap_free(&test_k_heap, mem);
+}
+
+static void free_c(void *mem)
+{
+	sys_heap_free(&test_sys_heap, mem);
+}
+
+/**
+ * @brief Allocations are attributed to the caller of the outermost API
+ */
+ZTEST(heap_profiler, test_attribution)
+{
+	sys_heap_init(&test_sys_heap, test_sys_heap_mem, sizeof(test_sys_heap_mem));
+
+	check_attribution(alloc_a, free_a, "k_malloc");
+	check_attribution(alloc_b, free_b, "k_heap_alloc");
+	check_attribution(alloc_c, free_c, "sys_heap_alloc");
+}
+
+/**
+ * @brief A reallocation moves the block to the reallocating call site
+ */
+ZTEST(heap_profiler, test_realloc)
+{
+	struct site_totals before = get_totals(), after;
+	void *mem, *pad;
+	uintptr_t site;
+
+	sys_heap_init(&test_sys_heap, test_sys_heap_mem, sizeof(test_sys_heap_mem));
+
+	/* The padding block keeps the reallocation from growing in place */
+	mem = alloc_c();
+	pad = sys_heap_alloc(&test_sys_heap, 8);
+	zassert_true(mem != NULL && pad != NULL, "allocation failed");
+	mem = sys_heap_realloc(&test_sys_heap, mem, 256);
+	zassert_not_null(mem, "reallocation failed");
+	sys_heap_free(&test_sys_heap, pad);
+
+	find_site_ret = NULL;
+	heap_profiler_foreach_site(find_site, NULL);
+	site = (uintptr_t)find_site_ret;
+	zassert_true(site < (uintptr_t)alloc_c || site >= (uintptr_t)alloc_c + 64,
+		     "block still attributed to alloc_c()");
+
+	after = get_totals();
+	zassert_true(after.live_bytes >= 256, "live bytes too low");
+	zassert_equal(after.allocs, before.allocs + 3, "wrong alloc count");
+	zassert_equal(after.frees, before.frees + 2, "wrong free count");
+
+	sys_heap_free(&test_sys_heap, mem);
+	after = get_totals();
+	zassert_equal(after.live_bytes, 0, "live bytes left");
+}
+
+static struct heap_profiler_site site_copy;
+
+static void copy_site(const struct heap_profiler_site *site, void *user_data)
+{
+	if (site->site == user_data) {
+		site_copy = *site;
+	}
+}
+
+/**
+ * @brief Peak bytes track the maximum live bytes until reset
+ */
+ZTEST(heap_profiler, test_peak)
+{
+	void *blocks[NUM_BLOCKS];
+	void *site;
+	size_t peak;
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		blocks[i] = alloc_a();
+		zassert_not_null(blocks[i], "allocation failed");
+	}
+
+	find_site_ret = NULL;
+	heap_profiler_foreach_site(find_site, NULL);
+	site = find_site_ret;
+	zassert_not_null(site, "no live site");
+
+	heap_profiler_foreach_site(copy_site, site);
+	peak = site_copy.peak_bytes;
+	zassert_true(peak >= NUM_BLOCKS * 16, "peak too low: %zu", peak);
+	zassert_equal(peak, site_copy.live_bytes, "peak differs from live bytes");
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		k_free(blocks[i]);
+	}
+
+	heap_profiler_foreach_site(copy_site, site);
+	zassert_equal(site_copy.live_bytes, 0, "live bytes left");
+	zassert_equal(site_copy.peak_bytes, peak, "peak not kept");
+
+	heap_profiler_reset_peak();
+
+	heap_profiler_foreach_site(copy_site, site);
+	zassert_equal(site_copy.peak_bytes, 0, "peak not reset");
+	zassert_equal(heap_profiler_dropped_get(), 0, "allocations dropped");
+}
+
+ZTEST_SUITE(heap_profiler, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/socket.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+/* Packets go through the batched paths in both directions: the test
+ * passes received datagrams to net_recv_data_batch() and reads them from
+ * a socket, and sends datagrams in a TX batch and with sendmmsg() to a
+ * driver implementing send_batch. Each datagram carries its sequence number, which must come
+ * out in order, and the packet pools must be full again at the end.
+ */
+
+#define N_PKTS (2 * CONFIG_NET_BATCH_SIZE + 3)
+#define MY_PORT 4242
+#define PEER_PORT 4243
+#define WAIT_TIME K_SECONDS(1)
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static struct net_if *iface;
+static uint8_t mac_addr[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+static K_SEM_DEFINE(tx_done, 0, 1);
+static uint32_t tx_seq[N_PKTS];
+static size_t tx_count;
+static size_t tx_calls;
+static size_t tx_batch_max;
+
+static int batch_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void batch_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+/* Record the sequence number of a sent datagram */
+static int tx_record(struct net_pkt *pkt)
+{
+	uint32_t seq;
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, NET_IPV4H_LEN + NET_UDPH_LEN) ||
+	    net_pkt_read_be32(pkt, &seq)) {
+		return -EINVAL;
+	}
+
+	if (tx_count < N_PKTS) {
+		tx_seq[tx_count] = seq;
+	}
+
+	if (++tx_count == N_PKTS) {
+		k_sem_give(&tx_done);
+	}
+
+	return 0;
+}
+
+static int batch_send(const struct device *dev, struct net_pkt *pkt)
+{
+	tx_calls++;
+	tx_batch_max = MAX(tx_batch_max, 1);
+
+	return tx_record(pkt);
+}
+
+static int batch_send_batch(const struct device *dev, struct net_pkt **pkts,
+			    size_t count)
+{
+	tx_calls++;
+	tx_batch_max = MAX(tx_batch_max, count);
+
+	for (size_t i = 0; i < count; i++) {
+		if (tx_record(pkts[i])) {
+			return i > 0 ? i : -EINVAL;
+		}
+	}
+
+	return count;
+}
+
+static struct dummy_api batch_if_api = {
+	.iface_api.init = batch_iface_init,
+	.send = batch_send,
+	.send_batch = batch_send_batch,
+};
+
+NET_DEVICE_INIT(net_batch_test, "net_batch_test", batch_dev_init, NULL,
+		NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &batch_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static struct net_pkt *rx_pkt_create(uint32_t seq)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(seq), AF_INET,
+					   IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet %u", seq);
+
+	zassert_ok(net_ipv4_create(pkt, &peer_addr, &my_addr), "");
+	zassert_ok(net_udp_create(pkt, htons(PEER_PORT), htons(MY_PORT)), "");
+	zassert_ok(net_pkt_write_be32(pkt, seq), "");
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	return pkt;
+}
+
+static int socket_create(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(MY_PORT),
+		.sin_addr = my_addr,
+	};
+	struct timeval timeout = {
+		.tv_sec = 1,
+	};
+	int sock;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(sock >= 0, "socket failed (%d)", errno);
+
+	zassert_ok(bind(sock, (struct sockaddr *)&addr, sizeof(addr)),
+		   "bind failed (%d)", errno);
+	zassert_ok(setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+			      sizeof(timeout)), "");
+
+	return sock;
+}
+
+/* Wait for the stack to free the packets still on their way */
+static void wait_pool_free(struct k_mem_slab *slab, uint32_t free)
+{
+	for (int i = 0; i < 100; i++) {
+		if (k_mem_slab_num_free_get(slab) == free) {
+			return;
+		}
+
+		k_msleep(10);
+	}
+
+	zassert_equal(k_mem_slab_num_free_get(slab), free,
+		      "%u packets not freed", free - k_mem_slab_num_free_get(slab));
+}
+
+static void tx_reset(void)
+{
+	tx_count = 0;
+	tx_calls = 0;
+	tx_batch_max = 0;
+	k_sem_reset(&tx_done);
+}
+
+static void *batch_setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "no dummy interface");
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0),
+			 "cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_batch, NULL, batch_setup, NULL, NULL, NULL);
+
+ZTEST(net_batch, test_rx_order)
+{
+	struct net_pkt *pkts[N_PKTS + 1];
+	struct k_mem_slab *rx, *tx;
+	struct net_buf_pool *rx_data, *tx_data;
+	uint32_t rx_free;
+	uint32_t seq;
+	size_t n = 0;
+	int sock;
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	rx_free = k_mem_slab_num_free_get(rx);
+
+	sock = socket_create();
+
+	/* NULL entries are skipped */
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		if (i == CONFIG_NET_BATCH_SIZE) {
+			pkts[n++] = NULL;
+		}
+
+		pkts[n++] = rx_pkt_create(i);
+	}
+
+	zassert_ok(net_recv_data_batch(iface, pkts, n), "receiving failed");
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		zassert_equal(recv(sock, &seq, sizeof(seq), 0), sizeof(seq),
+			      "datagram %u not received (%d)", i, errno);
+		zassert_equal(ntohl(seq), i, "datagram %u received for %u",
+			      ntohl(seq), i);
+	}
+
+	zassert_equal(recv(sock, &seq, sizeof(seq), MSG_DONTWAIT), -1,
+		      "more datagrams received");
+	zassert_equal(errno, EAGAIN, "");
+
+	zassert_ok(close(sock), "");
+
+	wait_pool_free(rx, rx_free);
+}
+
+ZTEST(net_batch, test_tx_order)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(MY_PORT),
+		.sin_addr = my_addr,
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PEER_PORT),
+		.sin_addr = peer_addr,
+	};
+	struct net_if_tx_batch batch;
+	struct net_context *ctx;
+	struct k_mem_slab *rx, *tx;
+	struct net_buf_pool *rx_data, *tx_data;
+	uint32_t tx_free;
+	uint32_t seq;
+
+	tx_reset();
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	tx_free = k_mem_slab_num_free_get(tx);
+
+	zassert_ok(net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx), "");
+	zassert_ok(net_context_bind(ctx, (struct sockaddr *)&local, sizeof(local)),
+		   "");
+
+	net_if_tx_batch_begin(&batch, ctx);
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		seq = htonl(i);
+		zassert_equal(net_context_sendto(ctx, &seq, sizeof(seq),
+						 (struct sockaddr *)&peer,
+						 sizeof(peer), NULL, K_NO_WAIT,
+						 NULL),
+			      sizeof(seq), "datagram %u not sent", i);
+	}
+
+	net_if_tx_batch_end(&batch);
+
+	zassert_ok(k_sem_take(&tx_done, WAIT_TIME), "%zu of %d datagrams sent",
+		   tx_count, N_PKTS);
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		zassert_equal(tx_seq[i], i, "datagram %u sent for %u", tx_seq[i], i);
+	}
+
+	zassert_true(tx_batch_max > 1, "datagrams sent one by one");
+	zassert_true(tx_calls < N_PKTS, "%zu driver calls", tx_calls);
+
+	zassert_ok(net_context_put(ctx), "");
+
+	wait_pool_free(tx, tx_free);
+	zassert_equal(tx_count, N_PKTS, "%zu datagrams sent", tx_count);
+}
+
+ZTEST(net_batch, test_sendmmsg_order)
+{
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PEER_PORT),
+		.sin_addr = peer_addr,
+	};
+	static struct mmsghdr msgs[N_PKTS];
+	static struct iovec iovs[N_PKTS];
+	static uint32_t seqs[N_PKTS];
+	struct k_mem_slab *rx, *tx;
+	struct net_buf_pool *rx_data, *tx_data;
+	uint32_t tx_free;
+	int sock;
+
+	tx_reset();
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	tx_free = k_mem_slab_num_free_get(tx);
+
+	sock = socket_create();
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		seqs[i] = htonl(i);
+		iovs[i].iov_base = &seqs[i];
+		iovs[i].iov_len = sizeof(seqs[i]);
+		msgs[i].msg_hdr = (struct msghdr) {
+			.msg_name = &peer,
+			.msg_namelen = sizeof(peer),
+			.msg_iov = &iovs[i],
+			.msg_iovlen = 1,
+		};
+	}
+
+	zassert_equal(sendmmsg(sock, msgs, N_PKTS, 0), N_PKTS,
+		      "not all datagrams sent (%d)", errno);
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		zassert_equal(msgs[i].msg_len, sizeof(seqs[i]), "");
+	}
+
+	zassert_ok(k_sem_take(&tx_done, WAIT_TIME), "%zu of %d datagrams sent",
+		   tx_count, N_PKTS);
+
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		zassert_equal(tx_seq[i], i, "datagram %u sent for %u", tx_seq[i], i);
+	}
+
+	zassert_true(tx_batch_max > 1, "datagrams sent one by one");
+	zassert_true(tx_calls < N_PKTS, "%zu driver calls", tx_calls);
+
+	zassert_ok(close(sock), "");
+
+	wait_pool_free(tx, tx_free);
+	zassert_equal(tx_count, N_PKTS, "%zu datagrams sent", tx_count);
+}
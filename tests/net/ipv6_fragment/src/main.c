@@ -2287,10 +2287,53 @@ static enum net_verdict handle_ipv6_echo_reply(struct net_pkt *pkt,
 	return NET_OK;
 }
 
-ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
+/* Creates a received fragment from the headers in frag, followed by
+ * payload_len bytes of the test pattern that continues from *data. The
+ * cursor is left after the nexthdr field of the fragment header, where
+ * net_ipv6_handle_fragment_hdr() expects it.
+ */
+static struct net_pkt *create_recv_fragment(const uint8_t *frag, size_t frag_len,
+					    uint16_t payload_len, uint8_t *data)
 {
-	struct net_ipv6_hdr ipv6_hdr;
 	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, frag_len + payload_len,
+					AF_UNSPEC, 0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_cursor_init(pkt);
+
+	ret = net_pkt_write(pkt, frag, sizeof(struct net_ipv6_hdr) + 1);
+	zassert_true(ret == 0, "IPv6 header append failed");
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	ret = net_pkt_write(pkt, frag + sizeof(struct net_ipv6_hdr) + 1,
+			    frag_len - sizeof(struct net_ipv6_hdr) - 1);
+	zassert_true(ret == 0, "IPv6 fragment header append failed");
+
+	while (payload_len--) {
+		ret = net_pkt_write_u8(pkt, (*data)++);
+		zassert_true(ret == 0, "IPv6 header append failed");
+	}
+
+	net_pkt_set_ipv6_hdr_prev(pkt, offsetof(struct net_ipv6_hdr, nexthdr));
+	net_pkt_set_ipv6_fragment_start(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_overwrite(pkt, true);
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return pkt;
+}
+
+static void recv_ipv6_fragments(bool reverse)
+{
+	struct net_ipv6_hdr ipv6_hdr1;
+	struct net_ipv6_hdr ipv6_hdr2;
 	struct net_pkt *pkt1;
 	struct net_pkt *pkt2;
 	uint16_t payload1_len;
@@ -2305,88 +2348,36 @@ ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
 
 	net_icmpv6_register_handler(&ping6_handler);
 
-	/* Fragment 1 */
 	data = 0U;
 	payload1_len = NET_IPV6_MTU - sizeof(ipv6_reass_frag1);
 	payload2_len = test_recv_payload_len - payload1_len;
 
-	pkt1 = net_pkt_alloc_with_buffer(iface1, NET_IPV6_MTU, AF_UNSPEC,
-					 0, ALLOC_TIMEOUT);
-	zassert_not_null(pkt1, "packet");
-
-	net_pkt_set_family(pkt1, AF_INET6);
-	net_pkt_set_ip_hdr_len(pkt1, sizeof(struct net_ipv6_hdr));
-	net_pkt_cursor_init(pkt1);
-
-	memcpy(&ipv6_hdr, ipv6_reass_frag1, sizeof(struct net_ipv6_hdr));
-
-	ret = net_pkt_write(pkt1, ipv6_reass_frag1,
-			    sizeof(struct net_ipv6_hdr) + 1);
-	zassert_true(ret == 0, "IPv6 header append failed");
-
-	net_pkt_cursor_backup(pkt1, &backup);
-
-	ret = net_pkt_write(pkt1,
-			    ipv6_reass_frag1 + sizeof(struct net_ipv6_hdr) + 1,
-			    sizeof(ipv6_reass_frag1) -
-			    sizeof(struct net_ipv6_hdr) - 1);
-	zassert_true(ret == 0, "IPv6 fragment header append failed");
+	/* Fragment 1 */
+	memcpy(&ipv6_hdr1, ipv6_reass_frag1, sizeof(struct net_ipv6_hdr));
+	pkt1 = create_recv_fragment(ipv6_reass_frag1, sizeof(ipv6_reass_frag1),
+				    payload1_len, &data);
 
-	while (payload1_len--) {
-		ret = net_pkt_write_u8(pkt1, data++);
-		zassert_true(ret == 0, "IPv6 header append failed");
+	/* Fragment 2 */
+	memcpy(&ipv6_hdr2, ipv6_reass_frag2, sizeof(struct net_ipv6_hdr));
+	pkt2 = create_recv_fragment(ipv6_reass_frag2, sizeof(ipv6_reass_frag2),
+				    payload2_len, &data);
+
+	if (reverse) {
+		ret = net_ipv6_handle_fragment_hdr(pkt2, &ipv6_hdr2,
+						   NET_IPV6_NEXTHDR_FRAG);
+		zassert_true(ret == NET_OK, "IPv6 frag2 reassembly failed");
 	}
 
-	net_pkt_set_ipv6_hdr_prev(pkt1, offsetof(struct net_ipv6_hdr, nexthdr));
-	net_pkt_set_ipv6_fragment_start(pkt1, sizeof(struct net_ipv6_hdr));
-	net_pkt_set_overwrite(pkt1, true);
-
-	net_pkt_cursor_restore(pkt1, &backup);
-
-	ret = net_ipv6_handle_fragment_hdr(pkt1, &ipv6_hdr,
+	ret = net_ipv6_handle_fragment_hdr(pkt1, &ipv6_hdr1,
 					   NET_IPV6_NEXTHDR_FRAG);
 	zassert_true(ret == NET_OK, "IPv6 frag1 reassembly failed");
 
-	/* Fragment 2 */
-
-	pkt2 = net_pkt_alloc_with_buffer(iface1, payload2_len +
-					 sizeof(ipv6_reass_frag2),
-					 AF_UNSPEC, 0, ALLOC_TIMEOUT);
-	zassert_not_null(pkt2, "packet");
-
-	net_pkt_set_family(pkt2, AF_INET6);
-	net_pkt_set_ip_hdr_len(pkt2, sizeof(struct net_ipv6_hdr));
-	net_pkt_cursor_init(pkt2);
-
-	memcpy(&ipv6_hdr, ipv6_reass_frag2, sizeof(struct net_ipv6_hdr));
-
-	ret = net_pkt_write(pkt2, ipv6_reass_frag2,
-			    sizeof(struct net_ipv6_hdr) + 1);
-	zassert_true(ret == 0, "IPv6 header append failed");
-
-	net_pkt_cursor_backup(pkt2, &backup);
-
-	ret = net_pkt_write(pkt2,
-			    ipv6_reass_frag2 + sizeof(struct net_ipv6_hdr) + 1,
-			    sizeof(ipv6_reass_frag2) -
-			    sizeof(struct net_ipv6_hdr) - 1);
-	zassert_true(ret == 0, "IPv6 fragment header append failed");
-
-	while (payload2_len--) {
-		ret = net_pkt_write_u8(pkt2, data++);
-		zassert_true(ret == 0, "IPv6 header append failed");
+	if (!reverse) {
+		ret = net_ipv6_handle_fragment_hdr(pkt2, &ipv6_hdr2,
+						   NET_IPV6_NEXTHDR_FRAG);
+		zassert_true(ret == NET_OK, "IPv6 frag2 reassembly failed");
 	}
 
-	net_pkt_set_ipv6_hdr_prev(pkt2, offsetof(struct net_ipv6_hdr, nexthdr));
-	net_pkt_set_ipv6_fragment_start(pkt2, sizeof(struct net_ipv6_hdr));
-	net_pkt_set_overwrite(pkt2, true);
-
-	net_pkt_cursor_restore(pkt2, &backup);
-
-	ret = net_ipv6_handle_fragment_hdr(pkt2, &ipv6_hdr,
-					   NET_IPV6_NEXTHDR_FRAG);
-	zassert_true(ret == NET_OK, "IPv6 frag2 reassembly failed");
-
 	if (k_sem_take(&wait_data, WAIT_TIME)) {
 		NET_DBG("Timeout while waiting interface data");
 		zassert_true(false, "Timeout");
@@ -2395,4 +2386,14 @@ ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
 	net_icmpv6_unregister_handler(&ping6_handler);
 }
 
+ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
+{
+	recv_ipv6_fragments(false);
+}
+
+ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment_reverse)
+{
+	recv_ipv6_fragments(true);
+}
+
 ZTEST_SUITE(net_ipv6_fragment, NULL, test_setup, NULL, NULL, NULL);
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dns_resolve.h>
+
+/* The DNS server is a responder on the loopback interface that knows the
+ * names in the records table below and answers NXDOMAIN for any other.
+ * It counts the queries that it gets, which tells which results came
+ * from the cache.
+ */
+
+#define SERVER_PORT 53530
+#define DNS_TIMEOUT 500 /* ms */
+
+struct record {
+	const char *name;
+	uint8_t addr[4];
+	uint32_t ttl;
+};
+
+static const struct record records[] = {
+	{ "positive.test", { 192, 0, 2, 10 }, 60 },
+	{ "short.test", { 192, 0, 2, 11 }, 1 },
+	{ "zero.test", { 192, 0, 2, 12 }, 0 },
+	{ "lru1.test", { 192, 0, 2, 21 }, 60 },
+	{ "lru2.test", { 192, 0, 2, 22 }, 60 },
+	{ "lru3.test", { 192, 0, 2, 23 }, 60 },
+};
+
+static atomic_t queries;
+static int server_sock = -1;
+
+static K_THREAD_STACK_DEFINE(server_stack, 1536);
+static struct k_thread server_thread;
+
+static const struct record *find_record(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(records); i++) {
+		if (strcmp(records[i].name, name) == 0) {
+			return &records[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Turns the query into its response in place, returns the length */
+static int make_response(uint8_t *buf, int len, int size)
+{
+	const struct record *record;
+	char name[64];
+	int pos = 12, name_len = 0;
+
+	while (pos < len && buf[pos] != 0) {
+		int label = buf[pos++];
+
+		if (pos + label > len || name_len + label + 1 >= sizeof(name)) {
+			return -EINVAL;
+		}
+
+		if (name_len > 0) {
+			name[name_len++] = '.';
+		}
+
+		memcpy(&name[name_len], &buf[pos], label);
+		name_len += label;
+		pos += label;
+	}
+
+	name[name_len] = '\0';
+
+	/* Skip the root label, the query type and the query class */
+	pos += 5;
+	if (pos > len || pos + 16 > size) {
+		return -EINVAL;
+	}
+
+	record = find_record(name);
+
+	buf[2] = 0x81; /* Response, recursion desired */
+	buf[3] = record ? 0x80 : 0x83; /* Recursion available, rcode */
+	buf[6] = 0;
+	buf[7] = record ? 1 : 0;
+	memset(&buf[8], 0, 4);
+
+	if (!record) {
+		return pos;
+	}
+
+	/* Name pointer to the question, type A, class IN, TTL, address */
+	buf[pos++] = 0xc0;
+	buf[pos++] = 12;
+	sys_put_be16(1, &buf[pos]);
+	sys_put_be16(1, &buf[pos + 2]);
+	sys_put_be32(record->ttl, &buf[pos + 4]);
+	sys_put_be16(4, &buf[pos + 8]);
+	memcpy(&buf[pos + 10], record->addr, 4);
+
+	return pos + 14;
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	uint8_t buf[512];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		struct sockaddr addr;
+		socklen_t addrlen = sizeof(addr);
+		int len;
+
+		len = zsock_recvfrom(server_sock, buf, sizeof(buf), 0,
+				     &addr, &addrlen);
+		if (len < 12) {
+			continue;
+		}
+
+		atomic_inc(&queries);
+
+		len = make_response(buf, len, sizeof(buf));
+		if (len < 0) {
+			continue;
+		}
+
+		(void)zsock_sendto(server_sock, buf, len, 0, &addr, addrlen);
+	}
+}
+
+static struct {
+	struct k_sem done;
+	struct sockaddr_in addr;
+	int count;
+	int status;
+} result;
+
+static void result_cb(enum dns_resolve_status status,
+		      struct dns_addrinfo *info,
+		      void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (status == DNS_EAI_INPROGRESS) {
+		if (info) {
+			memcpy(&result.addr, &info->ai_addr,
+			       sizeof(result.addr));
+			result.count++;
+		}
+
+		return;
+	}
+
+	result.status = status;
+	k_sem_give(&result.done);
+}
+
+static int resolve(const char *name)
+{
+	int ret;
+
+	k_sem_reset(&result.done);
+	memset(&result.addr, 0, sizeof(result.addr));
+	result.count = 0;
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, result_cb, NULL,
+				DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot resolve %s (%d)", name, ret);
+
+	zassert_equal(k_sem_take(&result.done, K_MSEC(2 * DNS_TIMEOUT)), 0,
+		      "No result for %s", name);
+
+	return result.status;
+}
+
+static void resolve_ok(const char *name)
+{
+	const struct record *record = find_record(name);
+
+	zassert_equal(resolve(name), DNS_EAI_ALLDONE, "%s not resolved", name);
+	zassert_equal(result.count, 1, "Wrong number of addresses");
+	zassert_mem_equal(&result.addr.sin_addr, record->addr, 4,
+			  "Wrong address for %s", name);
+}
+
+static void *dns_cache_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+
+	k_sem_init(&result.done, 0, 1);
+
+	server_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "Cannot create server socket");
+
+	zassert_equal(zsock_bind(server_sock, (struct sockaddr *)&addr,
+				 sizeof(addr)), 0, "Cannot bind server socket");
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void dns_cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(dns_resolve_cache_flush(), 0, "Cannot flush cache");
+	atomic_set(&queries, 0);
+}
+
+ZTEST(dns_cache, test_positive)
+{
+	resolve_ok("positive.test");
+	zassert_equal(atomic_get(&queries), 1, "Query not sent");
+
+	resolve_ok("positive.test");
+	zassert_equal(atomic_get(&queries), 1, "Result not cached");
+
+	/* Names are not case sensitive */
+	resolve_ok("POSITIVE.test");
+	zassert_equal(atomic_get(&queries), 1, "Result not cached");
+}
+
+ZTEST(dns_cache, test_negative)
+{
+	zassert_equal(resolve("missing.test"), DNS_EAI_NODATA,
+		      "Missing name resolved");
+	zassert_equal(atomic_get(&queries), 1, "Query not sent");
+
+	zassert_equal(resolve("missing.test"), DNS_EAI_NODATA,
+		      "Missing name resolved");
+	zassert_equal(atomic_get(&queries), 1, "Negative result not cached");
+}
+
+ZTEST(dns_cache, test_ttl)
+{
+	resolve_ok("short.test");
+	resolve_ok("short.test");
+	zassert_equal(atomic_get(&queries), 1, "Result not cached");
+
+	k_msleep(1100);
+
+	resolve_ok("short.test");
+	zassert_equal(atomic_get(&queries), 2, "Result not expired");
+
+	/* A TTL of 0 means that the result must not be cached at all */
+	resolve_ok("zero.test");
+	resolve_ok("zero.test");
+	zassert_equal(atomic_get(&queries), 4, "Result cached with TTL 0");
+}
+
+ZTEST(dns_cache, test_flush)
+{
+	resolve_ok("positive.test");
+
+	zassert_equal(dns_resolve_cache_remove("positive.test"), 1,
+		      "Cannot remove name");
+	zassert_equal(dns_resolve_cache_remove("positive.test"), -ENOENT,
+		      "Name removed twice");
+
+	resolve_ok("positive.test");
+	zassert_equal(atomic_get(&queries), 2, "Removed result was used");
+
+	zassert_equal(dns_resolve_cache_flush(), 0, "Cannot flush cache");
+
+	resolve_ok("positive.test");
+	zassert_equal(atomic_get(&queries), 3, "Flushed result was used");
+}
+
+ZTEST(dns_cache, test_lru)
+{
+	resolve_ok("lru1.test");
+	resolve_ok("lru2.test");
+	zassert_equal(atomic_get(&queries), 2, "Queries not sent");
+
+	/* The cache has room for two entries, so after using lru1 again,
+	 * lru3 replaces lru2.
+	 */
+	resolve_ok("lru1.test");
+	resolve_ok("lru3.test");
+	zassert_equal(atomic_get(&queries), 3, "Wrong number of queries");
+
+	resolve_ok("lru1.test");
+	zassert_equal(atomic_get(&queries), 3, "Recently used entry evicted");
+
+	resolve_ok("lru2.test");
+	zassert_equal(atomic_get(&queries), 4, "Oldest entry not evicted");
+}
+
+static void count_cb(const char *query, enum dns_query_type type,
+		     const struct dns_addrinfo *addrs, int count,
+		     uint32_t ttl, void *user_data)
+{
+	int *addresses = user_data;
+
+	zassert_equal(type, DNS_QUERY_TYPE_A, "Wrong type");
+	zassert_true(ttl <= 60, "Wrong TTL");
+
+	*addresses += count;
+}
+
+ZTEST(dns_cache, test_foreach)
+{
+	int addresses = 0;
+
+	resolve_ok("positive.test");
+	(void)resolve("missing.test");
+
+	zassert_equal(dns_resolve_cache_foreach(count_cb, &addresses), 2,
+		      "Wrong number of entries");
+	zassert_equal(addresses, 1, "Wrong number of addresses");
+}
+
+ZTEST_SUITE(dns_cache, NULL, dns_cache_setup, dns_cache_before, NULL, NULL);
@@ -544,6 +544,43 @@ static void test_route_preference(void)
 	net_route_del(entry);
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct in6_addr prefix = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0 } } };
+	struct net_route_entry *prefix_entry, *found;
+
+	prefix_entry = net_route_add(my_iface, &prefix, 96, &peer_addr,
+				     NET_IPV6_ND_INFINITE_LIFETIME,
+				     NET_ROUTE_PREFERENCE_MEDIUM);
+	zassert_not_null(prefix_entry, "Prefix route add failed");
+
+	/* A host route inside the prefix is a route of its own */
+	entry = net_route_add(my_iface, &dest_addr, 128, &peer_addr_alt,
+			      NET_IPV6_ND_INFINITE_LIFETIME,
+			      NET_ROUTE_PREFERENCE_MEDIUM);
+	zassert_not_null(entry, "Host route add failed");
+	zassert_not_equal(entry, prefix_entry, "Prefix route was reused");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, entry, "Host route not preferred");
+
+	found = net_route_lookup(my_iface, &generic_addr);
+	zassert_equal_ptr(found, prefix_entry, "Prefix route not found");
+
+	found = net_route_lookup(NULL, &generic_addr);
+	zassert_equal_ptr(found, prefix_entry, "Prefix route not found");
+
+	zassert_false(net_route_del(entry), "Host route del failed");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, prefix_entry, "No fallback to prefix route");
+
+	zassert_false(net_route_del(prefix_entry), "Prefix route del failed");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_is_null(found, "Route found after deletion");
+}
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -566,6 +603,7 @@ ZTEST(route_test_suite, test_route)
 	test_route_del_many();
 	test_route_lifetime();
 	test_route_preference();
+	test_route_longest_prefix();
 }
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <zephyr/ztest_assert.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_epoll.h>
+#include <zephyr/sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+
+#define TEST_STR_SMALL "test"
+
+#define MY_IPV6_ADDR "::1"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* Long enough for a datagram to go through the loopback interface */
+#define WAIT_MS 100
+
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(3)
+
+static int c_sock;
+static int s_sock;
+static int epfd;
+
+static void epoll_before(void *fixture)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int res;
+
+	ARG_UNUSED(fixture);
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed (%d)", errno);
+}
+
+static void epoll_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)close(epfd);
+	(void)close(c_sock);
+	(void)close(s_sock);
+}
+
+static void add(int fd, uint32_t events)
+{
+	struct epoll_event event = {
+		.events = events,
+		.data.fd = fd,
+	};
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0,
+		      "epoll_ctl failed (%d)", errno);
+}
+
+static void send_small(void)
+{
+	zassert_equal(send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0),
+		      sizeof(TEST_STR_SMALL) - 1, "send failed");
+}
+
+static void recv_small(void)
+{
+	char buf[10];
+
+	zassert_equal(recv(s_sock, buf, sizeof(buf), 0),
+		      sizeof(TEST_STR_SMALL) - 1, "recv failed");
+}
+
+ZTEST(net_socket_epoll, test_level_triggered)
+{
+	struct epoll_event events[2];
+	uint32_t tstamp;
+	int res;
+
+	add(s_sock, EPOLLIN);
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_true(k_uptime_get_32() - tstamp >= 30, "");
+	zassert_equal(res, 0, "socket reported before data arrived");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "socket not reported");
+	zassert_equal(events[0].events, EPOLLIN, "wrong events");
+	zassert_equal(events[0].data.fd, s_sock, "wrong data");
+
+	/* Reported for as long as there is data */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "socket not reported again");
+
+	recv_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "socket reported without data");
+}
+
+ZTEST(net_socket_epoll, test_edge_triggered)
+{
+	struct epoll_event events[2];
+	int res;
+
+	add(s_sock, EPOLLIN | EPOLLET);
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "socket not reported");
+	zassert_equal(events[0].events, EPOLLIN, "wrong events");
+
+	/* The data is still there, but nothing new arrived */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "socket reported twice");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "socket not reported for new data");
+
+	recv_small();
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_pollout)
+{
+	struct epoll_event event = {
+		.events = EPOLLOUT | EPOLLET,
+		.data.u32 = 42,
+	};
+	struct epoll_event events[2];
+	int res;
+
+	add(c_sock, EPOLLOUT);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "socket not writable");
+	zassert_equal(events[0].events, EPOLLOUT, "wrong events");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "level triggered socket not reported again");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &event);
+	zassert_equal(res, 0, "epoll_ctl failed (%d)", errno);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "socket not writable");
+	zassert_equal(events[0].data.u32, 42, "wrong data");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "edge triggered socket reported twice");
+}
+
+ZTEST(net_socket_epoll, test_maxevents)
+{
+	struct epoll_event events[1];
+	int res;
+
+	add(s_sock, EPOLLIN);
+	add(c_sock, EPOLLOUT);
+
+	send_small();
+	k_msleep(WAIT_MS);
+
+	/* Both sockets are ready, but only one is returned at a time */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "sockets not reported");
+	zassert_equal(events[0].data.fd, s_sock, "wrong socket");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "sockets not reported");
+
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_ctl)
+{
+	struct epoll_event event = {
+		.events = EPOLLIN,
+	};
+	struct epoll_event events[2];
+	int res;
+
+	zassert_equal(epoll_create1(1), -1, "invalid flags accepted");
+	zassert_equal(errno, EINVAL, "wrong errno");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &event);
+	zassert_equal(res, -1, "socket not in the list modified");
+	zassert_equal(errno, ENOENT, "wrong errno");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "socket not in the list removed");
+	zassert_equal(errno, ENOENT, "wrong errno");
+
+	res = epoll_ctl(s_sock, EPOLL_CTL_ADD, c_sock, &event);
+	zassert_equal(res, -1, "socket used as epoll instance");
+	zassert_equal(errno, EINVAL, "wrong errno");
+
+	add(s_sock, EPOLLIN);
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &event);
+	zassert_equal(res, -1, "socket added twice");
+	zassert_equal(errno, EEXIST, "wrong errno");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed (%d)", errno);
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 0, "removed socket reported");
+
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_close)
+{
+	struct epoll_event events[2];
+	int res;
+
+	add(s_sock, EPOLLIN);
+	add(c_sock, EPOLLIN);
+
+	send_small();
+
+	/* Closing a socket takes it out of the interest list */
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 0, "closed socket reported");
+
+	/* Reopen it for epoll_after() */
+	s_sock = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(s_sock >= 0, "socket open failed");
+}
+
+ZTEST(net_socket_epoll, test_accept)
+{
+	struct epoll_event events[2];
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int c_sock_tcp;
+	int s_sock_tcp;
+	int new_sock;
+	int res;
+
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock_tcp, &c_addr);
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock_tcp, &s_addr);
+
+	res = bind(s_sock_tcp, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = listen(s_sock_tcp, 0);
+	zassert_equal(res, 0, "listen failed");
+
+	add(s_sock_tcp, EPOLLIN);
+
+	res = connect(c_sock_tcp, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), WAIT_MS);
+	zassert_equal(res, 1, "new connection not reported");
+	zassert_equal(events[0].data.fd, s_sock_tcp, "wrong socket");
+
+	new_sock = accept(s_sock_tcp, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	/* A connected TCP socket can be written to */
+	add(new_sock, EPOLLOUT);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "connected socket not writable");
+	zassert_equal(events[0].data.fd, new_sock, "wrong socket");
+	zassert_equal(events[0].events, EPOLLOUT, "wrong events");
+
+	res = close(new_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(c_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+	res = close(s_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+ZTEST_SUITE(net_socket_epoll, NULL, NULL, epoll_before, epoll_after, NULL);
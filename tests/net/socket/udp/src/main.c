@@ -9,6 +9,7 @@
 LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <stdio.h>
+#include <time.h>
 #include <zephyr/sys/mutex.h>
 #include <zephyr/ztest_assert.h>
 
@@ -1294,4 +1295,127 @@ ZTEST(net_socket_udp, test_23_v6_dgram_overflow)
 			    BUF_AND_SIZE(test_str_all_tx_bufs));
 }
 
+ZTEST_USER(net_socket_udp, test_24_v4_sendmmsg_recvmmsg)
+{
+	static const char * const strs[] = { "first", "second", "third", "fourth" };
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addrs[ARRAY_SIZE(strs) + 1];
+	char bufs[ARRAY_SIZE(strs) + 1][8];
+	struct iovec io_vector[ARRAY_SIZE(strs) + 1];
+	struct mmsghdr msgs[ARRAY_SIZE(strs) + 1];
+	struct timespec timeout;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, CLIENT_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(client_sock,
+		  (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (int i = 0; i < ARRAY_SIZE(strs); i++) {
+		io_vector[i].iov_base = (void *)strs[i];
+		io_vector[i].iov_len = strlen(strs[i]);
+		msgs[i].msg_hdr.msg_iov = &io_vector[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &server_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+	}
+
+	rv = sendmmsg(client_sock, msgs, ARRAY_SIZE(strs), 0);
+	zassert_equal(rv, ARRAY_SIZE(strs), "sendmmsg failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(strs); i++) {
+		zassert_equal(msgs[i].msg_len, strlen(strs[i]),
+			      "wrong msg_len for message %d", i);
+	}
+
+	/* Let all the datagrams go through the loopback interface */
+	k_msleep(100);
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+		io_vector[i].iov_base = bufs[i];
+		io_vector[i].iov_len = sizeof(bufs[i]);
+		msgs[i].msg_hdr.msg_iov = &io_vector[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+
+	/* Without MSG_WAITFORONE this would block for the last message */
+	rv = recvmmsg(server_sock, msgs, ARRAY_SIZE(msgs), MSG_WAITFORONE,
+		      NULL);
+	zassert_equal(rv, ARRAY_SIZE(strs), "recvmmsg failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(strs); i++) {
+		zassert_equal(msgs[i].msg_len, strlen(strs[i]),
+			      "wrong msg_len for message %d", i);
+		zassert_mem_equal(bufs[i], strs[i], strlen(strs[i]),
+				  "wrong data in message %d", i);
+		zassert_equal(msgs[i].msg_hdr.msg_flags, 0,
+			      "wrong flags in message %d", i);
+		zassert_equal(msgs[i].msg_hdr.msg_namelen, sizeof(addrs[i]),
+			      "wrong address length in message %d", i);
+		zassert_equal(addrs[i].sin_port, htons(CLIENT_PORT),
+			      "wrong source port in message %d", i);
+	}
+
+	rv = recvmmsg(server_sock, msgs, ARRAY_SIZE(msgs), MSG_DONTWAIT, NULL);
+	zassert_equal(rv, -1, "recvmmsg succeeded on an empty socket");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+
+	/* A datagram longer than its buffer is truncated */
+	rv = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR2), "send failed");
+
+	rv = recvmmsg(server_sock, msgs, 1, 0, NULL);
+	zassert_equal(rv, 1, "recvmmsg failed (%d)", errno);
+	zassert_equal(msgs[0].msg_len, sizeof(bufs[0]), "wrong msg_len");
+	zassert_equal(msgs[0].msg_hdr.msg_flags, MSG_TRUNC,
+		      "MSG_TRUNC not set");
+
+	/* A timeout too long to be counted in ticks never expires. This one
+	 * is a multiple of 2^(bits - 3), so converting it to milliseconds
+	 * in time_t would wrap around to exactly 0.
+	 */
+	for (int i = 0; i < 2; i++) {
+		rv = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+		zassert_equal(rv, STRLEN(TEST_STR_SMALL), "send failed");
+	}
+
+	k_msleep(100);
+
+	timeout.tv_sec = (time_t)(1ULL << (sizeof(time_t) * 8 - 3));
+	timeout.tv_nsec = 0;
+	rv = recvmmsg(server_sock, msgs, 2, 0, &timeout);
+	zassert_equal(rv, 2, "recvmmsg returned %d", rv);
+
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = NSEC_PER_SEC;
+	rv = recvmmsg(server_sock, msgs, 1, MSG_DONTWAIT, &timeout);
+	zassert_equal(rv, -1, "recvmmsg accepted an invalid timeout");
+	zassert_equal(errno, EINVAL, "incorrect errno value");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 ZTEST_SUITE(net_socket_udp, NULL, NULL, NULL, NULL, NULL);
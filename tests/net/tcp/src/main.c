@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
 #include <stddef.h>
 #include <string.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/linker/sections.h>
 #include <zephyr/tc_util.h>
 
@@ -125,6 +126,7 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_segment_record(struct net_pkt *pkt);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -213,6 +215,13 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Options sent by the peer in any segment, set by the test case */
+static const uint8_t *test_options;
+static uint8_t test_options_len;
+
+/* Window advertised by the peer, when set by the test case */
+static uint16_t test_peer_win;
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -223,10 +232,12 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct net_pkt *pkt;
 	struct tcphdr *th;
-	uint8_t opts_len = 0;
+	const uint8_t *opts = test_options;
+	uint8_t opts_len = test_options_len;
 	int ret = -EINVAL;
 
 	if ((test_case_no == 4U) && (flags & SYN)) {
+		opts = tcp_options;
 		opts_len = sizeof(tcp_options);
 	}
 
@@ -262,14 +273,10 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
-	} else {
-		th->th_off = 5U;
-	}
+	th->th_off = 5U + opts_len / 4U;
 
 	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
+	th->th_win = test_peer_win ? htons(test_peer_win) : NET_IPV6_MTU;
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -281,9 +288,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (opts_len) {
 		/* Add TCP Options */
-		ret = net_pkt_write(pkt, tcp_options, opts_len);
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -420,6 +427,9 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_segment_record(pkt);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1350,11 +1360,11 @@ ZTEST(net_tcp, test_client_invalid_rst)
 {
 	struct net_context *ctx;
 	struct tcp *conn;
-	uint16_t wnd;
+	uint32_t wnd;
 
 	ctx = create_server_socket(0, 0);
 
-	conn = ctx->tcp;
+	conn = accepted_ctx->tcp;
 	wnd = conn->recv_win;
 
 	/* Failure cases, the RST packets should be dropped */
@@ -1539,4 +1549,811 @@ ZTEST(net_tcp, test_server_out_of_order_data)
 	test_server_timeout_out_of_order_data();
 }
 
+/* Outgoing segments seen by handle_segment_record() */
+struct test_segment {
+	struct tcphdr th;
+	size_t pkt_len;
+	size_t data_len;
+	uint8_t opts_len;
+	uint16_t mss;
+	uint8_t wscale;
+	uint32_t tsval;
+	uint32_t tsecr;
+	struct tcp_sack_block sack[NET_TCP_MAX_SACK_BLOCKS];
+	uint8_t sack_count;
+	bool mss_found : 1;
+	bool wscale_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
+};
+
+#define MAX_SEGMENTS 16
+static struct test_segment segments[MAX_SEGMENTS];
+static int segment_count;
+
+static void parse_test_segment_options(struct test_segment *seg,
+				       const uint8_t *opts, size_t len)
+{
+	size_t i = 0;
+
+	while (i < len) {
+		uint8_t kind = opts[i];
+		uint8_t opt_len;
+
+		if (kind == NET_TCP_END_OPT) {
+			break;
+		}
+
+		if (kind == NET_TCP_NOP_OPT) {
+			i++;
+			continue;
+		}
+
+		zassert_true(i + 1 < len, "Truncated option %u", kind);
+		opt_len = opts[i + 1];
+		zassert_true(opt_len >= 2 && i + opt_len <= len,
+			     "Bad length %u for option %u", opt_len, kind);
+
+		switch (kind) {
+		case NET_TCP_MSS_OPT:
+			seg->mss = sys_get_be16(&opts[i + 2]);
+			seg->mss_found = true;
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			seg->wscale = opts[i + 2];
+			seg->wscale_found = true;
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			seg->sack_perm_found = true;
+			break;
+		case NET_TCP_TIMESTAMP_OPT:
+			seg->tsval = sys_get_be32(&opts[i + 2]);
+			seg->tsecr = sys_get_be32(&opts[i + 6]);
+			seg->ts_found = true;
+			break;
+		case NET_TCP_SACK_OPT:
+			for (size_t j = 2; j + NET_TCP_SACK_BLOCK_SIZE <= opt_len &&
+			     seg->sack_count < NET_TCP_MAX_SACK_BLOCKS;
+			     j += NET_TCP_SACK_BLOCK_SIZE) {
+				seg->sack[seg->sack_count].start =
+					sys_get_be32(&opts[i + j]);
+				seg->sack[seg->sack_count].end =
+					sys_get_be32(&opts[i + j + 4]);
+				seg->sack_count++;
+			}
+			break;
+		default:
+			break;
+		}
+
+		i += opt_len;
+	}
+}
+
+static void handle_segment_record(struct net_pkt *pkt)
+{
+	struct test_segment *seg;
+	uint8_t opts[40];
+	size_t hdr_len;
+	int ret;
+
+	zassert_true(segment_count < MAX_SEGMENTS, "Too many segments");
+	seg = &segments[segment_count];
+	memset(seg, 0, sizeof(*seg));
+
+	ret = read_tcp_header(pkt, &seg->th);
+	zassert_equal(ret, 0, "Cannot read TCP header");
+
+	seg->pkt_len = net_pkt_get_len(pkt);
+	seg->opts_len = (seg->th.th_off - 5U) * 4U;
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		  sizeof(struct tcphdr);
+	seg->data_len = seg->pkt_len - hdr_len - seg->opts_len;
+
+	net_pkt_set_overwrite(pkt, true);
+	ret = net_pkt_skip(pkt, hdr_len);
+	zassert_equal(ret, 0, "Cannot skip headers");
+	ret = net_pkt_read(pkt, opts, seg->opts_len);
+	zassert_equal(ret, 0, "Cannot read options");
+	net_pkt_cursor_init(pkt);
+
+	parse_test_segment_options(seg, opts, seg->opts_len);
+
+	segment_count++;
+}
+
+__maybe_unused static void segment_close(struct net_context *ctx)
+{
+	struct net_pkt *rst;
+	int ret;
+
+	test_options = NULL;
+	test_options_len = 0U;
+	test_peer_win = 0U;
+
+	/* Abort the connection, no need for a full closing handshake */
+	rst = prepare_rst_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, rst);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	k_msleep(50);
+
+	net_context_put(ctx);
+	net_context_put(accepted_ctx);
+}
+
+__maybe_unused static struct net_context *segment_listen(void)
+{
+	struct net_context *ctx;
+	int ret;
+
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	zassert_equal(ret, 0, "Failed to get net_context");
+
+	net_context_ref(ctx);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&my_addr_s,
+			       sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Failed to bind net_context");
+
+	ret = net_context_listen(ctx, 1);
+	zassert_equal(ret, 0, "Failed to listen on net_context");
+
+	ret = net_context_accept(ctx, test_tcp_accept_cb, K_FOREVER, NULL);
+	zassert_equal(ret, 0, "Failed to set accept on net_context");
+
+	return ctx;
+}
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) && defined(CONFIG_NET_TCP_TIMESTAMPS) && \
+	defined(CONFIG_NET_TCP_SACK)
+#define EXT_PEER_WSCALE 7
+#define EXT_PEER_TSVAL 0xc27bef0f
+
+/* MSS 1460, window scale, SACK permitted and a timestamp */
+static uint8_t ext_syn_options[20] = {
+	0x02, 0x04, 0x05, 0xb4,
+	0x01, 0x03, 0x03, EXT_PEER_WSCALE,
+	0x04, 0x02, 0x08, 0x0a,
+	0xc2, 0x7b, 0xef, 0x0f, 0x00, 0x00, 0x00, 0x00 };
+
+static uint8_t ext_ts_options[12] = { 0x01, 0x01, 0x08, 0x0a };
+
+/* Send a segment from the peer with the timestamp option, or with the
+ * options of the SYN, and let the stack answer it.
+ */
+static void ext_peer_send(uint8_t flags, const uint8_t *data, size_t len,
+			  uint32_t tsval, uint32_t tsecr)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	if (flags & SYN) {
+		test_options = ext_syn_options;
+		test_options_len = sizeof(ext_syn_options);
+	} else {
+		sys_put_be32(tsval, &ext_ts_options[4]);
+		sys_put_be32(tsecr, &ext_ts_options[8]);
+		test_options = ext_ts_options;
+		test_options_len = sizeof(ext_ts_options);
+	}
+
+	segment_count = 0;
+
+	pkt = tester_prepare_tcp_pkt(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				     flags, data, len);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	/* Let the receiving thread run */
+	k_msleep(50);
+}
+
+/* Test case scenario IPv4
+ *   Expect SYN with window scale, SACK permitted and timestamp,
+ *   send SYN ACK with all three and the echoed timestamp,
+ *   expect ACK, check that all three options are in use,
+ *   send DATA, expect ACK echoing its timestamp,
+ *   send DATA past a hole, expect ACK with a SACK block and the
+ *   timestamp of the last in-sequence segment,
+ *   send data from the application, expect segments that fit in the
+ *   MSS and MTU together with their options.
+ */
+ZTEST(net_tcp, test_server_extensions_ipv4)
+{
+	struct test_segment *seg;
+	struct net_context *ctx;
+	struct tcp *conn;
+	size_t mss;
+	int ret;
+
+	ctx = segment_listen();
+
+	/* SYN, the SYN ACK offers all options and echoes the timestamp */
+	ext_peer_send(SYN, NULL, 0, 0, 0);
+	zassert_equal(segment_count, 1, "Expected SYN ACK");
+	seg = &segments[0];
+	test_verify_flags(&seg->th, SYN | ACK);
+	zassert_true(seg->mss_found, "No MSS in SYN ACK");
+	zassert_true(seg->wscale_found, "No window scale in SYN ACK");
+	zassert_true(seg->sack_perm_found, "No SACK permitted in SYN ACK");
+	zassert_true(seg->ts_found, "No timestamp in SYN ACK");
+	zassert_equal(seg->tsecr, EXT_PEER_TSVAL, "Timestamp not echoed");
+
+	seq++;
+	ack = ntohl(seg->th.th_seq) + 1U;
+
+	/* ACK completes the handshake */
+	ext_peer_send(ACK, NULL, 0, 100, seg->tsval);
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = accepted_ctx->tcp;
+	zassert_true(conn->wscale_ok, "Window scale not negotiated");
+	zassert_true(conn->ts_ok, "Timestamps not negotiated");
+	zassert_true(conn->sack_ok, "SACK not negotiated");
+	zassert_equal(conn->send_wscale, EXT_PEER_WSCALE, "Wrong peer scale");
+	zassert_equal(conn->recv_wscale, segments[0].wscale, "Wrong own scale");
+	zassert_equal(conn->send_win,
+		      (uint32_t)ntohs(NET_IPV6_MTU) << EXT_PEER_WSCALE,
+		      "Peer window not scaled");
+
+	/* In-sequence data, the ACK echoes its timestamp */
+	ext_peer_send(PSH | ACK, lorem_ipsum, 10, 200, 0);
+	zassert_equal(segment_count, 1, "Expected ACK");
+	seg = &segments[0];
+	test_verify_flags(&seg->th, ACK);
+	zassert_equal(ntohl(seg->th.th_ack), seq + 10U, "Data not acked");
+	zassert_true(seg->ts_found, "No timestamp in ACK");
+	zassert_equal(seg->tsecr, 200, "Timestamp not echoed");
+	zassert_equal(seg->sack_count, 0, "Unexpected SACK block");
+	zassert_true(((uint32_t)ntohs(seg->th.th_win) << conn->recv_wscale) <=
+		     conn->recv_win_max, "Window not scaled down");
+	zassert_true(((uint32_t)ntohs(seg->th.th_win) << conn->recv_wscale) >
+		     conn->recv_win_max / 2U, "Window not scaled down");
+
+	seq += 10U;
+
+	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT > 0) {
+		/* Data past a hole is reported in a SACK block. Its timestamp
+		 * is not echoed, the segment is not in sequence.
+		 */
+		seq += 10U;
+		ext_peer_send(PSH | ACK, lorem_ipsum + 20, 10, 300, 0);
+		seq -= 10U;
+
+		zassert_equal(segment_count, 1, "Expected duplicate ACK");
+		seg = &segments[0];
+		zassert_equal(ntohl(seg->th.th_ack), seq, "Hole acked");
+		zassert_equal(seg->tsecr, 200, "Out of order timestamp echoed");
+		zassert_equal(seg->sack_count, 1, "Expected one SACK block");
+		zassert_equal(seg->sack[0].start, seq + 10U, "Wrong SACK start");
+		zassert_equal(seg->sack[0].end, seq + 20U, "Wrong SACK end");
+	}
+
+	/* Data segments carry the timestamp, and the SACK block while the
+	 * hole is there, on top of the data, within the MSS.
+	 */
+	segment_count = 0;
+	mss = MIN(0x05b4, net_if_get_mtu(iface) - NET_IPV4H_LEN - NET_TCPH_LEN);
+
+	ret = net_context_send(accepted_ctx, lorem_ipsum, 4 * mss, NULL,
+			       K_NO_WAIT, NULL);
+	zassert_true(ret > 0, "Failed to send data to peer");
+
+	k_msleep(50);
+
+	zassert_true(segment_count > 0, "No data sent");
+	for (int i = 0; i < segment_count; i++) {
+		seg = &segments[i];
+
+		zassert_true(seg->ts_found, "No timestamp in data segment");
+		zassert_true(seg->data_len > 0, "No data in segment");
+		zassert_true(seg->data_len + seg->opts_len <= mss,
+			     "Segment %d larger than MSS (%zu + %u > %zu)", i,
+			     seg->data_len, seg->opts_len, mss);
+		zassert_true(seg->pkt_len <= net_if_get_mtu(iface),
+			     "Segment %d larger than MTU", i);
+	}
+
+	segment_close(ctx);
+}
+
+/* Test case scenario IPv4
+ *   Expect SYN without options,
+ *   send SYN ACK without window scale, SACK and timestamps,
+ *   expect ACK, check that none of them are in use,
+ *   send DATA, expect ACK without options.
+ */
+ZTEST(net_tcp, test_server_extensions_not_offered_ipv4)
+{
+	struct test_segment *seg;
+	struct net_context *ctx;
+	struct tcp *conn;
+	struct net_pkt *pkt;
+	int ret;
+
+	ctx = segment_listen();
+
+	test_options = NULL;
+	test_options_len = 0U;
+	segment_count = 0;
+
+	pkt = prepare_syn_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(50);
+
+	zassert_equal(segment_count, 1, "Expected SYN ACK");
+	seg = &segments[0];
+	test_verify_flags(&seg->th, SYN | ACK);
+	zassert_false(seg->wscale_found, "Window scale in SYN ACK");
+	zassert_false(seg->sack_perm_found, "SACK permitted in SYN ACK");
+	zassert_false(seg->ts_found, "Timestamp in SYN ACK");
+
+	seq++;
+	ack = ntohl(seg->th.th_seq) + 1U;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = accepted_ctx->tcp;
+	zassert_false(conn->wscale_ok, "Window scale in use");
+	zassert_false(conn->ts_ok, "Timestamps in use");
+	zassert_false(conn->sack_ok, "SACK in use");
+	zassert_equal(conn->send_win, ntohs(NET_IPV6_MTU), "Peer window scaled");
+
+	segment_count = 0;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				  lorem_ipsum, 10);
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(50);
+
+	zassert_equal(segment_count, 1, "Expected ACK");
+	zassert_equal(segments[0].opts_len, 0, "Options in ACK");
+
+	seq += 10U;
+
+	segment_close(ctx);
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
+/* The peer sends no MSS option, so segments are sized by the interface */
+static uint32_t ca_mss(void)
+{
+	return net_if_get_mtu(iface) - NET_IPV4H_LEN - NET_TCPH_LEN;
+}
+
+/* Threshold set by the congestion control algorithm on a loss */
+static uint32_t ca_loss_ssthresh(struct tcp *conn)
+{
+	uint32_t ssthresh;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CUBIC)) {
+		ssthresh = conn->ca.cwnd / 10U * 7U;
+	} else {
+		ssthresh = conn->unacked_len / 2U;
+	}
+
+	return MAX(ssthresh, 2U * ca_mss());
+}
+
+static struct tcp *ca_connect(struct net_context **ctx)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	*ctx = segment_listen();
+	test_peer_win = UINT16_MAX;
+	segment_count = 0;
+
+	pkt = prepare_syn_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	k_msleep(10);
+
+	zassert_equal(segment_count, 1, "Expected SYN ACK");
+	seq++;
+	ack = ntohl(segments[0].th.th_seq) + 1U;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	return accepted_ctx->tcp;
+}
+
+static void ca_app_send(size_t len)
+{
+	size_t sent = 0;
+	int ret;
+
+	segment_count = 0;
+
+	/* A single call may queue only part of the data */
+	while (sent < len) {
+		ret = net_context_send(accepted_ctx, lorem_ipsum + sent,
+				       len - sent, NULL, K_NO_WAIT, NULL);
+		zassert_true(ret > 0, "Failed to send data to peer (%d)", ret);
+		sent += ret;
+	}
+
+	k_msleep(10);
+}
+
+/* Acknowledge our data up to ack_seq. The sleep is kept well below the
+ * retransmission timeout, so that duplicate ACKs don't race with it.
+ */
+static void ca_peer_ack(uint32_t ack_seq)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	ack = ack_seq;
+	segment_count = 0;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	k_msleep(10);
+}
+
+static bool ca_segment_sent(uint32_t seg_seq)
+{
+	for (int i = 0; i < segment_count; i++) {
+		if (ntohl(segments[i].th.th_seq) == seg_seq) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Test case scenario IPv4
+ *   The initial window goes out, each ACK grows cwnd by one segment in
+ *   slow start, and by about one segment per window in congestion
+ *   avoidance.
+ */
+ZTEST(net_tcp, test_congestion_window_growth_ipv4)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t snd_una;
+	uint32_t mss = ca_mss();
+	uint32_t cwnd;
+
+	conn = ca_connect(&ctx);
+	snd_una = conn->seq;
+
+	zassert_equal(conn->ca.cwnd, 10U * mss, "Wrong initial window %u",
+		      conn->ca.cwnd);
+	zassert_equal(conn->ca.ssthresh, UINT32_MAX, "Threshold set");
+
+	ca_app_send(15U * mss);
+	zassert_equal(segment_count, 10, "Sent %d segments, expected 10",
+		      segment_count);
+
+	/* Slow start, one segment acked lets two new ones out */
+	ca_peer_ack(snd_una + mss);
+	zassert_equal(conn->ca.cwnd, 11U * mss, "No slow start growth");
+	zassert_equal(segment_count, 2, "Sent %d segments, expected 2",
+		      segment_count);
+
+	/* Growth is bounded to one segment per ACK */
+	ca_peer_ack(snd_una + 3U * mss);
+	zassert_equal(conn->ca.cwnd, 12U * mss, "Growth past one segment");
+
+	/* Congestion avoidance, acking a full window grows it by about
+	 * one segment, NewReno by exactly one.
+	 */
+	conn->ca.ssthresh = conn->ca.cwnd;
+	cwnd = conn->ca.cwnd;
+
+	ca_peer_ack(snd_una + 4U * mss);
+	zassert_true(conn->ca.cwnd < cwnd + mss / 2U,
+		     "Slow start growth in congestion avoidance");
+
+	for (uint32_t i = 5U; i <= 15U; i++) {
+		ca_peer_ack(snd_una + i * mss);
+	}
+
+	zassert_true(conn->ca.cwnd > cwnd, "No congestion avoidance growth");
+	zassert_true(conn->ca.cwnd <= cwnd + mss,
+		     "Window grew by %u, more than a segment",
+		     conn->ca.cwnd - cwnd);
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_NEWRENO)) {
+		zassert_equal(conn->ca.cwnd, cwnd + mss,
+			      "NewReno did not grow by one segment");
+	}
+
+	segment_close(ctx);
+}
+
+/* Test case scenario IPv4
+ *   The first segment of a window is lost. The third duplicate ACK
+ *   triggers its retransmission and fast recovery, further duplicate
+ *   ACKs inflate the window, a partial ACK retransmits the next hole
+ *   and keeps recovery going, a full ACK ends it.
+ */
+ZTEST(net_tcp, test_congestion_fast_recovery_ipv4)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t snd_una;
+	uint32_t mss = ca_mss();
+	uint32_t ssthresh;
+	uint32_t cwnd;
+
+	conn = ca_connect(&ctx);
+	snd_una = conn->seq;
+
+	ca_app_send(15U * mss);
+	zassert_equal(conn->unacked_len, 10U * mss, "Initial window not sent");
+	ssthresh = ca_loss_ssthresh(conn);
+
+	ca_peer_ack(snd_una);
+	ca_peer_ack(snd_una);
+	zassert_false(conn->ca.in_recovery, "Recovery before third dup ACK");
+	zassert_equal(segment_count, 0, "Retransmission before third dup ACK");
+
+	ca_peer_ack(snd_una);
+	zassert_true(conn->ca.in_recovery, "No fast recovery");
+	zassert_equal(conn->ca.ssthresh, ssthresh, "Wrong threshold %u",
+		      conn->ca.ssthresh);
+	zassert_equal(conn->ca.cwnd, ssthresh + 3U * mss, "Wrong window %u",
+		      conn->ca.cwnd);
+	zassert_equal(conn->ca.recover, snd_una + 10U * mss,
+		      "Wrong recovery point");
+	zassert_equal(segment_count, 1, "Expected one retransmission");
+	zassert_equal(ntohl(segments[0].th.th_seq), snd_una,
+		      "Lost segment not retransmitted");
+	zassert_equal(segments[0].data_len, mss, "Partial retransmission");
+
+	cwnd = conn->ca.cwnd;
+	ca_peer_ack(snd_una);
+	zassert_equal(conn->ca.cwnd, cwnd + mss, "Window not inflated");
+
+	/* The retransmission filled the first hole, the fourth segment
+	 * was lost too.
+	 */
+	cwnd = conn->ca.cwnd;
+	ca_peer_ack(snd_una + 3U * mss);
+	zassert_true(conn->ca.in_recovery, "Recovery ended on a partial ACK");
+	zassert_equal(conn->ca.cwnd, cwnd - 3U * mss + mss,
+		      "Window not deflated by the acked data");
+	zassert_true(ca_segment_sent(snd_una + 3U * mss),
+		     "Next hole not retransmitted");
+
+	ca_peer_ack(snd_una + 10U * mss);
+	zassert_false(conn->ca.in_recovery, "Recovery not ended");
+	zassert_equal(conn->ca.cwnd, ssthresh, "Window not set to threshold");
+
+	segment_close(ctx);
+}
+
+/* Test case scenario IPv4
+ *   Nothing gets acked, on the retransmission timeout the window
+ *   collapses to one segment and slow start begins again.
+ */
+ZTEST(net_tcp, test_congestion_timeout_ipv4)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t snd_una;
+	uint32_t mss = ca_mss();
+	uint32_t ssthresh;
+
+	conn = ca_connect(&ctx);
+	snd_una = conn->seq;
+
+	ca_app_send(15U * mss);
+	ssthresh = ca_loss_ssthresh(conn);
+
+	/* Past the first timeout, before the backed off second one */
+	segment_count = 0;
+	k_msleep(2 * CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT);
+
+	zassert_equal(conn->ca.cwnd, mss, "Window not collapsed");
+	zassert_equal(conn->ca.ssthresh, ssthresh, "Wrong threshold %u",
+		      conn->ca.ssthresh);
+	zassert_false(conn->ca.in_recovery, "In fast recovery");
+	zassert_equal(segment_count, 1, "Expected one retransmission");
+	zassert_equal(ntohl(segments[0].th.th_seq), snd_una,
+		      "First segment not retransmitted");
+
+	ca_peer_ack(snd_una + mss);
+	zassert_equal(conn->ca.cwnd, 2U * mss, "No slow start after timeout");
+	zassert_equal(segment_count, 2, "Sent %d segments, expected 2",
+		      segment_count);
+
+	segment_close(ctx);
+}
+
+/* Data segments in flight on the lossy link of the test below */
+struct ca_link_segment {
+	uint32_t seq;
+	uint32_t len;
+};
+
+#define CA_LINK_MAX_SEGMENTS 64
+static struct ca_link_segment ca_link[CA_LINK_MAX_SEGMENTS];
+static int ca_link_head;
+static int ca_link_tail;
+
+/* The loss has to be repaired before the retransmission timeout, which
+ * is not restarted by ACKs, so the peer doesn't sleep between its ACKs
+ * but only lets the RX thread process each of them.
+ */
+static void ca_link_ack(uint32_t ack_seq)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	ack = ack_seq;
+	segment_count = 0;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "recv data failed (%d)", ret);
+
+	k_yield();
+}
+
+static void ca_link_queue_sent(void)
+{
+	for (int i = 0; i < segment_count; i++) {
+		if (segments[i].data_len == 0U) {
+			continue;
+		}
+
+		zassert_true(ca_link_tail < CA_LINK_MAX_SEGMENTS,
+			     "Too many segments on the link");
+		ca_link[ca_link_tail].seq = ntohl(segments[i].th.th_seq);
+		ca_link[ca_link_tail].len = segments[i].data_len;
+		ca_link_tail++;
+	}
+}
+
+/* Receiver at the far end of the lossy link */
+struct ca_lossy_peer {
+	uint32_t drop_seq;
+	uint32_t rcv_nxt;
+	uint32_t ooo_end;
+	uint32_t cwnd_before;
+	uint32_t cwnd_after;
+	uint32_t ssthresh;
+	int dup_acks;
+	bool dropped;
+	bool recovered;
+};
+
+/* Deliver the segments on the link to the peer, which buffers what
+ * arrives past the hole and acks every segment with the next sequence
+ * number it expects, as a real receiver would.
+ */
+static void ca_link_deliver(struct ca_lossy_peer *peer, struct tcp *conn)
+{
+	while (ca_link_head < ca_link_tail) {
+		struct ca_link_segment seg = ca_link[ca_link_head++];
+		bool in_recovery = conn->ca.in_recovery;
+		uint32_t prev_ack = peer->rcv_nxt;
+
+		if (!peer->dropped && seg.seq == peer->drop_seq) {
+			peer->dropped = true;
+			peer->cwnd_before = conn->ca.cwnd;
+			continue;
+		}
+
+		if (seg.seq == peer->rcv_nxt) {
+			peer->rcv_nxt = MAX(seg.seq + seg.len, peer->ooo_end);
+		} else if (seg.seq > peer->rcv_nxt) {
+			peer->ooo_end = MAX(peer->ooo_end, seg.seq + seg.len);
+		}
+
+		if (peer->rcv_nxt == prev_ack && peer->dup_acks == 2) {
+			peer->ssthresh = ca_loss_ssthresh(conn);
+		}
+
+		ca_link_ack(peer->rcv_nxt);
+
+		if (peer->rcv_nxt == prev_ack) {
+			peer->dup_acks++;
+			if (peer->dup_acks < 3) {
+				zassert_false(conn->ca.in_recovery,
+					      "Recovery before third dup ACK");
+				zassert_false(ca_segment_sent(peer->drop_seq),
+					      "Retransmission before third dup ACK");
+			} else if (peer->dup_acks == 3) {
+				zassert_true(conn->ca.in_recovery,
+					     "No fast recovery");
+				zassert_true(ca_segment_sent(peer->drop_seq),
+					     "No fast retransmit");
+				zassert_equal(conn->ca.ssthresh, peer->ssthresh,
+					      "Wrong threshold %u",
+					      conn->ca.ssthresh);
+			}
+		} else if (in_recovery && !conn->ca.in_recovery) {
+			peer->recovered = true;
+			peer->cwnd_after = conn->ca.cwnd;
+			zassert_equal(peer->cwnd_after, peer->ssthresh,
+				      "Window not set to threshold");
+			zassert_true(peer->cwnd_after < peer->cwnd_before,
+				     "Window %u not below %u before the loss",
+				     peer->cwnd_after, peer->cwnd_before);
+		}
+
+		ca_link_queue_sent();
+	}
+}
+
+/* Test case scenario IPv4
+ *   The link drops the third data segment. The third duplicate ACK must
+ *   trigger its retransmission, the window must end up below what it
+ *   was before the loss, and the window must grow again while the
+ *   following data gets through.
+ */
+ZTEST(net_tcp, test_congestion_lossy_link_ipv4)
+{
+	struct ca_lossy_peer peer = { 0 };
+	struct net_context *ctx;
+	struct tcp *conn;
+	uint32_t snd_una;
+	uint32_t mss = ca_mss();
+	uint32_t len = (sizeof(lorem_ipsum) - 1) / mss * mss;
+
+	conn = ca_connect(&ctx);
+	snd_una = conn->seq;
+	peer.drop_seq = snd_una + 2U * mss;
+	peer.rcv_nxt = peer.ooo_end = snd_una;
+	ca_link_head = ca_link_tail = 0;
+
+	for (int i = 0; i < 3; i++) {
+		ca_app_send(len);
+		ca_link_queue_sent();
+		ca_link_deliver(&peer, conn);
+	}
+
+	zassert_true(peer.dropped, "Segment not dropped");
+	zassert_true(peer.recovered, "Fast recovery never ended");
+	zassert_equal(peer.rcv_nxt, snd_una + 3U * len,
+		      "Data missing at the peer");
+	zassert_equal(conn->unacked_len, 0U, "Data left unacked");
+	zassert_true(conn->ca.cwnd > peer.cwnd_after,
+		     "Window did not grow after recovery");
+
+	segment_close(ctx);
+}
+
+#ifdef CONFIG_NET_TCP_CONGESTION_CUBIC
+ZTEST(net_tcp, test_congestion_cubic_root)
+{
+	zassert_equal(tcp_ca_cubic_root(0), 0);
+	zassert_equal(tcp_ca_cubic_root(1), 1);
+	zassert_equal(tcp_ca_cubic_root(7), 1);
+	zassert_equal(tcp_ca_cubic_root(8), 2);
+	zassert_equal(tcp_ca_cubic_root(26), 2);
+	zassert_equal(tcp_ca_cubic_root(27), 3);
+	zassert_equal(tcp_ca_cubic_root(999), 9);
+	zassert_equal(tcp_ca_cubic_root(1000), 10);
+
+	/* K in ms for cwnd 10 segments below W_max, 2.924 s in RFC 8312 */
+	zassert_equal(tcp_ca_cubic_root(10ULL * 2500000000ULL), 2924);
+
+	zassert_equal(tcp_ca_cubic_root(18446724184312856124ULL), 2642244);
+	zassert_equal(tcp_ca_cubic_root(18446724184312856125ULL), 2642245);
+	zassert_equal(tcp_ca_cubic_root(UINT64_MAX), 2642245);
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CUBIC */
+#endif /* CONFIG_NET_TCP_CONGESTION_AVOIDANCE */
+
 ZTEST_SUITE(net_tcp, NULL, presetup, NULL, NULL, NULL);
@@ -30,6 +30,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 #include <zephyr/net/udp.h>
 
 #include "ipv6.h"
+#include "udp_internal.h"
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
@@ -1053,6 +1054,122 @@ ZTEST(net_traffic_class, test_mix_all_2)
 	test_traffic_class_recv_data_mix_all_2();
 }
 
+#if defined(CONFIG_NET_TC_RX_RSS)
+#define RSS_PORT 4242
+#define RSS_FLOWS 32
+#define RSS_ROUNDS 4
+
+/* RX queue thread that handled each flow, flows differ by source port */
+static k_tid_t rss_flow_thread[RSS_FLOWS];
+static bool rss_flow_moved;
+static K_SEM_DEFINE(rss_recv, 0, RSS_FLOWS);
+
+static void rss_recv_cb(struct net_context *context,
+			struct net_pkt *pkt,
+			union net_ip_header *ip_hdr,
+			union net_proto_header *proto_hdr,
+			int status,
+			void *user_data)
+{
+	int flow = ntohs(proto_hdr->udp->src_port) - RSS_PORT - 1;
+
+	if (flow >= 0 && flow < RSS_FLOWS) {
+		if (rss_flow_thread[flow] == NULL) {
+			rss_flow_thread[flow] = k_current_get();
+		} else if (rss_flow_thread[flow] != k_current_get()) {
+			rss_flow_moved = true;
+		}
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&rss_recv);
+}
+
+static void rss_recv_flow(struct net_if *iface, int flow)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET6, IPPROTO_UDP,
+					K_SECONDS(1));
+	zassert_not_null(pkt, "Out of mem");
+
+	ret = net_ipv6_create(pkt, &dst_addr, &my_addr1);
+	zassert_equal(ret, 0, "Cannot create IPv6 header");
+	ret = net_udp_create(pkt, htons(RSS_PORT + 1 + flow), htons(RSS_PORT));
+	zassert_equal(ret, 0, "Cannot create UDP header");
+
+	net_pkt_cursor_init(pkt);
+	net_ipv6_finalize(pkt, IPPROTO_UDP);
+
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "Cannot receive packet (%d)", ret);
+
+	zassert_equal(k_sem_take(&rss_recv, WAIT_TIME), 0,
+		      "Flow %d not received", flow);
+}
+
+/* Flows that differ only by their source port must each stay on one RX
+ * queue, and together use all the queues of the class.
+ */
+ZTEST(net_traffic_class, test_rx_flow_queues)
+{
+	struct sockaddr_in6 addr6 = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(RSS_PORT),
+	};
+	k_tid_t queues[CONFIG_NET_TC_RX_RSS_QUEUES];
+	int n_queues = 0;
+	struct net_context *ctx;
+	struct net_if *iface;
+	int ret;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "Interface not found");
+
+	ret = net_context_get(AF_INET6, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Cannot get UDP context (%d)", ret);
+
+	net_ipv6_addr_copy_raw((uint8_t *)&addr6.sin6_addr,
+			       (uint8_t *)&my_addr1);
+	ret = net_context_bind(ctx, (struct sockaddr *)&addr6, sizeof(addr6));
+	zassert_equal(ret, 0, "Cannot bind UDP context (%d)", ret);
+
+	ret = net_context_recv(ctx, rss_recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot receive on UDP context (%d)", ret);
+
+	for (int round = 0; round < RSS_ROUNDS; round++) {
+		for (int flow = 0; flow < RSS_FLOWS; flow++) {
+			rss_recv_flow(iface, flow);
+		}
+	}
+
+	net_context_put(ctx);
+
+	zassert_false(rss_flow_moved, "A flow changed queue");
+
+	for (int flow = 0; flow < RSS_FLOWS; flow++) {
+		int i;
+
+		for (i = 0; i < n_queues; i++) {
+			if (queues[i] == rss_flow_thread[flow]) {
+				break;
+			}
+		}
+
+		if (i == n_queues) {
+			zassert_true(n_queues < ARRAY_SIZE(queues),
+				     "More threads than queues");
+			queues[n_queues++] = rss_flow_thread[flow];
+		}
+	}
+
+	zassert_equal(n_queues, CONFIG_NET_TC_RX_RSS_QUEUES,
+		      "%d flows used only %d of %d queues", RSS_FLOWS,
+		      n_queues, CONFIG_NET_TC_RX_RSS_QUEUES);
+}
+#endif /* CONFIG_NET_TC_RX_RSS */
+
 static void run_before(void *dummy)
 {
 	ARG_UNUSED(dummy);